@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <exception>
 #include <functional>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -9,12 +13,76 @@
 
 #include <simpleble/Exceptions.h>
 #include <simpleble/Peripheral.h>
+#include <simpleble/ScanFilter.h>
 #include <simpleble/Types.h>
 
 namespace SimpleBLE {
 
 class AdapterBase;
 
+/**
+ * @brief A peripheral reported by a batched scan callback.
+ *
+ * @details Repeated advertisements from the same peripheral within a batch interval are coalesced into a
+ *          single event, whose peripheral reflects the latest advertisement received.
+ */
+struct ScanEvent {
+    Peripheral peripheral;
+    // Set if the peripheral was seen for the first time during the current scan within this batch.
+    bool found = false;
+    // Reception time of the latest coalesced advertisement, in nanoseconds on std::chrono::steady_clock.
+    uint64_t timestamp = 0;
+    // Number of advertisements coalesced into this event.
+    uint32_t count = 0;
+};
+
+/**
+ * @brief Peripherals added, updated or lost since a given scan results version.
+ *
+ * @details When `reset` is set, the requested version could not be served incrementally (for example because
+ *          a new scan was started since) and `added` holds every peripheral seen during the current scan.
+ */
+struct ScanChanges {
+    uint64_t version = 0;
+    bool reset = false;
+    std::vector<Peripheral> added;
+    std::vector<Peripheral> updated;
+    std::vector<Peripheral> lost;
+};
+
+/**
+ * @brief Bounds on the devices an adapter keeps track of while it is not connected or paired to them.
+ *
+ * @details A zero value disables the corresponding limit, which is the default.
+ */
+struct DeviceCacheLimits {
+    // Maximum number of unconnected, unpaired devices kept. The least recently seen ones are evicted first.
+    size_t max_devices = 0;
+    // Unconnected, unpaired devices not heard from for this long are evicted.
+    int ttl_ms = 0;
+};
+
+struct DeviceCacheStats {
+    // Devices currently held by the adapter, including those only kept alive by outstanding handles.
+    size_t cached_devices = 0;
+    // Devices evicted since the adapter was created.
+    uint64_t evicted_devices = 0;
+};
+
+/**
+ * @brief Queueing statistics of the GATT operations of a single priority class on an adapter.
+ */
+struct OperationQueueStats {
+    OperationPriority priority = OperationPriority::INTERACTIVE;
+    // Operations currently waiting for their turn.
+    size_t queued = 0;
+    // Operations started since the adapter was created.
+    uint64_t started = 0;
+    // Time started operations spent queued.
+    uint64_t mean_wait_us = 0;
+    uint64_t max_wait_us = 0;
+};
+
 class SIMPLEBLE_EXPORT Adapter {
   public:
     Adapter() = default;
@@ -29,14 +97,107 @@ class SIMPLEBLE_EXPORT Adapter {
     void scan_start();
     void scan_stop();
     void scan_for(int timeout_ms);
+
+    /**
+     * @brief Scans for `timeout_ms` milliseconds without blocking the caller.
+     *
+     * @note `on_complete` runs on a library thread once the scan has stopped and must not block.
+     */
+    std::future<void> scan_for_async(int timeout_ms);
+    void scan_for_async(int timeout_ms, std::function<void(std::exception_ptr error)> on_complete);
+
+    /**
+     * @brief Scans until a peripheral accepted by the predicate is seen, stopping the scan right away.
+     *
+     * @details The predicate runs on the thread delivering advertisements, ahead of the scan callbacks.
+     *          If `connect` is set, the matching peripheral is connected to before returning. If connecting
+     *          fails, the peripheral is still returned, not connected. A scan that was already active is joined
+     *          and left running.
+     *
+     * @return The first matching peripheral, or std::nullopt if the timeout expired. A negative timeout
+     *         waits indefinitely.
+     */
+    std::optional<Peripheral> scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                                         bool connect = false);
+
+    /**
+     * @brief Same as scan_until(), without blocking the caller.
+     *
+     * @note `on_complete` runs on a library thread once the scan has stopped and must not block.
+     */
+    std::future<std::optional<Peripheral>> scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms);
+    void scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                          std::function<void(std::optional<Peripheral> peripheral)> on_complete);
     bool scan_is_active();
     std::vector<Peripheral> scan_get_results();
 
+    /**
+     * @brief Returns the changes to the scan results since `since_version`, without copying unchanged peripherals.
+     *
+     * @note Pass 0 to get the full list, then the returned version on each subsequent call. Each change is
+     *       reported once. On Windows and macOS every call is a reset, with all scan results in `added`.
+     */
+    ScanChanges scan_get_changes(uint64_t since_version);
+
+    /**
+     * @brief Restricts the devices reported by subsequent scans.
+     *
+     * @note The filter takes effect on the next call to scan_start(). An empty ScanFilter disables filtering.
+     */
+    void set_scan_filter(ScanFilter const& filter);
+
     void set_callback_on_scan_start(std::function<void()> on_scan_start);
     void set_callback_on_scan_stop(std::function<void()> on_scan_stop);
     void set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated);
     void set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found);
 
+    /**
+     * @brief Variants of the scan callbacks that also provide the time at which the advertisement
+     *        reached the process, in nanoseconds on std::chrono::steady_clock.
+     */
+    void set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t timestamp)> on_scan_updated);
+    void set_callback_on_scan_found(std::function<void(Peripheral, uint64_t timestamp)> on_scan_found);
+
+    // Clears the callback, as passing nullptr to the overloads above would be ambiguous.
+    void set_callback_on_scan_updated(std::nullptr_t);
+    void set_callback_on_scan_found(std::nullptr_t);
+
+    /**
+     * @brief Delivers scan results in batches, at most once every `interval_ms` milliseconds.
+     *
+     * @note Batches are delivered from an internal thread, and any pending batch is flushed when the scan
+     *       stops. The per-advertisement callbacks keep working alongside. Pass nullptr to disable batching.
+     */
+    void set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const& events)> on_scan_batch,
+                                    int interval_ms = 100);
+
+    /**
+     * @brief Bounds the memory used by long running scans by evicting stale devices.
+     *
+     * @details Evicted devices are removed from the operating system's device cache as well, and are
+     *          reported as lost by scan_get_changes(). Connected and paired devices are never evicted.
+     *
+     * @note Only supported on Linux. Other backends keep the limits but do not act on them.
+     */
+    void set_device_cache_limits(DeviceCacheLimits const& limits);
+    DeviceCacheStats device_cache_stats();
+
+    /**
+     * @brief Limits how many GATT operations may run at once across all peripherals of this adapter.
+     *
+     * @details Operations on a single peripheral always run one at a time. Queued operations start in priority
+     *          order, taking turns between peripherals within a priority class. Zero, the default, only keeps
+     *          the per-peripheral limit.
+     *
+     * @note Only supported on Linux. Other backends keep the setting but do not act on it.
+     */
+    void set_operation_concurrency(size_t max_concurrent);
+
+    /**
+     * @brief Returns the queueing statistics of each priority class, highest priority first.
+     */
+    std::vector<OperationQueueStats> operation_queue_stats();
+
     std::vector<Peripheral> get_paired_peripherals();
 
     static bool bluetooth_enabled();
@@ -46,6 +207,42 @@ class SIMPLEBLE_EXPORT Adapter {
      */
     static std::vector<Adapter> get_adapters();
 
+    /**
+     * @brief Leaves the processing of backend events to the application, instead of a thread of the library.
+     *
+     * @details Once enabled, event_fd() is to be watched for readability by the application's event loop, calling
+     *          process_events() whenever it is readable. Blocking calls that wait for events, such as connect(),
+     *          must then not be made from the thread running the loop; the `*_async` variants can be used instead.
+     *
+     * @note Must be called before any other use of the library. Only supported on Linux.
+     *
+     * @return False if the mode is not supported, or if the backend was already started with its own thread.
+     */
+    static bool use_external_event_loop();
+
+    /**
+     * @brief Returns the descriptor to watch when using an external event loop, or -1 otherwise.
+     */
+    static int event_fd();
+
+    /**
+     * @brief Processes every pending backend event without blocking, when using an external event loop.
+     */
+    static void process_events();
+
+    /**
+     * @brief Spreads adapters over `count` connections of their own to the system, each served by its own thread,
+     *        so that heavy traffic on one adapter does not hold up the others.
+     *
+     * @details Every adapter and its peripherals use a single one of the connections, adapters being assigned to
+     *          the least used one as they appear. With an external event loop, event_fd() covers all of them.
+     *
+     * @note Must be called before any other use of the library. Only supported on Linux.
+     *
+     * @return False if not supported, or if the backend was already started.
+     */
+    static bool use_dedicated_connections(size_t count);
+
   protected:
     std::shared_ptr<AdapterBase> internal_;
 };
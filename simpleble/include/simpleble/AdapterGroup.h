@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <simpleble/export.h>
+
+#include <simpleble/Adapter.h>
+#include <simpleble/Exceptions.h>
+#include <simpleble/Peripheral.h>
+#include <simpleble/Types.h>
+
+namespace SimpleBLE {
+
+class AdapterGroupBase;
+
+/**
+ * @brief Uses several adapters as one, to go beyond the connection limit of a single controller.
+ *
+ * @details Scans run on every adapter of the group and their results are merged by address. New connections
+ *          are made through the least loaded adapter that has seen the peripheral, falling back to the others
+ *          if that fails. Adapters that disappear from the system are taken out of rotation, and refresh()
+ *          re-establishes the connections they held through the remaining adapters.
+ *
+ * @note Scan callbacks set directly on the adapters of a group are replaced by the group's own.
+ */
+class SIMPLEBLE_EXPORT AdapterGroup {
+  public:
+    struct AdapterLoad {
+        std::string identifier;
+        BluetoothAddress address;
+        // Cleared once the adapter is no longer present in the system.
+        bool available = true;
+        // Connections made through the group that are still established.
+        size_t connections = 0;
+        // Peripherals seen by the adapter during the current scan.
+        size_t scan_results = 0;
+        uint64_t connect_failures = 0;
+    };
+
+    AdapterGroup() = default;
+    explicit AdapterGroup(std::vector<Adapter> adapters);
+    virtual ~AdapterGroup() = default;
+
+    /**
+     * @brief Groups every adapter in the system. Adapters plugged in later are added by refresh().
+     */
+    static AdapterGroup all();
+
+    bool initialized() const;
+
+    /**
+     * @brief Returns the adapters of the group that are still available.
+     */
+    std::vector<Adapter> adapters();
+
+    void scan_start();
+    void scan_stop();
+    void scan_for(int timeout_ms);
+    bool scan_is_active();
+
+    /**
+     * @brief Returns the peripherals seen by any adapter, once per address, as seen by the adapter receiving
+     *        them with the strongest signal.
+     */
+    std::vector<Peripheral> scan_get_results();
+
+    /**
+     * @brief Called the first time a peripheral is seen by any adapter of the group during a scan.
+     */
+    void set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found);
+
+    /**
+     * @brief Connects to a peripheral through the least loaded adapter that has seen it.
+     *
+     * @note Throws Exception::OperationFailed if no adapter could connect to it.
+     */
+    Peripheral connect(BluetoothAddress const& address);
+
+    /**
+     * @brief Picks up adapters that were unplugged or plugged in, and reconnects the peripherals held by
+     *        adapters that went away through the remaining ones.
+     *
+     * @return The peripherals that were reconnected.
+     */
+    std::vector<Peripheral> refresh();
+
+    std::vector<AdapterLoad> load();
+
+  protected:
+    std::shared_ptr<AdapterGroupBase> internal_;
+};
+
+}  // namespace SimpleBLE
@@ -9,6 +9,21 @@ namespace SimpleBLE {
 
 namespace Safe {
 
+struct ScanEvent {
+    SimpleBLE::Safe::Peripheral peripheral;
+    bool found = false;
+    uint64_t timestamp = 0;
+    uint32_t count = 0;
+};
+
+struct ScanChanges {
+    uint64_t version = 0;
+    bool reset = false;
+    std::vector<SimpleBLE::Safe::Peripheral> added;
+    std::vector<SimpleBLE::Safe::Peripheral> updated;
+    std::vector<SimpleBLE::Safe::Peripheral> lost;
+};
+
 class SIMPLEBLE_EXPORT Adapter : public SimpleBLE::Adapter {
   public:
     Adapter(SimpleBLE::Adapter& adapter);
@@ -20,18 +35,48 @@ class SIMPLEBLE_EXPORT Adapter : public SimpleBLE::Adapter {
     bool scan_start() noexcept;
     bool scan_stop() noexcept;
     bool scan_for(int timeout_ms) noexcept;
+    bool scan_for_async(int timeout_ms, std::function<void(bool success)> on_complete) noexcept;
+    // If `connect` is set and connecting fails, the matching peripheral is still returned, not connected.
+    std::optional<SimpleBLE::Safe::Peripheral> scan_until(std::function<bool(SimpleBLE::Safe::Peripheral)> predicate,
+                                                          int timeout_ms, bool connect = false) noexcept;
+    bool scan_until_async(std::function<bool(SimpleBLE::Safe::Peripheral)> predicate, int timeout_ms,
+                          std::function<void(std::optional<SimpleBLE::Safe::Peripheral>)> on_complete) noexcept;
     std::optional<bool> scan_is_active() noexcept;
     std::optional<std::vector<SimpleBLE::Safe::Peripheral>> scan_get_results() noexcept;
+    std::optional<SimpleBLE::Safe::ScanChanges> scan_get_changes(uint64_t since_version) noexcept;
+
+    bool set_scan_filter(ScanFilter const& filter) noexcept;
+
+    bool set_device_cache_limits(DeviceCacheLimits const& limits) noexcept;
+    std::optional<DeviceCacheStats> device_cache_stats() noexcept;
+
+    bool set_operation_concurrency(size_t max_concurrent) noexcept;
+    std::optional<std::vector<OperationQueueStats>> operation_queue_stats() noexcept;
 
     bool set_callback_on_scan_start(std::function<void()> on_scan_start) noexcept;
     bool set_callback_on_scan_stop(std::function<void()> on_scan_stop) noexcept;
     bool set_callback_on_scan_updated(std::function<void(SimpleBLE::Safe::Peripheral)> on_scan_updated) noexcept;
     bool set_callback_on_scan_found(std::function<void(SimpleBLE::Safe::Peripheral)> on_scan_found) noexcept;
+    bool set_callback_on_scan_updated(
+        std::function<void(SimpleBLE::Safe::Peripheral, uint64_t timestamp)> on_scan_updated) noexcept;
+    bool set_callback_on_scan_found(
+        std::function<void(SimpleBLE::Safe::Peripheral, uint64_t timestamp)> on_scan_found) noexcept;
+    bool set_callback_on_scan_updated(std::nullptr_t) noexcept;
+    bool set_callback_on_scan_found(std::nullptr_t) noexcept;
+
+    bool set_callback_on_scan_batch(
+        std::function<void(std::vector<SimpleBLE::Safe::ScanEvent> const& events)> on_scan_batch,
+        int interval_ms = 100) noexcept;
 
     std::optional<std::vector<SimpleBLE::Safe::Peripheral>> get_paired_peripherals() noexcept;
 
     static std::optional<bool> bluetooth_enabled() noexcept;
     static std::optional<std::vector<SimpleBLE::Safe::Adapter>> get_adapters() noexcept;
+
+    static bool use_external_event_loop() noexcept;
+    static std::optional<int> event_fd() noexcept;
+    static bool process_events() noexcept;
+    static bool use_dedicated_connections(size_t count) noexcept;
 };
 
 }  // namespace Safe
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <simpleble/export.h>
+
+#include <simpleble/Adapter.h>
+#include <simpleble/Exceptions.h>
+#include <simpleble/Peripheral.h>
+#include <simpleble/Types.h>
+
+namespace SimpleBLE {
+
+class ConnectionManagerBase;
+
+/**
+ * @brief Keeps a set of peripherals of an adapter connected.
+ *
+ * @details Targets are identified by address and are discovered through the adapter's scan results and paired
+ *          peripherals, scanning in the background while some are still unknown. Up to `max_concurrent`
+ *          connections are established at once. Failed attempts are retried with exponential backoff, dropped
+ *          connections are re-established, and subscriptions registered through notify() are restored after
+ *          every connection.
+ *
+ * @note Callbacks set directly on the managed peripherals are replaced by the manager. Use the manager's own
+ *       callbacks instead.
+ */
+class SIMPLEBLE_EXPORT ConnectionManager {
+  public:
+    struct Options {
+        // Maximum number of connection attempts in progress at once.
+        size_t max_concurrent = 4;
+        // Re-establish connections that drop.
+        bool auto_reconnect = true;
+        // Delay before retrying a failed attempt, doubled after every consecutive failure.
+        int initial_backoff_ms = 500;
+        int max_backoff_ms = 30000;
+    };
+
+    struct Stats {
+        size_t targets = 0;
+        size_t connected = 0;
+        uint64_t attempts = 0;
+        uint64_t failures = 0;
+        // Successful connections following a previous connection to the same target.
+        uint64_t reconnects = 0;
+        uint64_t disconnects = 0;
+        // Duration of successful connection attempts.
+        uint64_t mean_connect_ms = 0;
+        uint64_t max_connect_ms = 0;
+    };
+
+    ConnectionManager() = default;
+    explicit ConnectionManager(Adapter adapter);
+    ConnectionManager(Adapter adapter, Options const& options);
+    virtual ~ConnectionManager() = default;
+
+    bool initialized() const;
+
+    void add(BluetoothAddress const& address);
+    void remove(BluetoothAddress const& address);
+    std::vector<BluetoothAddress> targets();
+
+    /**
+     * @brief Starts connecting the targets, from a pool of internal threads.
+     */
+    void start();
+
+    /**
+     * @brief Stops connecting the targets. Established connections are kept.
+     */
+    void stop();
+
+    bool is_connected(BluetoothAddress const& address);
+    std::optional<Peripheral> peripheral(BluetoothAddress const& address);
+
+    /**
+     * @brief Subscribes to a characteristic of a target whenever it is connected.
+     */
+    void notify(BluetoothAddress const& address, BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                std::function<void(ByteArray payload, uint64_t timestamp)> callback);
+
+    /**
+     * @note Called from the manager's threads for connections, and from the backend thread for disconnections.
+     */
+    void set_callback_on_connected(std::function<void(Peripheral)> on_connected);
+    void set_callback_on_disconnected(std::function<void(Peripheral)> on_disconnected);
+
+    Stats stats();
+
+  protected:
+    std::shared_ptr<ConnectionManagerBase> internal_;
+};
+
+}  // namespace SimpleBLE
@@ -0,0 +1,410 @@
+#pragma once
+
+// The coroutine layer is header-only, so that it is available to applications built as C++20 while the library
+// itself keeps building as C++17.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#define SIMPLEBLE_COROUTINES 1
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <simpleble/Adapter.h>
+#include <simpleble/Peripheral.h>
+
+namespace SimpleBLE {
+
+namespace Coro {
+
+template <typename T = void>
+class Task;
+
+/**
+ * @brief Runs coroutines on the thread calling run(), resuming each one once the operation it awaits completes.
+ *
+ * @details Operations are started from the executor thread and complete on backend threads, which only queue the
+ *          waiting coroutine for resumption. Any number of flows can therefore be in flight on a single thread.
+ *
+ * @note run() must have returned before the executor is destroyed, as operations in flight refer to it.
+ */
+class Executor {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    Executor() = default;
+    ~Executor() = default;
+
+    Executor(Executor const&) = delete;
+    Executor& operator=(Executor const&) = delete;
+
+    /**
+     * @brief Hands a task over to the executor, which starts it on the next call to run().
+     */
+    void spawn(Task<void> task);
+
+    /**
+     * @brief Resumes coroutines until every spawned task has completed.
+     *
+     * @details If a spawned task ends with an exception, the first such exception is rethrown once all tasks
+     *          have completed.
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            auto now = Clock::now();
+            while (!timers_.empty() && timers_.begin()->first <= now) {
+                ready_.push_back(timers_.begin()->second);
+                timers_.erase(timers_.begin());
+            }
+
+            if (!ready_.empty()) {
+                std::coroutine_handle<> handle = ready_.front();
+                ready_.pop_front();
+
+                lock.unlock();
+                handle.resume();
+                lock.lock();
+                continue;
+            }
+
+            if (active_ == 0) break;
+
+            if (timers_.empty()) {
+                cv_.wait(lock);
+            } else {
+                cv_.wait_until(lock, timers_.begin()->first);
+            }
+        }
+
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+    /**
+     * @brief Queues a coroutine for resumption. Can be called from any thread.
+     */
+    void post(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(handle);
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief Queues a coroutine for resumption once `due` has passed.
+     */
+    void post_at(Clock::time_point due, std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timers_.emplace(due, handle);
+        cv_.notify_one();
+    }
+
+    /**
+     * @brief Records the completion of a spawned task.
+     */
+    void finished(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_--;
+        if (error && !error_) {
+            error_ = error;
+        }
+        cv_.notify_one();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::multimap<Clock::time_point, std::coroutine_handle<>> timers_;
+    size_t active_ = 0;
+    std::exception_ptr error_;
+};
+
+namespace Detail {
+
+struct PromiseBase {
+    Executor* executor = nullptr;
+    // Coroutine awaiting this one, resumed once it completes. Unset for spawned tasks.
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+    bool detached = false;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            PromiseBase& promise = handle.promise();
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+
+            if (promise.detached) {
+                Executor* executor = promise.executor;
+                std::exception_ptr error = promise.exception;
+                handle.destroy();
+                executor->finished(error);
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    void return_value(T result) { value = std::move(result); }
+
+    T result() {
+        if (exception) std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+
+    void result() {
+        if (exception) std::rethrow_exception(exception);
+    }
+};
+
+template <typename Promise>
+Executor* executor_of(std::coroutine_handle<Promise> handle) {
+    static_assert(std::is_base_of_v<PromiseBase, Promise>, "SimpleBLE operations can only be awaited from a Task");
+    return handle.promise().executor;
+}
+
+/**
+ * @brief Awaitable started through one of the callback based `*_async` methods.
+ */
+template <typename T>
+class Operation {
+  public:
+    using Start = std::function<void(std::function<void(T value, std::exception_ptr error)>)>;
+
+    explicit Operation(Start start) : start_(std::move(start)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) {
+        Executor* executor = executor_of(handle);
+        start_([this, executor, handle](T value, std::exception_ptr error) {
+            value_ = std::move(value);
+            error_ = error;
+            executor->post(handle);
+        });
+    }
+
+    T await_resume() {
+        if (error_) std::rethrow_exception(error_);
+        return std::move(*value_);
+    }
+
+  private:
+    Start start_;
+    std::optional<T> value_;
+    std::exception_ptr error_;
+};
+
+template <>
+class Operation<void> {
+  public:
+    using Start = std::function<void(std::function<void(std::exception_ptr error)>)>;
+
+    explicit Operation(Start start) : start_(std::move(start)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) {
+        Executor* executor = executor_of(handle);
+        start_([this, executor, handle](std::exception_ptr error) {
+            error_ = error;
+            executor->post(handle);
+        });
+    }
+
+    void await_resume() {
+        if (error_) std::rethrow_exception(error_);
+    }
+
+  private:
+    Start start_;
+    std::exception_ptr error_;
+};
+
+class Sleep {
+  public:
+    explicit Sleep(Executor::Clock::duration duration) : duration_(duration) {}
+
+    bool await_ready() const noexcept { return duration_.count() <= 0; }
+
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) {
+        executor_of(handle)->post_at(Executor::Clock::now() + duration_, handle);
+    }
+
+    void await_resume() noexcept {}
+
+  private:
+    Executor::Clock::duration duration_;
+};
+
+}  // namespace Detail
+
+/**
+ * @brief Lazily started coroutine producing a `T`. It runs once awaited or spawned on an Executor.
+ */
+template <typename T>
+class Task {
+  public:
+    using promise_type = Detail::Promise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(Task const&) = delete;
+    Task& operator=(Task const&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        handle_.promise().executor = Detail::executor_of(awaiting);
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().result(); }
+
+  private:
+    friend class Executor;
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T>
+Task<T> Detail::Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Detail::Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+inline void Executor::spawn(Task<void> task) {
+    std::coroutine_handle<Detail::Promise<void>> handle = std::exchange(task.handle_, {});
+    handle.promise().executor = this;
+    handle.promise().detached = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_++;
+    ready_.push_back(handle);
+    cv_.notify_one();
+}
+
+/**
+ * @brief Suspends the calling coroutine without blocking the executor.
+ */
+template <typename Rep, typename Period>
+Detail::Sleep sleep_for(std::chrono::duration<Rep, Period> duration) {
+    return Detail::Sleep(std::chrono::duration_cast<Executor::Clock::duration>(duration));
+}
+
+// Awaitable counterparts of the `*_async` operations. The objects passed in are copied, so the awaitables do not
+// depend on the caller's variables.
+
+inline Detail::Operation<void> connect(Peripheral peripheral) {
+    return Detail::Operation<void>([peripheral](auto on_complete) mutable { peripheral.connect_async(on_complete); });
+}
+
+inline Detail::Operation<ByteArray> read(Peripheral peripheral, BluetoothUUID service, BluetoothUUID characteristic) {
+    return Detail::Operation<ByteArray>([=](auto on_complete) mutable {
+        peripheral.read_async(service, characteristic, on_complete);
+    });
+}
+
+inline Detail::Operation<void> write_request(Peripheral peripheral, BluetoothUUID service,
+                                             BluetoothUUID characteristic, ByteArray data) {
+    return Detail::Operation<void>([=](auto on_complete) mutable {
+        peripheral.write_request_async(service, characteristic, data, on_complete);
+    });
+}
+
+inline Detail::Operation<void> write_command(Peripheral peripheral, BluetoothUUID service,
+                                             BluetoothUUID characteristic, ByteArray data) {
+    return Detail::Operation<void>([=](auto on_complete) mutable {
+        peripheral.write_command_async(service, characteristic, data, on_complete);
+    });
+}
+
+inline Detail::Operation<void> notify(Peripheral peripheral, BluetoothUUID service, BluetoothUUID characteristic,
+                                      std::function<void(ByteArray payload)> callback) {
+    return Detail::Operation<void>([=](auto on_complete) mutable {
+        peripheral.notify_async(service, characteristic, callback, on_complete);
+    });
+}
+
+inline Detail::Operation<void> unsubscribe(Peripheral peripheral, BluetoothUUID service,
+                                           BluetoothUUID characteristic) {
+    return Detail::Operation<void>([=](auto on_complete) mutable {
+        peripheral.unsubscribe_async(service, characteristic, on_complete);
+    });
+}
+
+inline Detail::Operation<void> scan_for(Adapter adapter, int timeout_ms) {
+    return Detail::Operation<void>([=](auto on_complete) mutable { adapter.scan_for_async(timeout_ms, on_complete); });
+}
+
+/**
+ * @brief Scans until a peripheral accepted by the predicate is seen, resuming with std::nullopt on timeout.
+ *
+ * @note The predicate runs on the thread delivering advertisements, not on the executor.
+ */
+inline Detail::Operation<std::optional<Peripheral>> scan_until(Adapter adapter,
+                                                                std::function<bool(Peripheral)> predicate,
+                                                                int timeout_ms) {
+    return Detail::Operation<std::optional<Peripheral>>([=](auto on_complete) mutable {
+        adapter.scan_until_async(predicate, timeout_ms, [on_complete](std::optional<Peripheral> peripheral) {
+            on_complete(std::move(peripheral), nullptr);
+        });
+    });
+}
+
+}  // namespace Coro
+
+}  // namespace SimpleBLE
+
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <simpleble/export.h>
+
+#include <simpleble/Exceptions.h>
+#include <simpleble/Types.h>
+
+namespace SimpleBLE {
+
+class NotificationStreamBase;
+
+/**
+ * @brief Pull-based consumer for notifications and indications.
+ *
+ * @details Payloads are queued in a bounded buffer as they arrive and can be
+ *          consumed at the pace of the application using next() or drain().
+ *          Copies of a stream share the same underlying queue. Once every copy
+ *          has been destroyed, the stream is closed and incoming payloads are
+ *          discarded.
+ */
+class SIMPLEBLE_EXPORT NotificationStream {
+  public:
+    enum class OverflowPolicy {
+        DROP_OLDEST,  // Discard the oldest queued payload to make room.
+        DROP_NEWEST,  // Discard the incoming payload.
+        // Block the delivering thread until there is room. Threads dispatching the events of a whole
+        // connection, such as the BlueZ event thread, are never blocked and drop the oldest payload instead.
+        // Blocked threads are released once every copy of the stream is gone.
+        BLOCK,
+    };
+
+    struct Options {
+        size_t capacity = 256;
+        OverflowPolicy overflow_policy = OverflowPolicy::DROP_OLDEST;
+    };
+
+    NotificationStream() = default;
+    virtual ~NotificationStream() = default;
+
+    bool initialized() const;
+
+    /**
+     * @brief Waits for the next payload.
+     *
+     * @param timeout_ms Maximum time to wait. A negative value waits indefinitely.
+     * @return The next payload, or std::nullopt on timeout or if the stream is closed and empty.
+     */
+    std::optional<ByteArray> next(int timeout_ms = -1);
+
+    /**
+     * @brief Retrieves up to `max` queued payloads without waiting.
+     */
+    std::vector<ByteArray> drain(size_t max = SIZE_MAX);
+
+    /**
+     * @brief Closes the stream, waking up any pending call to next().
+     *
+     * @note Payloads already queued can still be consumed after closing.
+     */
+    void close();
+    bool is_closed();
+
+    size_t size();
+    size_t capacity();
+
+    uint64_t received();
+    uint64_t dropped();
+    size_t high_water_mark();
+
+  protected:
+    std::shared_ptr<NotificationStreamBase> internal_;
+};
+
+}  // namespace SimpleBLE
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
@@ -10,6 +13,7 @@
 #include <simpleble/export.h>
 
 #include <simpleble/Exceptions.h>
+#include <simpleble/NotificationStream.h>
 #include <simpleble/Service.h>
 #include <simpleble/Types.h>
 
@@ -57,16 +61,92 @@ class SIMPLEBLE_EXPORT Peripheral {
 
     // clang-format off
     ByteArray read(BluetoothUUID const& service, BluetoothUUID const& characteristic);
+
+    /**
+     * @brief Returns the last known value of a characteristic if it was read or notified within the last
+     *        `max_age_ms` milliseconds, and reads it otherwise.
+     *
+     * @note Concurrent reads of the same characteristic may be served by a single request. Backends that do not
+     *       keep track of characteristic values always read.
+     */
+    ByteArray read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic, int max_age_ms);
     void write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data);
     void write_command(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data);
     void notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback);
     void indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback);
     void unsubscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic);
 
+    /**
+     * @brief Variants of notify() and indicate() whose callback also receives the time at which the
+     *        payload reached the process, in nanoseconds on std::chrono::steady_clock.
+     */
+    void notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback);
+    void indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback);
+
+    // Subscribe without a callback, as passing nullptr to the overloads above would be ambiguous.
+    void notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::nullptr_t);
+    void indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::nullptr_t);
+
+    /**
+     * @brief Subscribes to a characteristic and delivers its payloads through a pull-based stream.
+     *
+     * @note The subscription remains active until unsubscribe() is called, even if the stream is discarded.
+     */
+    NotificationStream notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, NotificationStream::Options const& options = {});
+    NotificationStream indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, NotificationStream::Options const& options = {});
+
     ByteArray read(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor);
     void write(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor, ByteArray const& data);
     // clang-format on
 
+    /**
+     * @brief Runs a batch of operations, returning one result per request, in order.
+     *
+     * @details A failing item does not stop the others. On Linux, all requests of a batch are sent before
+     *          waiting for the first reply. Other backends run them one after the other.
+     */
+    std::vector<OperationResult> read_many(std::vector<ReadRequest> const& requests);
+    std::vector<OperationResult> write_many(std::vector<WriteRequest> const& requests);
+
+    /**
+     * @brief Starts an operation without waiting for it, returning a future that holds its outcome.
+     *
+     * @details On Linux, operations are driven by the backend's event loop, so a single thread can keep many of
+     *          them in flight across peripherals. Other backends run each operation on a helper thread.
+     */
+    std::future<void> connect_async();
+    std::future<ByteArray> read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic);
+    std::future<void> write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                          ByteArray const& data);
+    std::future<void> write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                          ByteArray const& data);
+    std::future<void> notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                   std::function<void(ByteArray payload)> callback);
+    std::future<void> unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic);
+
+    /**
+     * @brief Starts an operation without waiting for it, calling `on_complete` with its outcome. The error is null
+     *        if the operation succeeded.
+     *
+     * @note `on_complete` runs on a backend thread and must not block. It may run before the call returns.
+     */
+    // clang-format off
+    void connect_async(std::function<void(std::exception_ptr error)> on_complete);
+    void read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray value, std::exception_ptr error)> on_complete);
+    void write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete);
+    void write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete);
+    void notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback, std::function<void(std::exception_ptr error)> on_complete);
+    void unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(std::exception_ptr error)> on_complete);
+    // clang-format on
+
+    /**
+     * @brief Sets the scheduling class of the operations on a characteristic and its descriptors.
+     *
+     * @note Operations are OperationPriority::INTERACTIVE unless set otherwise. Only supported on Linux.
+     */
+    void set_operation_priority(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                OperationPriority priority);
+
     void set_callback_on_connected(std::function<void()> on_connected);
     void set_callback_on_disconnected(std::function<void()> on_disconnected);
 
@@ -35,16 +35,43 @@ class SIMPLEBLE_EXPORT Peripheral : public SimpleBLE::Peripheral {
 
     // clang-format off
     std::optional<ByteArray> read(BluetoothUUID const& service, BluetoothUUID const& characteristic) noexcept;
+    std::optional<ByteArray> read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic, int max_age_ms) noexcept;
     bool write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data) noexcept;
     bool write_command(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data) noexcept;
     bool notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback) noexcept;
     bool indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback) noexcept;
     bool unsubscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic) noexcept;
+    bool notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback) noexcept;
+    bool indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback) noexcept;
+    bool notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::nullptr_t) noexcept;
+    bool indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::nullptr_t) noexcept;
+
+    std::optional<NotificationStream> notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, NotificationStream::Options const& options = {}) noexcept;
+    std::optional<NotificationStream> indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, NotificationStream::Options const& options = {}) noexcept;
 
     std::optional<ByteArray> read(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor) noexcept;
     bool write(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor, ByteArray const& data) noexcept;
     // clang-format on
 
+    std::optional<std::vector<OperationResult>> read_many(std::vector<ReadRequest> const& requests) noexcept;
+    std::optional<std::vector<OperationResult>> write_many(std::vector<WriteRequest> const& requests) noexcept;
+
+    /**
+     * @brief Starts an operation without waiting for it. Returns false if it could not be started, in which case
+     *        `on_complete` is never called.
+     */
+    // clang-format off
+    bool connect_async(std::function<void(bool success)> on_complete) noexcept;
+    bool read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(std::optional<ByteArray> value)> on_complete) noexcept;
+    bool write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(bool success)> on_complete) noexcept;
+    bool write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(bool success)> on_complete) noexcept;
+    bool notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback, std::function<void(bool success)> on_complete) noexcept;
+    bool unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(bool success)> on_complete) noexcept;
+    // clang-format on
+
+    bool set_operation_priority(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                OperationPriority priority) noexcept;
+
     bool set_callback_on_connected(std::function<void()> on_connected) noexcept;
     bool set_callback_on_disconnected(std::function<void()> on_disconnected) noexcept;
 };
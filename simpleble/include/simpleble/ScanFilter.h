@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <simpleble/Types.h>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Criteria restricting which devices are reported while scanning.
+ *
+ * @details On Linux, the criteria supported by BlueZ are pushed down so that non-matching
+ *          devices are discarded before they reach the process. All backends then evaluate
+ *          the remaining criteria locally, against the advertisement data they already hold,
+ *          before any Peripheral object is created or any callback is invoked.
+ */
+struct ScanFilter {
+    enum class Transport { AUTO, BREDR, LE };
+
+    // Only report devices advertising at least one of these services. 16 and 32-bit UUIDs are accepted.
+    std::vector<BluetoothUUID> service_uuids = {};
+
+    // Only report devices whose RSSI is at or above this value, in dBm.
+    std::optional<int16_t> rssi_threshold;
+
+    // Only report devices whose pathloss is at or below this value, in dB. Linux only, and BlueZ does not
+    // accept it together with `rssi_threshold`.
+    std::optional<uint16_t> pathloss_threshold;
+
+    // Transport used for discovery. Linux only.
+    Transport transport = Transport::AUTO;
+
+    // Report every advertisement, even if its contents did not change. Linux only.
+    bool duplicate_data = true;
+
+    // Only report devices whose address or name starts with this string.
+    std::string pattern = "";
+
+    // Only report devices whose name is exactly this string.
+    std::string name = "";
+
+    // Only report devices whose name starts with this string.
+    std::string name_prefix = "";
+
+    // Only report devices advertising manufacturer data for this company identifier.
+    std::optional<uint16_t> manufacturer_id;
+
+    // Expected leading bytes of the manufacturer data for `manufacturer_id`. Only the bits set in
+    // `manufacturer_data_mask` are compared. If the mask is shorter than the data, it is padded with 0xFF.
+    ByteArray manufacturer_data = "";
+    ByteArray manufacturer_data_mask = "";
+
+    // Only report updates for an already found device if its name, service UUIDs, manufacturer data or
+    // service data changed, or if its RSSI moved by at least this many dB since the last reported update.
+    // Use a large value to ignore RSSI changes altogether. Linux only.
+    std::optional<uint16_t> rssi_change_threshold;
+};
+
+}  // namespace SimpleBLE
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <simpleble/Adapter.h>
+#include <simpleble/AdapterGroup.h>
 #include <simpleble/AdapterSafe.h>
+#include <simpleble/ConnectionManager.h>
 #include <simpleble/Peripheral.h>
 #include <simpleble/PeripheralSafe.h>
 #include <simpleble/Utils.h>
@@ -24,4 +24,41 @@ enum class OperatingSystem {
 
 enum BluetoothAddressType : int32_t { PUBLIC = 0, RANDOM = 1, UNSPECIFIED = 2 };
 
+/**
+ * @brief Scheduling class of a GATT operation. Queued operations of a higher class always run first.
+ */
+enum class OperationPriority {
+    CONTROL = 0,
+    INTERACTIVE = 1,
+    BULK = 2,
+};
+
+/**
+ * @brief Item of a batch passed to Peripheral::read_many().
+ */
+struct ReadRequest {
+    BluetoothUUID service;
+    BluetoothUUID characteristic;
+};
+
+/**
+ * @brief Item of a batch passed to Peripheral::write_many().
+ */
+struct WriteRequest {
+    BluetoothUUID service;
+    BluetoothUUID characteristic;
+    ByteArray data;
+    // Use a write request if true, a write command otherwise.
+    bool with_response = true;
+};
+
+/**
+ * @brief Outcome of one item of a batch. `value` holds the data read, and `error` the reason of a failure.
+ */
+struct OperationResult {
+    bool success = false;
+    ByteArray value;
+    std::string error;
+};
+
 }  // namespace SimpleBLE
@@ -19,6 +19,40 @@ extern "C" {
  */
 SIMPLEBLE_EXPORT bool simpleble_adapter_is_bluetooth_enabled(void);
 
+/**
+ * @brief Leaves the processing of backend events to the application's event loop, instead of a library thread.
+ *
+ * @note Must be called before any other function of the library. Only supported on Linux.
+ *
+ * @return bool False if the mode is not supported, or if the backend was already started.
+ */
+SIMPLEBLE_EXPORT bool simpleble_adapter_use_external_event_loop(void);
+
+/**
+ * @brief Returns the descriptor to watch for readability when using an external event loop, or -1 otherwise.
+ *
+ * @return int
+ */
+SIMPLEBLE_EXPORT int simpleble_adapter_event_fd(void);
+
+/**
+ * @brief Processes every pending backend event without blocking. To be called whenever the descriptor returned
+ *        by simpleble_adapter_event_fd() is readable.
+ *
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_process_events(void);
+
+/**
+ * @brief Spreads adapters over `count` connections of their own, each served by its own thread, so that heavy
+ *        traffic on one adapter does not hold up the others.
+ *
+ * @note Must be called before any other function of the library. Only supported on Linux.
+ *
+ * @return bool False if not supported, or if the backend was already started.
+ */
+SIMPLEBLE_EXPORT bool simpleble_adapter_use_dedicated_connections(size_t count);
+
 /**
  * @brief
  *
@@ -99,6 +133,66 @@ SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_scan_is_active(simpleble_adap
  */
 SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_scan_for(simpleble_adapter_t handle, int timeout_ms);
 
+/**
+ * @brief Scans for `timeout_ms` milliseconds without blocking, calling `callback` once the scan has stopped.
+ *
+ * @note The callback runs on a library thread and must not block. The handle must not be released before the
+ *       callback has run.
+ *
+ * @param handle
+ * @param timeout_ms
+ * @param callback
+ * @param userdata
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_scan_for_async(simpleble_adapter_t handle, int timeout_ms,
+                                                                  void (*callback)(simpleble_adapter_t adapter,
+                                                                                   simpleble_err_t result,
+                                                                                   void* userdata),
+                                                                  void* userdata);
+
+/**
+ * @brief Scans until a peripheral accepted by the predicate is seen, stopping the scan right away. A scan
+ *        started beforehand is left running.
+ *
+ * @note The predicate is invoked from the thread delivering advertisements. The peripheral handle passed
+ *       to it is only valid for the duration of the call. On success, the user is responsible for freeing
+ *       the returned peripheral object by calling `simpleble_peripheral_release_handle`.
+ *
+ * @param handle
+ * @param predicate Returns true to accept the peripheral.
+ * @param userdata
+ * @param timeout_ms Negative values wait indefinitely.
+ * @param connect Whether to connect to the matching peripheral before returning.
+ * @param peripheral Receives the matching peripheral, or NULL if the timeout expired. If connecting fails,
+ *                   SIMPLEBLE_FAILURE is returned but the peripheral is still set and must be released.
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_scan_until(
+    simpleble_adapter_t handle, bool (*predicate)(simpleble_adapter_t adapter, simpleble_peripheral_t peripheral,
+                                                  void* userdata),
+    void* userdata, int timeout_ms, bool connect, simpleble_peripheral_t* peripheral);
+
+/**
+ * @brief Same as simpleble_adapter_scan_until(), without blocking the caller.
+ *
+ * @note `callback` runs on a library thread once the scan has stopped, with the matching peripheral or NULL if
+ *       the timeout expired. The user is responsible for freeing a non-NULL peripheral by calling
+ *       `simpleble_peripheral_release_handle`. The adapter handle must not be released before the callback has run.
+ *
+ * @param handle
+ * @param predicate Returns true to accept the peripheral.
+ * @param timeout_ms Negative values wait indefinitely.
+ * @param callback
+ * @param userdata Passed to both the predicate and the callback.
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_scan_until_async(
+    simpleble_adapter_t handle, bool (*predicate)(simpleble_adapter_t adapter, simpleble_peripheral_t peripheral,
+                                                  void* userdata),
+    int timeout_ms, void (*callback)(simpleble_adapter_t adapter, simpleble_peripheral_t peripheral, void* userdata),
+    void* userdata);
+
 /**
  * @brief
  *
@@ -120,6 +214,97 @@ SIMPLEBLE_EXPORT size_t simpleble_adapter_scan_get_results_count(simpleble_adapt
 SIMPLEBLE_EXPORT simpleble_peripheral_t simpleble_adapter_scan_get_results_handle(simpleble_adapter_t handle,
                                                                                   size_t index);
 
+/**
+ * @brief Returns the changes to the scan results since `since_version`.
+ *
+ * @note Pass 0 to get the full list, then the version returned in `version` on each subsequent call.
+ *       When `reset` is set, the previous results must be discarded and the returned changes are all
+ *       additions. On Windows and macOS every call is a reset. The user is responsible for releasing every
+ *       peripheral handle in the returned array by calling `simpleble_peripheral_release_handle`, and the
+ *       array itself by calling `simpleble_free`.
+ *
+ * @param handle
+ * @param since_version
+ * @param version Receives the version to pass on the next call.
+ * @param reset
+ * @param changes Receives a packed array of changes, or NULL if there are none.
+ * @param changes_count
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_scan_get_changes(simpleble_adapter_t handle, uint64_t since_version,
+                                                                    uint64_t* version, bool* reset,
+                                                                    simpleble_scan_change_t** changes,
+                                                                    size_t* changes_count);
+
+/**
+ * @brief Restricts the devices reported by subsequent scans.
+ *
+ * @note The filter takes effect on the next call to `simpleble_adapter_scan_start`.
+ *       Passing NULL disables filtering.
+ *
+ * @param handle
+ * @param filter
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_set_scan_filter(simpleble_adapter_t handle,
+                                                                   const simpleble_scan_filter_t* filter);
+
+/**
+ * @brief Bounds the number of unconnected, unpaired devices kept by the adapter during long running scans.
+ *
+ * @note Evicted devices are removed from the operating system's device cache as well. A zero value
+ *       disables the corresponding limit. Only enforced on Linux.
+ *
+ * @param handle
+ * @param max_devices
+ * @param ttl_ms
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_set_device_cache_limits(simpleble_adapter_t handle,
+                                                                          size_t max_devices, int ttl_ms);
+
+/**
+ * @brief
+ *
+ * @param handle
+ * @param cached_devices Receives the number of devices currently held by the adapter.
+ * @param evicted_devices Receives the number of devices evicted since the adapter was created.
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_get_device_cache_stats(simpleble_adapter_t handle,
+                                                                         size_t* cached_devices,
+                                                                         uint64_t* evicted_devices);
+
+/**
+ * @brief Limits how many GATT operations may run at once across all peripherals of the adapter.
+ *
+ * @note Operations on a single peripheral always run one at a time. Zero only keeps that limit.
+ *       Only enforced on Linux.
+ *
+ * @param handle
+ * @param max_concurrent
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_set_operation_concurrency(simpleble_adapter_t handle,
+                                                                            size_t max_concurrent);
+
+/**
+ * @brief
+ *
+ * @param handle
+ * @param priority Priority class to report on.
+ * @param queued Receives the number of operations currently waiting.
+ * @param started Receives the number of operations started since the adapter was created.
+ * @param mean_wait_us Receives the mean time started operations spent queued.
+ * @param max_wait_us Receives the longest time a started operation spent queued.
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_adapter_get_operation_queue_stats(simpleble_adapter_t handle,
+                                                                            simpleble_operation_priority_t priority,
+                                                                            size_t* queued, uint64_t* started,
+                                                                            uint64_t* mean_wait_us,
+                                                                            uint64_t* max_wait_us);
+
 /**
  * @brief
  *
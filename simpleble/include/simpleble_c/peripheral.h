@@ -173,6 +173,24 @@ SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_read(simpleble_peripheral_
                                                            simpleble_uuid_t characteristic, uint8_t** data,
                                                            size_t* data_length);
 
+/**
+ * @brief Returns the last known value of the characteristic if it is at most `max_age_ms` old, reading it otherwise.
+ *
+ * @note The user is responsible for freeing the pointer returned in data.
+ *
+ * @param handle
+ * @param service
+ * @param characteristic
+ * @param max_age_ms
+ * @param data
+ * @param data_length
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_read_cached(simpleble_peripheral_t handle,
+                                                                  simpleble_uuid_t service,
+                                                                  simpleble_uuid_t characteristic, int max_age_ms,
+                                                                  uint8_t** data, size_t* data_length);
+
 /**
  * @brief
  *
@@ -279,6 +297,125 @@ SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_write_descriptor(simpleble
                                                                        simpleble_uuid_t descriptor, const uint8_t* data,
                                                                        size_t data_length);
 
+/**
+ * @brief Reads a batch of characteristics, storing the value and outcome of each one in its request.
+ *
+ * @note On Linux, all requests are sent before waiting for the first reply. The function succeeds if the batch
+ *       could be run, even if some of its items failed.
+ *
+ * @param handle
+ * @param requests
+ * @param count
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_read_many(simpleble_peripheral_t handle,
+                                                                simpleble_read_request_t* requests, size_t count);
+
+/**
+ * @brief Writes a batch of characteristics, storing the outcome of each one in its request.
+ *
+ * @param handle
+ * @param requests
+ * @param count
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_write_many(simpleble_peripheral_t handle,
+                                                                 simpleble_write_request_t* requests, size_t count);
+
+/**
+ * @brief Starts connecting to the peripheral without waiting, calling `callback` with the outcome.
+ *
+ * @note The callback runs on a library thread and must not block. The handle must not be released before the
+ *       callback has run. If starting the operation fails, the callback is never called.
+ *
+ * @param handle
+ * @param callback
+ * @param userdata
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_connect_async(simpleble_peripheral_t handle,
+                                                                    void (*callback)(simpleble_peripheral_t peripheral,
+                                                                                     simpleble_err_t result,
+                                                                                     void* userdata),
+                                                                    void* userdata);
+
+/**
+ * @brief Starts reading a characteristic without waiting, passing the value to `callback`.
+ *
+ * @note The value is only valid for the duration of the callback. Same constraints as
+ *       simpleble_peripheral_connect_async().
+ *
+ * @param handle
+ * @param service
+ * @param characteristic
+ * @param callback
+ * @param userdata
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_read_async(
+    simpleble_peripheral_t handle, simpleble_uuid_t service, simpleble_uuid_t characteristic,
+    void (*callback)(simpleble_peripheral_t peripheral, simpleble_uuid_t service, simpleble_uuid_t characteristic,
+                     const uint8_t* data, size_t data_length, simpleble_err_t result, void* userdata),
+    void* userdata);
+
+/**
+ * @brief Starts writing a characteristic with a write request without waiting, calling `callback` with the outcome.
+ *
+ * @note Same constraints as simpleble_peripheral_connect_async().
+ *
+ * @param handle
+ * @param service
+ * @param characteristic
+ * @param data
+ * @param data_length
+ * @param callback
+ * @param userdata
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_write_request_async(
+    simpleble_peripheral_t handle, simpleble_uuid_t service, simpleble_uuid_t characteristic, const uint8_t* data,
+    size_t data_length,
+    void (*callback)(simpleble_peripheral_t peripheral, simpleble_uuid_t service, simpleble_uuid_t characteristic,
+                     simpleble_err_t result, void* userdata),
+    void* userdata);
+
+/**
+ * @brief Starts writing a characteristic with a write command without waiting, calling `callback` with the outcome.
+ *
+ * @note Same constraints as simpleble_peripheral_connect_async().
+ *
+ * @param handle
+ * @param service
+ * @param characteristic
+ * @param data
+ * @param data_length
+ * @param callback
+ * @param userdata
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_write_command_async(
+    simpleble_peripheral_t handle, simpleble_uuid_t service, simpleble_uuid_t characteristic, const uint8_t* data,
+    size_t data_length,
+    void (*callback)(simpleble_peripheral_t peripheral, simpleble_uuid_t service, simpleble_uuid_t characteristic,
+                     simpleble_err_t result, void* userdata),
+    void* userdata);
+
+/**
+ * @brief Sets the scheduling class of the operations on a characteristic and its descriptors.
+ *
+ * @note Operations are SIMPLEBLE_OPERATION_PRIORITY_INTERACTIVE unless set otherwise. Only supported on Linux.
+ *
+ * @param handle
+ * @param service
+ * @param characteristic
+ * @param priority
+ * @return simpleble_err_t
+ */
+SIMPLEBLE_EXPORT simpleble_err_t simpleble_peripheral_set_operation_priority(simpleble_peripheral_t handle,
+                                                                            simpleble_uuid_t service,
+                                                                            simpleble_uuid_t characteristic,
+                                                                            simpleble_operation_priority_t priority);
+
 /**
  * @brief
  *
@@ -7,6 +7,10 @@
 #define SIMPLEBLE_UUID_STR_LEN 37  // 36 characters + null terminator
 #define SIMPLEBLE_CHARACTERISTIC_MAX_COUNT 16
 #define SIMPLEBLE_DESCRIPTOR_MAX_COUNT 16
+#define SIMPLEBLE_SCAN_FILTER_UUID_MAX_COUNT 16
+#define SIMPLEBLE_SCAN_FILTER_PATTERN_MAX_LEN 32  // Including null terminator
+#define SIMPLEBLE_SCAN_FILTER_NAME_MAX_LEN 32     // Including null terminator
+#define SIMPLEBLE_SCAN_FILTER_MANUFACTURER_DATA_MAX_LEN 27
 
 // TODO: Add proper error codes.
 typedef enum {
@@ -71,3 +75,75 @@ typedef enum {
     SIMPLEBLE_ADDRESS_TYPE_RANDOM = 1,
     SIMPLEBLE_ADDRESS_TYPE_UNSPECIFIED = 2,
 } simpleble_address_type_t;
+
+typedef enum {
+    SIMPLEBLE_TRANSPORT_AUTO = 0,
+    SIMPLEBLE_TRANSPORT_BREDR = 1,
+    SIMPLEBLE_TRANSPORT_LE = 2,
+} simpleble_transport_t;
+
+typedef struct {
+    size_t service_uuid_count;
+    simpleble_uuid_t service_uuids[SIMPLEBLE_SCAN_FILTER_UUID_MAX_COUNT];
+    bool has_rssi_threshold;
+    int16_t rssi_threshold;
+    bool has_pathloss_threshold;
+    uint16_t pathloss_threshold;
+    simpleble_transport_t transport;
+    bool duplicate_data;
+    char pattern[SIMPLEBLE_SCAN_FILTER_PATTERN_MAX_LEN];
+    char name[SIMPLEBLE_SCAN_FILTER_NAME_MAX_LEN];
+    char name_prefix[SIMPLEBLE_SCAN_FILTER_NAME_MAX_LEN];
+    bool has_manufacturer_id;
+    uint16_t manufacturer_id;
+    size_t manufacturer_data_length;
+    uint8_t manufacturer_data[SIMPLEBLE_SCAN_FILTER_MANUFACTURER_DATA_MAX_LEN];
+    uint8_t manufacturer_data_mask[SIMPLEBLE_SCAN_FILTER_MANUFACTURER_DATA_MAX_LEN];
+    // Note: Only the bits set in `manufacturer_data_mask` are compared against
+    // the first `manufacturer_data_length` bytes of the advertised payload.
+    // A mask left all zero compares every bit.
+} simpleble_scan_filter_t;
+
+typedef enum {
+    SIMPLEBLE_SCAN_CHANGE_ADDED = 0,
+    SIMPLEBLE_SCAN_CHANGE_UPDATED = 1,
+    SIMPLEBLE_SCAN_CHANGE_LOST = 2,
+} simpleble_scan_change_kind_t;
+
+typedef struct {
+    simpleble_scan_change_kind_t kind;
+    simpleble_peripheral_t peripheral;
+} simpleble_scan_change_t;
+
+typedef enum {
+    SIMPLEBLE_OPERATION_PRIORITY_CONTROL = 0,
+    SIMPLEBLE_OPERATION_PRIORITY_INTERACTIVE = 1,
+    SIMPLEBLE_OPERATION_PRIORITY_BULK = 2,
+} simpleble_operation_priority_t;
+
+/**
+ * @brief Item of a batch passed to simpleble_peripheral_read_many().
+ *
+ * @details `data` points to a buffer of `data_capacity` bytes owned by the caller. On return, `data_length` holds
+ *          the full length of the value, which is truncated if it exceeds the capacity.
+ */
+typedef struct {
+    simpleble_uuid_t service;
+    simpleble_uuid_t characteristic;
+    uint8_t* data;
+    size_t data_capacity;
+    size_t data_length;
+    simpleble_err_t result;
+} simpleble_read_request_t;
+
+/**
+ * @brief Item of a batch passed to simpleble_peripheral_write_many().
+ */
+typedef struct {
+    simpleble_uuid_t service;
+    simpleble_uuid_t characteristic;
+    const uint8_t* data;
+    size_t data_length;
+    bool with_response;
+    simpleble_err_t result;
+} simpleble_write_request_t;
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
 #include "LoggingInternal.h"
 
 #define SAFE_CALLBACK_CALL(cb, ...)                                                           \
@@ -25,3 +31,24 @@
             SIMPLEBLE_LOG_ERROR("Unknown exception within code block");                     \
         }                                                                                   \
     } while (0)
+
+namespace SimpleBLE {
+
+/**
+ * @brief Current time in nanoseconds on std::chrono::steady_clock, used to stamp received events.
+ */
+inline uint64_t monotonic_timestamp_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Uppercases an address, so that addresses given by users can be compared to those reported by backends.
+ */
+inline std::string normalize_address(std::string address) {
+    std::transform(address.begin(), address.end(), address.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return address;
+}
+
+}  // namespace SimpleBLE
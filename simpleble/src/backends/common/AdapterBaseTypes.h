@@ -18,6 +18,8 @@ struct advertising_data_t {
 
     std::map<uint16_t, ByteArray> manufacturer_data;
     std::map<BluetoothUUID, ByteArray> service_data;
+    // Services listed in the advertisement, which need not carry any service data.
+    std::vector<BluetoothUUID> service_uuids;
 };
 
 }  // namespace SimpleBLE
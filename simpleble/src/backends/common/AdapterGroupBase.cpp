@@ -0,0 +1,391 @@
+#include "AdapterGroupBase.h"
+#include "AdapterGroupPolicy.h"
+
+#include "CommonUtils.h"
+#include "LoggingInternal.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace SimpleBLE;
+
+AdapterGroupBase::AdapterGroupBase(std::vector<Adapter> adapters, bool discover) : discover_(discover) {
+    for (auto& adapter : adapters) {
+        add_member(adapter);
+    }
+}
+
+AdapterGroupBase::~AdapterGroupBase() {
+    for (auto& member : members_) {
+        try {
+            member.adapter.set_callback_on_scan_found(nullptr);
+        } catch (...) {
+        }
+    }
+}
+
+void AdapterGroupBase::add_member(Adapter adapter) {
+    // Reading the address may block, so the member is prepared before taking the lock.
+    Member member;
+    member.adapter = adapter;
+    member.identifier = adapter.identifier();
+    try {
+        member.address = adapter.address();
+    } catch (std::exception const& e) {
+        SIMPLEBLE_LOG_WARN(fmt::format("Failed to read the address of {}: {}", member.identifier, e.what()));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto const& existing : members_) {
+            if (existing.identifier == member.identifier) return;
+        }
+        members_.push_back(member);
+    }
+
+    install_scan_callback(member.adapter);
+}
+
+void AdapterGroupBase::install_scan_callback(Adapter& adapter) {
+    // Called from each adapter's backend thread. A peripheral is reported once, by whichever adapter sees it first.
+    adapter.set_callback_on_scan_found([this](Peripheral peripheral) {
+        if (!callback_on_scan_found_) return;
+
+        {
+            std::lock_guard<std::mutex> lock(scan_found_mutex_);
+            if (!scan_found_.insert(normalize_address(peripheral.address())).second) return;
+        }
+
+        callback_on_scan_found_(peripheral);
+    });
+}
+
+std::vector<std::pair<size_t, Adapter>> AdapterGroupBase::available_members() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<std::pair<size_t, Adapter>> available;
+    for (size_t i = 0; i < members_.size(); i++) {
+        if (members_[i].available) {
+            available.emplace_back(i, members_[i].adapter);
+        }
+    }
+    return available;
+}
+
+std::vector<Adapter> AdapterGroupBase::adapters() {
+    std::vector<Adapter> adapters;
+    for (auto& [index, adapter] : available_members()) {
+        adapters.push_back(adapter);
+    }
+    return adapters;
+}
+
+void AdapterGroupBase::scan_start() {
+    {
+        std::lock_guard<std::mutex> lock(scan_found_mutex_);
+        scan_found_.clear();
+    }
+
+    for (auto& [index, adapter] : available_members()) {
+        try {
+            adapter.scan_start();
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to start scanning on {}: {}", adapter.identifier(), e.what()));
+            check_member(index);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    scanning_ = true;
+}
+
+void AdapterGroupBase::scan_stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        scanning_ = false;
+    }
+
+    for (auto& [index, adapter] : available_members()) {
+        try {
+            adapter.scan_stop();
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to stop scanning on {}: {}", adapter.identifier(), e.what()));
+            check_member(index);
+        }
+    }
+}
+
+void AdapterGroupBase::scan_for(int timeout_ms) {
+    scan_start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    scan_stop();
+}
+
+bool AdapterGroupBase::scan_is_active() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scanning_;
+}
+
+std::vector<Peripheral> AdapterGroupBase::scan_get_results() {
+    struct Best {
+        Peripheral peripheral;
+        int16_t rssi;
+    };
+
+    std::vector<BluetoothAddress> order;
+    std::map<BluetoothAddress, Best> best;
+
+    for (auto& [index, adapter] : available_members()) {
+        std::vector<Peripheral> results;
+        try {
+            results = adapter.scan_get_results();
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to get scan results of {}: {}", adapter.identifier(), e.what()));
+            check_member(index);
+            continue;
+        }
+
+        for (auto& peripheral : results) {
+            BluetoothAddress key = normalize_address(peripheral.address());
+            int16_t rssi = peripheral.rssi();
+
+            auto it = best.find(key);
+            if (it == best.end()) {
+                order.push_back(key);
+                best.emplace(key, Best{peripheral, rssi});
+            } else if (rssi > it->second.rssi) {
+                it->second = Best{peripheral, rssi};
+            }
+        }
+    }
+
+    std::vector<Peripheral> peripherals;
+    for (auto const& key : order) {
+        peripherals.push_back(best.at(key).peripheral);
+    }
+    return peripherals;
+}
+
+void AdapterGroupBase::set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found) {
+    if (on_scan_found) {
+        callback_on_scan_found_.load(std::move(on_scan_found));
+    } else {
+        callback_on_scan_found_.unload();
+    }
+}
+
+Peripheral AdapterGroupBase::connect(BluetoothAddress const& address) {
+    BluetoothAddress key = normalize_address(address);
+
+    prune_connections();
+
+    // Find out which adapters know the peripheral, without holding the lock during the blocking calls.
+    std::map<size_t, Peripheral> seen;
+    for (auto& [index, adapter] : available_members()) {
+        try {
+            std::vector<Peripheral> known = adapter.get_paired_peripherals();
+            std::vector<Peripheral> scanned = adapter.scan_get_results();
+            known.insert(known.end(), scanned.begin(), scanned.end());
+
+            for (auto& peripheral : known) {
+                if (normalize_address(peripheral.address()) == key) {
+                    seen.emplace(index, peripheral);
+                    break;
+                }
+            }
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to look up {} on {}: {}", key, adapter.identifier(), e.what()));
+            check_member(index);
+        }
+    }
+
+    std::vector<size_t> ranked;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<AdapterCandidate> candidates;
+        for (size_t i = 0; i < members_.size(); i++) {
+            AdapterCandidate candidate;
+            candidate.available = members_[i].available;
+            candidate.sees_peripheral = seen.count(i) > 0;
+            candidate.connections = members_[i].connections.size();
+            candidate.failures = members_[i].connect_failures;
+            candidates.push_back(candidate);
+        }
+        ranked = rank_adapters(candidates);
+    }
+
+    for (size_t index : ranked) {
+        Peripheral peripheral = seen.at(index);
+        try {
+            peripheral.connect();
+        } catch (std::exception const& e) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                members_[index].connect_failures++;
+                SIMPLEBLE_LOG_WARN(fmt::format("Failed to connect to {} through {}: {}", key,
+                                               members_[index].identifier, e.what()));
+            }
+            check_member(index);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        members_[index].connections.insert_or_assign(key, peripheral);
+        return peripheral;
+    }
+
+    throw Exception::OperationFailed(fmt::format("No adapter could connect to {}", key));
+}
+
+std::vector<Peripheral> AdapterGroupBase::refresh() {
+    std::map<std::string, Adapter> present;
+    for (auto& adapter : Adapter::get_adapters()) {
+        present.emplace(adapter.identifier(), adapter);
+    }
+
+    std::vector<Adapter> returned;
+    std::vector<BluetoothAddress> lost;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (size_t i = 0; i < members_.size(); i++) {
+            Member& member = members_[i];
+            auto it = present.find(member.identifier);
+
+            if (it == present.end()) {
+                if (member.available) {
+                    mark_unavailable(i);
+                }
+                continue;
+            }
+
+            if (!member.available) {
+                // The adapter came back, possibly as a new object.
+                SIMPLEBLE_LOG_INFO(fmt::format("Adapter {} is available again", member.identifier));
+                member.adapter = it->second;
+                member.available = true;
+                returned.push_back(member.adapter);
+            }
+            present.erase(it);
+        }
+
+        lost.swap(orphaned_);
+    }
+
+    for (auto& adapter : returned) {
+        install_scan_callback(adapter);
+    }
+
+    if (discover_) {
+        for (auto& [identifier, adapter] : present) {
+            SIMPLEBLE_LOG_INFO(fmt::format("Adding adapter {} to the group", identifier));
+            add_member(adapter);
+        }
+    }
+
+    std::vector<Peripheral> reconnected;
+    for (auto const& address : lost) {
+        try {
+            reconnected.push_back(connect(address));
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to move {} to another adapter: {}", address, e.what()));
+        }
+    }
+    return reconnected;
+}
+
+std::vector<AdapterGroup::AdapterLoad> AdapterGroupBase::load() {
+    prune_connections();
+
+    std::map<size_t, size_t> scan_results;
+    for (auto& [index, adapter] : available_members()) {
+        try {
+            scan_results[index] = adapter.scan_get_results().size();
+        } catch (...) {
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<AdapterGroup::AdapterLoad> loads;
+    for (size_t i = 0; i < members_.size(); i++) {
+        AdapterGroup::AdapterLoad load;
+        load.identifier = members_[i].identifier;
+        load.address = members_[i].address;
+        load.available = members_[i].available;
+        load.connections = members_[i].connections.size();
+        load.scan_results = scan_results.count(i) > 0 ? scan_results[i] : 0;
+        load.connect_failures = members_[i].connect_failures;
+        loads.push_back(load);
+    }
+    return loads;
+}
+
+void AdapterGroupBase::check_member(size_t index) {
+    std::string identifier;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        identifier = members_[index].identifier;
+    }
+
+    bool present = false;
+    try {
+        for (auto& adapter : Adapter::get_adapters()) {
+            if (adapter.identifier() == identifier) {
+                present = true;
+                break;
+            }
+        }
+    } catch (...) {
+    }
+
+    if (!present) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (members_[index].available) {
+            mark_unavailable(index);
+        }
+    }
+}
+
+void AdapterGroupBase::mark_unavailable(size_t index) {
+    Member& member = members_[index];
+    SIMPLEBLE_LOG_WARN(fmt::format("Adapter {} is no longer available", member.identifier));
+
+    // Its connections are re-established through the remaining adapters by the next call to refresh().
+    member.available = false;
+    for (auto& [address, peripheral] : member.connections) {
+        orphaned_.push_back(address);
+    }
+    member.connections.clear();
+}
+
+void AdapterGroupBase::prune_connections() {
+    std::vector<std::pair<size_t, std::pair<BluetoothAddress, Peripheral>>> connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < members_.size(); i++) {
+            for (auto& connection : members_[i].connections) {
+                connections.emplace_back(i, connection);
+            }
+        }
+    }
+
+    std::vector<std::pair<size_t, BluetoothAddress>> dropped;
+    for (auto& [index, connection] : connections) {
+        bool connected = false;
+        try {
+            connected = connection.second.is_connected();
+        } catch (...) {
+        }
+
+        if (!connected) {
+            dropped.emplace_back(index, connection.first);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [index, address] : dropped) {
+        members_[index].connections.erase(address);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <simpleble/AdapterGroup.h>
+
+#include <kvn_safe_callback.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SimpleBLE {
+
+class AdapterGroupBase {
+  public:
+    AdapterGroupBase(std::vector<Adapter> adapters, bool discover);
+    virtual ~AdapterGroupBase();
+
+    std::vector<Adapter> adapters();
+
+    void scan_start();
+    void scan_stop();
+    void scan_for(int timeout_ms);
+    bool scan_is_active();
+    std::vector<Peripheral> scan_get_results();
+
+    void set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found);
+
+    Peripheral connect(BluetoothAddress const& address);
+    std::vector<Peripheral> refresh();
+
+    std::vector<AdapterGroup::AdapterLoad> load();
+
+  protected:
+    struct Member {
+        Adapter adapter;
+        std::string identifier;
+        BluetoothAddress address;
+        bool available = true;
+        // Peripherals connected through this adapter, by normalized address.
+        std::map<BluetoothAddress, Peripheral> connections;
+        uint64_t connect_failures = 0;
+    };
+
+    // Members are only ever appended, so that indices remain valid while the mutex is released.
+    std::vector<std::pair<size_t, Adapter>> available_members();
+
+    void add_member(Adapter adapter);
+    void install_scan_callback(Adapter& adapter);
+
+    // Checks whether a member that just failed is still present in the system.
+    void check_member(size_t index);
+    // Must be called with the mutex held.
+    void mark_unavailable(size_t index);
+
+    // Drops connections that are no longer established.
+    void prune_connections();
+
+    const bool discover_;
+
+    std::mutex mutex_;
+    std::vector<Member> members_;
+    // Peripherals whose adapter went away, waiting to be reconnected by refresh().
+    std::vector<BluetoothAddress> orphaned_;
+    bool scanning_ = false;
+
+    std::mutex scan_found_mutex_;
+    std::set<BluetoothAddress> scan_found_;
+    kvn::safe_callback<void(Peripheral)> callback_on_scan_found_;
+};
+
+}  // namespace SimpleBLE
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace SimpleBLE {
+
+struct AdapterCandidate {
+    bool available = true;
+    // Whether the adapter has seen the peripheral to connect to.
+    bool sees_peripheral = false;
+    size_t connections = 0;
+    uint64_t failures = 0;
+};
+
+/**
+ * @brief Orders the adapters able to connect to a peripheral by preference.
+ *
+ * @details Only available adapters that have seen the peripheral are considered. The ones with the fewest
+ *          connections come first, ties being broken by the number of past failures and then by position.
+ *
+ * @return Indices into `candidates`, most preferred first.
+ */
+inline std::vector<size_t> rank_adapters(std::vector<AdapterCandidate> const& candidates) {
+    std::vector<size_t> order;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (candidates[i].available && candidates[i].sees_peripheral) {
+            order.push_back(i);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::tie(candidates[a].connections, candidates[a].failures) <
+               std::tie(candidates[b].connections, candidates[b].failures);
+    });
+    return order;
+}
+
+}  // namespace SimpleBLE
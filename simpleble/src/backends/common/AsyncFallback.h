@@ -0,0 +1,57 @@
+#pragma once
+
+#include <simpleble/Types.h>
+
+#include "TimerQueue.h"
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Queue running the blocking operations below. Each of them can hold a thread for several seconds, so they
+ *        are kept apart from the shared timer queue.
+ */
+inline TimerQueue& helper_queue() {
+    static constexpr size_t HELPER_THREADS = 4;
+    static TimerQueue queue(HELPER_THREADS);
+    return queue;
+}
+
+/**
+ * @brief Runs a blocking operation on a helper thread and reports its outcome, for backends that have no
+ *        non-blocking path for it.
+ */
+template <typename Function>
+void run_on_helper_thread(Function function, std::function<void(std::exception_ptr error)> on_complete) {
+    helper_queue().schedule(0, [function = std::move(function), on_complete = std::move(on_complete)]() mutable {
+        try {
+            function();
+        } catch (...) {
+            on_complete(std::current_exception());
+            return;
+        }
+        on_complete(nullptr);
+    });
+}
+
+template <typename Function>
+void run_on_helper_thread(Function function,
+                          std::function<void(ByteArray value, std::exception_ptr error)> on_complete) {
+    helper_queue().schedule(0, [function = std::move(function), on_complete = std::move(on_complete)]() mutable {
+        ByteArray value;
+        try {
+            value = function();
+        } catch (...) {
+            on_complete(ByteArray(), std::current_exception());
+            return;
+        }
+        on_complete(value, nullptr);
+    });
+}
+
+}  // namespace SimpleBLE
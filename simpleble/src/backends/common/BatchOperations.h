@@ -0,0 +1,46 @@
+#pragma once
+
+#include <simpleble/Types.h>
+
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Runs one item of a batch, turning its outcome into a result instead of letting it throw.
+ */
+template <typename Function>
+OperationResult capture_result(Function&& function) {
+    OperationResult result;
+    try {
+        if constexpr (std::is_void_v<decltype(function())>) {
+            function();
+        } else {
+            result.value = function();
+        }
+        result.success = true;
+    } catch (std::exception const& e) {
+        result.error = e.what();
+    } catch (...) {
+        result.error = "Unknown error";
+    }
+    return result;
+}
+
+/**
+ * @brief Runs the items of a batch one after the other, for backends that cannot pipeline them.
+ */
+template <typename Request, typename Function>
+std::vector<OperationResult> run_serially(std::vector<Request> const& requests, Function&& function) {
+    std::vector<OperationResult> results;
+    results.reserve(requests.size());
+    for (auto const& request : requests) {
+        results.push_back(capture_result([&]() { return function(request); }));
+    }
+    return results;
+}
+
+}  // namespace SimpleBLE
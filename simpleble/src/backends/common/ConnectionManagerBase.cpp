@@ -0,0 +1,406 @@
+#include "ConnectionManagerBase.h"
+
+#include "CommonUtils.h"
+#include "LoggingInternal.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace SimpleBLE;
+
+ConnectionManagerBase::ConnectionManagerBase(Adapter adapter, ConnectionManager::Options const& options)
+    : options_(options), adapter_(adapter) {
+    connector_ = [this](BluetoothAddress const& address) { return connect_peripheral(address); };
+    disconnector_ = [this](BluetoothAddress const& address) { disconnect_peripheral(address); };
+}
+
+ConnectionManagerBase::ConnectionManagerBase(Connector connector, Disconnector disconnector,
+                                             ConnectionManager::Options const& options)
+    : options_(options), connector_(std::move(connector)), disconnector_(std::move(disconnector)) {}
+
+ConnectionManagerBase::~ConnectionManagerBase() { stop(); }
+
+void ConnectionManagerBase::add(BluetoothAddress const& address) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        target(normalize_address(address));
+    }
+    cv_.notify_all();
+}
+
+void ConnectionManagerBase::remove(BluetoothAddress const& address) {
+    BluetoothAddress key = normalize_address(address);
+
+    bool connected = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = targets_.find(key);
+        if (it == targets_.end()) return;
+
+        connected = it->second.state == State::CONNECTED;
+        targets_.erase(it);
+    }
+
+    // Attempts in progress are torn down by the worker once they complete.
+    if (connected) {
+        disconnector_(key);
+    }
+}
+
+std::vector<BluetoothAddress> ConnectionManagerBase::targets() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<BluetoothAddress> addresses;
+    for (auto const& [address, target] : targets_) {
+        addresses.push_back(address);
+    }
+    return addresses;
+}
+
+void ConnectionManagerBase::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopping_) return;
+
+    stopping_ = false;
+    for (size_t i = 0; i < std::max<size_t>(options_.max_concurrent, 1); i++) {
+        workers_.emplace_back(&ConnectionManagerBase::run, this);
+    }
+}
+
+void ConnectionManagerBase::stop() {
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        workers.swap(workers_);
+    }
+    cv_.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> scan_lock(scan_mutex_);
+    bool was_scanning = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(was_scanning, scanning_);
+    }
+
+    // Scanning involves blocking calls, which are never made with the mutex held.
+    if (was_scanning) {
+        try {
+            adapter_->scan_stop();
+        } catch (...) {
+        }
+    }
+}
+
+ConnectionManagerBase::Target& ConnectionManagerBase::target(BluetoothAddress const& key) {
+    auto [it, inserted] = targets_.try_emplace(key);
+    if (inserted) {
+        it->second.backoff_ms = std::max(options_.initial_backoff_ms, 1);
+    }
+    return it->second;
+}
+
+bool ConnectionManagerBase::is_connected(BluetoothAddress const& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = targets_.find(normalize_address(address));
+    return it != targets_.end() && it->second.state == State::CONNECTED;
+}
+
+std::optional<Peripheral> ConnectionManagerBase::peripheral(BluetoothAddress const& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = peripherals_.find(normalize_address(address));
+    if (it == peripherals_.end()) return std::nullopt;
+    return it->second;
+}
+
+void ConnectionManagerBase::notify(BluetoothAddress const& address, BluetoothUUID const& service,
+                                   BluetoothUUID const& characteristic,
+                                   std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
+    std::optional<Peripheral> connected_peripheral;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        BluetoothAddress key = normalize_address(address);
+        Target& subscribed = target(key);
+        subscribed.subscriptions.push_back(Subscription{service, characteristic, callback});
+
+        auto it = peripherals_.find(key);
+        if (subscribed.state == State::CONNECTED && it != peripherals_.end()) {
+            connected_peripheral = it->second;
+        }
+    }
+
+    // Targets already connected are subscribed right away, later connections restore the subscription.
+    if (connected_peripheral) {
+        connected_peripheral->notify(service, characteristic, std::move(callback));
+    }
+}
+
+void ConnectionManagerBase::set_callback_on_connected(std::function<void(Peripheral)> on_connected) {
+    if (on_connected) {
+        callback_on_connected_.load(std::move(on_connected));
+    } else {
+        callback_on_connected_.unload();
+    }
+}
+
+void ConnectionManagerBase::set_callback_on_disconnected(std::function<void(Peripheral)> on_disconnected) {
+    if (on_disconnected) {
+        callback_on_disconnected_.load(std::move(on_disconnected));
+    } else {
+        callback_on_disconnected_.unload();
+    }
+}
+
+bool ConnectionManagerBase::disconnected(BluetoothAddress const& address) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = targets_.find(normalize_address(address));
+        if (it == targets_.end()) return false;
+
+        Target& target = it->second;
+        if (target.state == State::CONNECTING) {
+            // The attempt fails once it completes, so that the target is not left marked as connected.
+            target.dropped = true;
+            return false;
+        }
+        if (target.state != State::CONNECTED) return false;
+
+        target.state = State::DISCONNECTED;
+        target.backoff_ms = std::max(options_.initial_backoff_ms, 1);
+        target.next_attempt = options_.auto_reconnect ? monotonic_timestamp_ns() : UINT64_MAX;
+        stats_.disconnects++;
+    }
+    cv_.notify_all();
+    return true;
+}
+
+ConnectionManager::Stats ConnectionManagerBase::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ConnectionManager::Stats stats = stats_;
+    stats.targets = targets_.size();
+    stats.connected = std::count_if(targets_.begin(), targets_.end(),
+                                    [](auto const& entry) { return entry.second.state == State::CONNECTED; });
+
+    uint64_t connects = stats_.attempts - stats_.failures;
+    stats.mean_connect_ms = connects > 0 ? total_connect_ms_ / connects : 0;
+    return stats;
+}
+
+void ConnectionManagerBase::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        uint64_t wake_up = UINT64_MAX;
+        std::optional<BluetoothAddress> address = next_due(monotonic_timestamp_ns(), wake_up);
+        if (!address) {
+            if (wake_up == UINT64_MAX) {
+                cv_.wait(lock);
+            } else {
+                uint64_t delay_ns = wake_up - std::min(wake_up, monotonic_timestamp_ns());
+                cv_.wait_for(lock, std::chrono::nanoseconds(delay_ns));
+            }
+            continue;
+        }
+
+        Target& target = targets_[*address];
+        target.state = State::CONNECTING;
+        target.dropped = false;
+        stats_.attempts++;
+        lock.unlock();
+        attempt(*address);
+        lock.lock();
+    }
+}
+
+std::optional<BluetoothAddress> ConnectionManagerBase::next_due(uint64_t now, uint64_t& wake_up) {
+    std::optional<BluetoothAddress> due;
+    uint64_t earliest = UINT64_MAX;
+
+    for (auto const& [address, target] : targets_) {
+        if (target.state != State::DISCONNECTED || target.next_attempt == UINT64_MAX) continue;
+
+        if (target.next_attempt <= now) {
+            if (!due || target.next_attempt < earliest) {
+                due = address;
+                earliest = target.next_attempt;
+            }
+        } else if (!due) {
+            wake_up = std::min(wake_up, target.next_attempt);
+        }
+    }
+
+    return due;
+}
+
+void ConnectionManagerBase::attempt(BluetoothAddress const& address) {
+    uint64_t started = monotonic_timestamp_ns();
+
+    bool success = false;
+    try {
+        success = connector_(address);
+    } catch (std::exception const& e) {
+        SIMPLEBLE_LOG_DEBUG(fmt::format("Connection to {} failed: {}", address, e.what()));
+    } catch (...) {
+        SIMPLEBLE_LOG_DEBUG(fmt::format("Connection to {} failed", address));
+    }
+
+    uint64_t finished = monotonic_timestamp_ns();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = targets_.find(address);
+    if (it == targets_.end()) {
+        // The target was removed while connecting.
+        lock.unlock();
+        if (success) {
+            disconnector_(address);
+        }
+        return;
+    }
+
+    Target& target = it->second;
+    if (success && target.dropped) {
+        SIMPLEBLE_LOG_DEBUG(fmt::format("Connection to {} dropped while being set up", address));
+        success = false;
+    }
+
+    if (!success) {
+        stats_.failures++;
+        target.state = State::DISCONNECTED;
+        target.next_attempt = finished + static_cast<uint64_t>(target.backoff_ms) * 1000000;
+        target.backoff_ms = std::max(std::min(target.backoff_ms * 2, options_.max_backoff_ms), 1);
+        return;
+    }
+
+    uint64_t connect_ms = (finished - started) / 1000000;
+    total_connect_ms_ += connect_ms;
+    stats_.max_connect_ms = std::max(stats_.max_connect_ms, connect_ms);
+    if (target.was_connected) {
+        stats_.reconnects++;
+    }
+
+    target.state = State::CONNECTED;
+    target.was_connected = true;
+    target.backoff_ms = std::max(options_.initial_backoff_ms, 1);
+
+    auto peripheral = peripherals_.find(address);
+    if (peripheral == peripherals_.end()) return;
+
+    Peripheral connected_peripheral = peripheral->second;
+    lock.unlock();
+    callback_on_connected_(connected_peripheral);
+}
+
+bool ConnectionManagerBase::connect_peripheral(BluetoothAddress const& address) {
+    std::optional<Peripheral> peripheral = resolve(address);
+    if (!peripheral) return false;
+
+    // The peripheral is looked up rather than captured, as it owns the callback. The callback is left in place
+    // when the manager goes away, as it may be running at that point, and only holds a weak reference to it.
+    std::weak_ptr<ConnectionManagerBase> weak_self = weak_from_this();
+    peripheral->set_callback_on_disconnected([weak_self, address]() {
+        auto self = weak_self.lock();
+        if (!self) return;
+
+        // Connections dropped before they were reported are not reported as lost either.
+        if (!self->disconnected(address)) return;
+        if (auto disconnected_peripheral = self->peripheral(address)) {
+            self->callback_on_disconnected_(*disconnected_peripheral);
+        }
+    });
+
+    peripheral->connect();
+
+    std::vector<Subscription> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = targets_.find(address);
+        if (it != targets_.end()) {
+            subscriptions = it->second.subscriptions;
+        }
+    }
+
+    for (auto& subscription : subscriptions) {
+        try {
+            peripheral->notify(subscription.service, subscription.characteristic, subscription.callback);
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to restore subscription to {} on {}: {}",
+                                           subscription.characteristic, address, e.what()));
+        }
+    }
+
+    return true;
+}
+
+void ConnectionManagerBase::disconnect_peripheral(BluetoothAddress const& address) {
+    std::optional<Peripheral> peripheral;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = peripherals_.find(address);
+        if (it == peripherals_.end()) return;
+        peripheral = it->second;
+    }
+
+    try {
+        peripheral->disconnect();
+    } catch (std::exception const& e) {
+        SIMPLEBLE_LOG_WARN(fmt::format("Failed to disconnect {}: {}", address, e.what()));
+    }
+}
+
+std::optional<Peripheral> ConnectionManagerBase::resolve(BluetoothAddress const& address) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = peripherals_.find(address);
+        if (it != peripherals_.end()) return it->second;
+    }
+
+    std::vector<Peripheral> candidates = adapter_->get_paired_peripherals();
+    std::vector<Peripheral> scanned = adapter_->scan_get_results();
+    candidates.insert(candidates.end(), scanned.begin(), scanned.end());
+
+    std::lock_guard<std::mutex> scan_lock(scan_mutex_);
+    bool scan_active = adapter_->scan_is_active();
+
+    std::optional<Peripheral> resolved;
+    bool start_scan = false;
+    bool stop_scan = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& candidate : candidates) {
+            BluetoothAddress key = normalize_address(candidate.address());
+            if (targets_.count(key) > 0 && peripherals_.count(key) == 0) {
+                peripherals_.emplace(key, candidate);
+            }
+        }
+
+        bool unresolved = std::any_of(targets_.begin(), targets_.end(),
+                                      [this](auto const& entry) { return peripherals_.count(entry.first) == 0; });
+
+        // Unknown targets are looked for with a background scan, which is stopped once every target is known.
+        start_scan = unresolved && !scanning_ && !scan_active;
+        stop_scan = !unresolved && scanning_;
+
+        auto it = peripherals_.find(address);
+        if (it != peripherals_.end()) {
+            resolved = it->second;
+        }
+    }
+
+    // Scanning involves blocking calls, which are never made with the mutex held.
+    if (start_scan || stop_scan) {
+        if (start_scan) {
+            adapter_->scan_start();
+        } else {
+            adapter_->scan_stop();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        scanning_ = start_scan;
+    }
+
+    return resolved;
+}
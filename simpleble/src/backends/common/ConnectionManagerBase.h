@@ -0,0 +1,130 @@
+#pragma once
+
+#include <simpleble/ConnectionManager.h>
+
+#include <kvn_safe_callback.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SimpleBLE {
+
+class ConnectionManagerBase : public std::enable_shared_from_this<ConnectionManagerBase> {
+  public:
+    /**
+     * @brief Establishes a connection to a target, returning false or throwing if it could not be established.
+     */
+    using Connector = std::function<bool(BluetoothAddress const& address)>;
+    using Disconnector = std::function<void(BluetoothAddress const& address)>;
+
+    /**
+     * @brief Manages the peripherals of an adapter.
+     */
+    ConnectionManagerBase(Adapter adapter, ConnectionManager::Options const& options);
+
+    /**
+     * @brief Manages abstract targets, which allows the scheduling to be exercised without a radio.
+     */
+    ConnectionManagerBase(Connector connector, Disconnector disconnector, ConnectionManager::Options const& options);
+
+    virtual ~ConnectionManagerBase();
+
+    void add(BluetoothAddress const& address);
+    void remove(BluetoothAddress const& address);
+    std::vector<BluetoothAddress> targets();
+
+    void start();
+    void stop();
+
+    bool is_connected(BluetoothAddress const& address);
+    std::optional<Peripheral> peripheral(BluetoothAddress const& address);
+
+    void notify(BluetoothAddress const& address, BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                std::function<void(ByteArray payload, uint64_t timestamp)> callback);
+
+    void set_callback_on_connected(std::function<void(Peripheral)> on_connected);
+    void set_callback_on_disconnected(std::function<void(Peripheral)> on_disconnected);
+
+    /**
+     * @brief Records that the connection to a target dropped, scheduling a reconnection if enabled.
+     *
+     * @details A drop while the connection is still being set up fails the attempt in progress.
+     *
+     * @note Called from the backend thread reporting the disconnection.
+     * @return Whether the target had been reported as connected.
+     */
+    bool disconnected(BluetoothAddress const& address);
+
+    ConnectionManager::Stats stats();
+
+  protected:
+    enum class State {
+        DISCONNECTED,
+        CONNECTING,
+        CONNECTED,
+    };
+
+    struct Subscription {
+        BluetoothUUID service;
+        BluetoothUUID characteristic;
+        std::function<void(ByteArray payload, uint64_t timestamp)> callback;
+    };
+
+    struct Target {
+        State state = State::DISCONNECTED;
+        // Time of the next attempt, in nanoseconds on std::chrono::steady_clock. UINT64_MAX means never.
+        uint64_t next_attempt = 0;
+        int backoff_ms = 0;
+        bool was_connected = false;
+        // Set when the connection drops while the attempt is still setting it up, such as restoring subscriptions.
+        bool dropped = false;
+        std::vector<Subscription> subscriptions;
+    };
+
+    // Returns the target for a normalized address, adding it if needed. Must be called with the mutex held.
+    Target& target(BluetoothAddress const& key);
+
+    void run();
+
+    // Returns the target with the earliest due attempt, or nullopt along with the time to wait until otherwise.
+    // Must be called with the mutex held.
+    std::optional<BluetoothAddress> next_due(uint64_t now, uint64_t& wake_up);
+
+    void attempt(BluetoothAddress const& address);
+
+    // Default connector and disconnector, backed by the adapter.
+    bool connect_peripheral(BluetoothAddress const& address);
+    void disconnect_peripheral(BluetoothAddress const& address);
+    std::optional<Peripheral> resolve(BluetoothAddress const& address);
+
+    const ConnectionManager::Options options_;
+    std::optional<Adapter> adapter_;
+    Connector connector_;
+    Disconnector disconnector_;
+
+    std::mutex mutex_;
+    // Orders the background scan being started and stopped, and is held across those calls. Taken before mutex_.
+    std::mutex scan_mutex_;
+    std::condition_variable cv_;
+    std::map<BluetoothAddress, Target> targets_;
+    std::map<BluetoothAddress, Peripheral> peripherals_;
+    bool stopping_ = true;
+    bool scanning_ = false;
+    std::vector<std::thread> workers_;
+
+    ConnectionManager::Stats stats_;
+    uint64_t total_connect_ms_ = 0;
+
+    kvn::safe_callback<void(Peripheral)> callback_on_connected_;
+    kvn::safe_callback<void(Peripheral)> callback_on_disconnected_;
+};
+
+}  // namespace SimpleBLE
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <simpleble/Adapter.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Whether `limits` bound the cache at all.
+ */
+inline bool device_cache_limits_enabled(DeviceCacheLimits const& limits) {
+    return limits.max_devices > 0 || limits.ttl_ms > 0;
+}
+
+/**
+ * @brief Stands in for the last-seen time of devices that have not been heard from since they were loaded.
+ *
+ * @details Such devices are aged from the first sweep that came across them, so that a TTL does not evict
+ *          every device loaded at startup on its first pass.
+ */
+class DeviceLoadTimes {
+  public:
+    /**
+     * @brief Returns `last_seen`, or the time the device at `path` was first swept if `last_seen` is zero.
+     */
+    uint64_t resolve(std::string const& path, uint64_t last_seen, uint64_t now) {
+        if (last_seen != 0) {
+            return last_seen;
+        }
+
+        auto known = load_times_.find(path);
+        uint64_t load_time = known != load_times_.end() ? known->second : now;
+        swept_[path] = load_time;
+        return load_time;
+    }
+
+    /**
+     * @brief Forgets the devices that were not resolved since the previous sweep.
+     */
+    void finish_sweep() {
+        load_times_ = std::move(swept_);
+        swept_.clear();
+    }
+
+  private:
+    std::map<std::string, uint64_t> load_times_;
+    std::map<std::string, uint64_t> swept_;
+};
+
+/**
+ * @brief Picks which evictable devices to drop so that the cache stays within `limits`.
+ *
+ * @details Devices not heard from for longer than the TTL are evicted first. If more devices than
+ *          allowed remain, the least recently seen ones are evicted until the cap is met.
+ *
+ * @param last_seen Time at which each evictable device was last heard from, in nanoseconds on
+ *                  std::chrono::steady_clock. Zero means unknown, which is treated as the oldest, so
+ *                  callers resolve it through DeviceLoadTimes first.
+ * @param now Current time, on the same time base.
+ * @return Indices into `last_seen` of the devices to evict, least recently seen first.
+ */
+inline std::vector<size_t> select_device_evictions(std::vector<uint64_t> const& last_seen,
+                                                   DeviceCacheLimits const& limits, uint64_t now) {
+    std::vector<size_t> order(last_seen.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return last_seen[a] < last_seen[b]; });
+
+    size_t expired = 0;
+    if (limits.ttl_ms > 0) {
+        uint64_t ttl_ns = static_cast<uint64_t>(limits.ttl_ms) * 1000000;
+        while (expired < order.size() && last_seen[order[expired]] + ttl_ns < now) {
+            expired++;
+        }
+    }
+
+    size_t over_cap = 0;
+    if (limits.max_devices > 0 && order.size() > limits.max_devices) {
+        over_cap = order.size() - limits.max_devices;
+    }
+
+    order.resize(std::max(expired, over_cap));
+    return order;
+}
+
+}  // namespace SimpleBLE
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace SimpleBLE {
+
+/**
+ * @brief Marks the current thread, while in scope, as one dispatching the events of a whole connection or queue.
+ *
+ * @details Nothing may block such a thread on behalf of a single consumer, as every other event queued behind it
+ *          would be held up as well.
+ */
+class DispatchThreadScope {
+  public:
+    DispatchThreadScope() : previous_(active_) { active_ = true; }
+    ~DispatchThreadScope() { active_ = previous_; }
+
+    DispatchThreadScope(const DispatchThreadScope&) = delete;
+    DispatchThreadScope& operator=(const DispatchThreadScope&) = delete;
+
+    static bool active() { return active_; }
+
+  private:
+    bool previous_;
+    static inline thread_local bool active_ = false;
+};
+
+}  // namespace SimpleBLE
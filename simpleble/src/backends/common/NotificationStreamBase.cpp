@@ -0,0 +1,116 @@
+#include "NotificationStreamBase.h"
+#include "DispatchThread.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace SimpleBLE;
+
+NotificationStreamBase::NotificationStreamBase(NotificationStream::Options const& options)
+    : capacity_(std::max<size_t>(options.capacity, 1)), overflow_policy_(options.overflow_policy) {}
+
+void NotificationStreamBase::push(ByteArray payload) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_) return;
+
+    received_++;
+
+    auto overflow_policy = overflow_policy_;
+    if (overflow_policy == NotificationStream::OverflowPolicy::BLOCK && DispatchThreadScope::active()) {
+        overflow_policy = NotificationStream::OverflowPolicy::DROP_OLDEST;
+    }
+
+    if (queue_.size() >= capacity_) {
+        switch (overflow_policy) {
+            case NotificationStream::OverflowPolicy::DROP_OLDEST:
+                queue_.pop_front();
+                dropped_++;
+                break;
+            case NotificationStream::OverflowPolicy::DROP_NEWEST:
+                dropped_++;
+                return;
+            case NotificationStream::OverflowPolicy::BLOCK:
+                cv_not_full_.wait(lock, [this]() { return closed_ || queue_.size() < capacity_; });
+                if (closed_) {
+                    dropped_++;
+                    return;
+                }
+                break;
+        }
+    }
+
+    queue_.push_back(std::move(payload));
+    high_water_mark_ = std::max(high_water_mark_, queue_.size());
+    lock.unlock();
+    cv_not_empty_.notify_one();
+}
+
+std::optional<ByteArray> NotificationStreamBase::next(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto ready = [this]() { return closed_ || !queue_.empty(); };
+
+    if (timeout_ms < 0) {
+        cv_not_empty_.wait(lock, ready);
+    } else if (!cv_not_empty_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready)) {
+        return std::nullopt;
+    }
+
+    if (queue_.empty()) return std::nullopt;
+
+    ByteArray payload = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    cv_not_full_.notify_one();
+    return payload;
+}
+
+std::vector<ByteArray> NotificationStreamBase::drain(size_t max) {
+    std::vector<ByteArray> payloads;
+    {
+        std::scoped_lock lock(mutex_);
+        size_t count = std::min(max, queue_.size());
+        payloads.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            payloads.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+    }
+    cv_not_full_.notify_all();
+    return payloads;
+}
+
+void NotificationStreamBase::close() {
+    {
+        std::scoped_lock lock(mutex_);
+        closed_ = true;
+    }
+    cv_not_empty_.notify_all();
+    cv_not_full_.notify_all();
+}
+
+bool NotificationStreamBase::is_closed() {
+    std::scoped_lock lock(mutex_);
+    return closed_;
+}
+
+size_t NotificationStreamBase::size() {
+    std::scoped_lock lock(mutex_);
+    return queue_.size();
+}
+
+size_t NotificationStreamBase::capacity() const { return capacity_; }
+
+uint64_t NotificationStreamBase::received() {
+    std::scoped_lock lock(mutex_);
+    return received_;
+}
+
+uint64_t NotificationStreamBase::dropped() {
+    std::scoped_lock lock(mutex_);
+    return dropped_;
+}
+
+size_t NotificationStreamBase::high_water_mark() {
+    std::scoped_lock lock(mutex_);
+    return high_water_mark_;
+}
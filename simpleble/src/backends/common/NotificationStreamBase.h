@@ -0,0 +1,51 @@
+#pragma once
+
+#include <simpleble/NotificationStream.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace SimpleBLE {
+
+class NotificationStreamBase {
+  public:
+    NotificationStreamBase(NotificationStream::Options const& options);
+    virtual ~NotificationStreamBase() = default;
+
+    /**
+     * @brief Enqueues a payload according to the configured overflow policy.
+     *
+     * @note Called from the backend thread delivering the notification.
+     */
+    void push(ByteArray payload);
+
+    std::optional<ByteArray> next(int timeout_ms);
+    std::vector<ByteArray> drain(size_t max);
+
+    void close();
+    bool is_closed();
+
+    size_t size();
+    size_t capacity() const;
+
+    uint64_t received();
+    uint64_t dropped();
+    size_t high_water_mark();
+
+  protected:
+    const size_t capacity_;
+    const NotificationStream::OverflowPolicy overflow_policy_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_not_empty_;
+    std::condition_variable cv_not_full_;
+    std::deque<ByteArray> queue_;
+    bool closed_ = false;
+
+    uint64_t received_ = 0;
+    uint64_t dropped_ = 0;
+    size_t high_water_mark_ = 0;
+};
+
+}  // namespace SimpleBLE
@@ -0,0 +1,179 @@
+#include "OperationScheduler.h"
+
+#include "CommonUtils.h"
+
+#include <algorithm>
+
+using namespace SimpleBLE;
+
+OperationScheduler::OperationScheduler(size_t max_concurrent) : max_concurrent_(max_concurrent) {}
+
+OperationScheduler::~OperationScheduler() {
+    // Submitted operations that never got their turn are dropped.
+    for (ClassState& state : classes_) {
+        for (auto& [peripheral, queue] : state.queues) {
+            for (Ticket* ticket : queue) {
+                if (ticket->start) {
+                    delete ticket;
+                }
+            }
+        }
+    }
+}
+
+void OperationScheduler::set_max_concurrent(size_t max_concurrent) {
+    std::vector<std::function<void()>> started;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_concurrent_ = max_concurrent;
+        started = grant();
+    }
+    start_all(started);
+}
+
+std::vector<OperationQueueStats> OperationScheduler::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<OperationQueueStats> stats;
+    for (size_t i = 0; i < PRIORITY_COUNT; i++) {
+        ClassState const& state = classes_[i];
+
+        OperationQueueStats class_stats;
+        class_stats.priority = static_cast<OperationPriority>(i);
+        class_stats.queued = state.queued;
+        class_stats.started = state.started;
+        class_stats.mean_wait_us = state.started > 0 ? state.total_wait_ns / state.started / 1000 : 0;
+        class_stats.max_wait_us = state.max_wait_ns / 1000;
+        stats.push_back(class_stats);
+    }
+    return stats;
+}
+
+OperationScheduler::Slot::Slot(OperationScheduler& scheduler, std::string const& peripheral,
+                               OperationPriority priority)
+    : scheduler_(scheduler), peripheral_(peripheral) {
+    scheduler_.acquire(peripheral_, priority);
+}
+
+OperationScheduler::Slot::~Slot() { scheduler_.release(peripheral_); }
+
+void OperationScheduler::acquire(std::string const& peripheral, OperationPriority priority) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    Ticket ticket;
+    ticket.peripheral = peripheral;
+    enqueue(&ticket, priority);
+
+    std::vector<std::function<void()>> started = grant();
+    if (!started.empty()) {
+        lock.unlock();
+        start_all(started);
+        lock.lock();
+    }
+    cv_.wait(lock, [&ticket] { return ticket.granted; });
+}
+
+void OperationScheduler::submit(std::string const& peripheral, OperationPriority priority,
+                                std::function<void()> start) {
+    std::vector<std::function<void()>> started;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        Ticket* ticket = new Ticket();
+        ticket->peripheral = peripheral;
+        ticket->start = std::move(start);
+        enqueue(ticket, priority);
+
+        started = grant();
+    }
+    start_all(started);
+}
+
+void OperationScheduler::release(std::string const& peripheral) {
+    std::vector<std::function<void()>> started;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_--;
+        busy_.erase(peripheral);
+        started = grant();
+    }
+    start_all(started);
+}
+
+void OperationScheduler::enqueue(Ticket* ticket, OperationPriority priority) {
+    ticket->enqueued = monotonic_timestamp_ns();
+
+    ClassState& state = classes_[static_cast<size_t>(priority)];
+    state.queues[ticket->peripheral].push_back(ticket);
+    state.queued++;
+}
+
+std::vector<std::function<void()>> OperationScheduler::grant() {
+    std::vector<std::function<void()>> started;
+    bool granted = false;
+    uint64_t now = monotonic_timestamp_ns();
+
+    while (max_concurrent_ == 0 || active_ < max_concurrent_) {
+        bool found = false;
+        for (ClassState& state : classes_) {
+            if (grant_next(state, now, started)) {
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) break;
+        granted = true;
+    }
+
+    if (granted) {
+        cv_.notify_all();
+    }
+    return started;
+}
+
+bool OperationScheduler::grant_next(ClassState& state, uint64_t now, std::vector<std::function<void()>>& started) {
+    if (state.queued == 0) return false;
+
+    // Peripherals are visited in key order, starting right after the one served last.
+    auto start = state.queues.upper_bound(state.cursor);
+    for (size_t i = 0; i < state.queues.size(); i++, start++) {
+        if (start == state.queues.end()) {
+            start = state.queues.begin();
+        }
+
+        if (busy_.count(start->first) > 0) continue;
+
+        Ticket* ticket = start->second.front();
+        start->second.pop_front();
+        if (start->second.empty()) {
+            state.queues.erase(start);
+        }
+
+        ticket->granted = true;
+        state.cursor = ticket->peripheral;
+        state.queued--;
+        state.started++;
+
+        uint64_t wait_ns = now - ticket->enqueued;
+        state.total_wait_ns += wait_ns;
+        state.max_wait_ns = std::max(state.max_wait_ns, wait_ns);
+
+        busy_.insert(ticket->peripheral);
+        active_++;
+
+        if (ticket->start) {
+            started.push_back(std::move(ticket->start));
+            delete ticket;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void OperationScheduler::start_all(std::vector<std::function<void()>>& started) {
+    for (auto& start : started) {
+        start();
+    }
+}
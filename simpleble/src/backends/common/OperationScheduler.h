@@ -0,0 +1,105 @@
+#pragma once
+
+#include <simpleble/Adapter.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Orders the GATT operations issued to the peripherals of an adapter.
+ *
+ * @details Each peripheral runs one operation at a time, and at most `max_concurrent` operations run across
+ *          all peripherals. When a slot frees up, the oldest operation of the highest priority class waiting
+ *          is started, with peripherals taking turns within a class. Operations run on the calling thread.
+ */
+class OperationScheduler {
+  public:
+    static constexpr size_t PRIORITY_COUNT = 3;
+
+    explicit OperationScheduler(size_t max_concurrent = 0);
+    virtual ~OperationScheduler();
+
+    void set_max_concurrent(size_t max_concurrent);
+
+    /**
+     * @brief Waits for the turn of the operation, then runs it and returns its result.
+     */
+    template <typename Function>
+    auto run(std::string const& peripheral, OperationPriority priority, Function&& function) -> decltype(function()) {
+        Slot slot(*this, peripheral, priority);
+        return function();
+    }
+
+    /**
+     * @brief Queues an operation without waiting for its turn.
+     *
+     * @details `start` is called once the turn comes, either right away or from the thread that frees the slot,
+     *          and must not block. The operation keeps its slot until release() is called for the peripheral.
+     */
+    void submit(std::string const& peripheral, OperationPriority priority, std::function<void()> start);
+    void release(std::string const& peripheral);
+
+    std::vector<OperationQueueStats> stats();
+
+  protected:
+    struct Ticket {
+        std::string peripheral;
+        uint64_t enqueued = 0;
+        bool granted = false;
+        // Set for submitted operations, whose ticket is owned by the scheduler until granted.
+        std::function<void()> start;
+    };
+
+    struct ClassState {
+        // Waiting operations of each peripheral, in arrival order.
+        std::map<std::string, std::deque<Ticket*>> queues;
+        // Peripheral served last, so that the next one in key order gets the following turn.
+        std::string cursor;
+        size_t queued = 0;
+        uint64_t started = 0;
+        uint64_t total_wait_ns = 0;
+        uint64_t max_wait_ns = 0;
+    };
+
+    class Slot {
+      public:
+        Slot(OperationScheduler& scheduler, std::string const& peripheral, OperationPriority priority);
+        ~Slot();
+
+        Slot(Slot const&) = delete;
+        Slot& operator=(Slot const&) = delete;
+
+      private:
+        OperationScheduler& scheduler_;
+        std::string peripheral_;
+    };
+
+    void acquire(std::string const& peripheral, OperationPriority priority);
+    void enqueue(Ticket* ticket, OperationPriority priority);
+
+    // Grants as many waiting operations as the limits allow, returning the submitted ones to be started once
+    // the mutex is released. Must be called with the mutex held.
+    std::vector<std::function<void()>> grant();
+    bool grant_next(ClassState& state, uint64_t now, std::vector<std::function<void()>>& started);
+
+    static void start_all(std::vector<std::function<void()>>& started);
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t max_concurrent_;
+    size_t active_ = 0;
+    std::set<std::string> busy_;
+    std::array<ClassState, PRIORITY_COUNT> classes_;
+};
+
+}  // namespace SimpleBLE
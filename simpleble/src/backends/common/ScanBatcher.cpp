@@ -0,0 +1,78 @@
+#include "ScanBatcher.h"
+
+using namespace SimpleBLE;
+
+ScanBatcher::ScanBatcher(Callback callback, std::chrono::milliseconds interval) : state_(std::make_shared<State>()) {
+    state_->callback = std::move(callback);
+    state_->interval = interval;
+    worker_ = std::thread(&ScanBatcher::run, state_);
+}
+
+ScanBatcher::~ScanBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stopping = true;
+    }
+    state_->cv.notify_all();
+
+    // The last reference may be dropped from within the callback itself, in which case joining would deadlock.
+    if (worker_.get_id() == std::this_thread::get_id()) {
+        worker_.detach();
+    } else {
+        worker_.join();
+    }
+}
+
+void ScanBatcher::push(uint64_t key, Peripheral peripheral, bool found, uint64_t timestamp) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+
+    auto it = state_->pending_index.find(key);
+    if (it == state_->pending_index.end()) {
+        state_->pending_index.emplace(key, state_->pending.size());
+        state_->pending.push_back(ScanEvent{peripheral, found, timestamp, 1});
+        return;
+    }
+
+    ScanEvent& event = state_->pending[it->second];
+    event.peripheral = peripheral;
+    event.found = event.found || found;
+    event.timestamp = timestamp;
+    event.count++;
+}
+
+void ScanBatcher::flush() { flush(*state_); }
+
+void ScanBatcher::flush(State& state) {
+    std::lock_guard<std::recursive_mutex> delivery_lock(state.delivery_mutex);
+
+    std::vector<ScanEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        events.swap(state.pending);
+        state.pending_index.clear();
+    }
+
+    if (events.empty()) {
+        return;
+    }
+
+    try {
+        state.callback(events);
+    } catch (...) {
+        // Exceptions thrown by user callbacks are swallowed, as for every other callback.
+    }
+}
+
+void ScanBatcher::run(std::shared_ptr<State> state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (!state->stopping) {
+        state->cv.wait_for(lock, state->interval, [&state] { return state->stopping; });
+        if (state->stopping) {
+            break;
+        }
+
+        lock.unlock();
+        flush(*state);
+        lock.lock();
+    }
+}
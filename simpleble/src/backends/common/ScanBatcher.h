@@ -0,0 +1,63 @@
+#pragma once
+
+#include <simpleble/Adapter.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Coalesces scan results per peripheral and delivers them in batches from a dedicated thread.
+ */
+class ScanBatcher {
+  public:
+    using Callback = std::function<void(std::vector<ScanEvent> const&)>;
+
+    ScanBatcher(Callback callback, std::chrono::milliseconds interval);
+    virtual ~ScanBatcher();
+
+    /**
+     * @brief Records an advertisement, replacing any pending event for the same key.
+     *
+     * @note Called from the backend thread dispatching advertisements.
+     */
+    void push(uint64_t key, Peripheral peripheral, bool found, uint64_t timestamp);
+
+    /**
+     * @brief Delivers the pending events right away, from the calling thread.
+     */
+    void flush();
+
+  protected:
+    // Shared with the worker thread, which may outlive this object if it is released from within the callback.
+    struct State {
+        Callback callback;
+        std::chrono::milliseconds interval;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<ScanEvent> pending;
+        std::unordered_map<uint64_t, size_t> pending_index;
+        bool stopping = false;
+
+        // Serializes deliveries, so that a flush never overtakes a batch being delivered. Recursive, as
+        // the scan may be stopped from within the callback.
+        std::recursive_mutex delivery_mutex;
+    };
+
+    static void run(std::shared_ptr<State> state);
+    static void flush(State& state);
+
+    std::shared_ptr<State> state_;
+    std::thread worker_;
+};
+
+}  // namespace SimpleBLE
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <simpleble/ScanFilter.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "AdapterBaseTypes.h"
+
+namespace SimpleBLE {
+
+/**
+ * @brief Payload fingerprint and RSSI of the last scan update reported to the user for a device.
+ */
+struct ScanUpdateState {
+    uint64_t fingerprint = 0;
+    int16_t rssi = 0;
+};
+
+/**
+ * @brief Precompiled form of a ScanFilter, evaluated locally against incoming advertisements.
+ *
+ * @details The source passed to `matches` must provide `name()`, `address()`, `rssi()`,
+ *          `manufacturer_data()` and `service_uuids()`. Accessors are only invoked for the
+ *          criteria that are set, cheapest first, so sources can read their fields lazily.
+ */
+class ScanFilterMatcher {
+  public:
+    ScanFilterMatcher() = default;
+    explicit ScanFilterMatcher(ScanFilter const& filter)
+        : rssi_threshold_(filter.rssi_threshold),
+          pattern_(filter.pattern),
+          name_(filter.name),
+          name_prefix_(filter.name_prefix),
+          manufacturer_id_(filter.manufacturer_id),
+          manufacturer_data_(filter.manufacturer_data),
+          manufacturer_data_mask_(filter.manufacturer_data_mask),
+          rssi_change_threshold_(filter.rssi_change_threshold) {
+        for (auto& uuid : filter.service_uuids) {
+            service_uuids_.insert(normalize_uuid(uuid));
+        }
+
+        // Pre-apply the mask to the expected payload, so that matching is a single masked comparison.
+        manufacturer_data_mask_.resize(manufacturer_data_.size(), '\xFF');
+        for (size_t i = 0; i < manufacturer_data_.size(); i++) {
+            manufacturer_data_[i] &= manufacturer_data_mask_[i];
+        }
+    }
+
+    bool empty() const {
+        return !rssi_threshold_.has_value() && pattern_.empty() && name_.empty() && name_prefix_.empty() &&
+               !manufacturer_id_.has_value() && service_uuids_.empty() && !rssi_change_threshold_.has_value();
+    }
+
+    /**
+     * @brief Decides whether a scan update is worth reporting, recording it in `state` if so.
+     *
+     * @details First sightings are always reported. RSSI is only read when the payload is unchanged.
+     */
+    template <typename RssiGetter>
+    bool accept_update(ScanUpdateState& state, bool first_seen, uint64_t fingerprint, RssiGetter&& rssi) const {
+        if (!rssi_change_threshold_.has_value()) {
+            return true;
+        }
+
+        if (!first_seen && fingerprint == state.fingerprint) {
+            int16_t current_rssi = rssi();
+            if (std::abs(current_rssi - state.rssi) < rssi_change_threshold_.value()) {
+                return false;
+            }
+            state.rssi = current_rssi;
+            return true;
+        }
+
+        state.fingerprint = fingerprint;
+        state.rssi = rssi();
+        return true;
+    }
+
+    template <typename Source>
+    bool matches(Source& source) const {
+        if (rssi_threshold_.has_value() && source.rssi() < rssi_threshold_.value()) {
+            return false;
+        }
+
+        if (!pattern_.empty() && !starts_with(source.address(), pattern_) && !starts_with(source.name(), pattern_)) {
+            return false;
+        }
+
+        if (!name_.empty() || !name_prefix_.empty()) {
+            std::string name = source.name();
+            if (!name_.empty() && name != name_) {
+                return false;
+            }
+            if (!name_prefix_.empty() && !starts_with(name, name_prefix_)) {
+                return false;
+            }
+        }
+
+        if (manufacturer_id_.has_value() && !manufacturer_matches(source.manufacturer_data())) {
+            return false;
+        }
+
+        if (!service_uuids_.empty()) {
+            auto uuids = source.service_uuids();
+            bool found = std::any_of(uuids.begin(), uuids.end(), [this](const BluetoothUUID& uuid) {
+                return service_uuids_.count(normalize_uuid(uuid)) > 0;
+            });
+            if (!found) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Converts a UUID to its lowercase 128-bit representation, expanding 16 and 32-bit UUIDs.
+     */
+    static BluetoothUUID normalize_uuid(BluetoothUUID uuid) {
+        std::transform(uuid.begin(), uuid.end(), uuid.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (uuid.size() == 4) {
+            uuid = "0000" + uuid;
+        }
+        if (uuid.size() == 8) {
+            uuid += "-0000-1000-8000-00805f9b34fb";
+        }
+        return uuid;
+    }
+
+  protected:
+    std::optional<int16_t> rssi_threshold_;
+    std::string pattern_;
+    std::string name_;
+    std::string name_prefix_;
+    std::optional<uint16_t> manufacturer_id_;
+    ByteArray manufacturer_data_;
+    ByteArray manufacturer_data_mask_;
+    std::set<BluetoothUUID> service_uuids_;
+    std::optional<uint16_t> rssi_change_threshold_;
+
+    bool manufacturer_matches(const std::map<uint16_t, ByteArray>& manufacturer_data) const {
+        auto entry = manufacturer_data.find(manufacturer_id_.value());
+        if (entry == manufacturer_data.end()) {
+            return false;
+        }
+
+        const ByteArray& payload = entry->second;
+        if (payload.size() < manufacturer_data_.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < manufacturer_data_.size(); i++) {
+            if ((payload[i] & manufacturer_data_mask_[i]) != manufacturer_data_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool starts_with(const std::string& value, const std::string& prefix) {
+        return value.compare(0, prefix.size(), prefix) == 0;
+    }
+};
+
+/**
+ * @brief ScanFilterMatcher source for backends that receive a decoded advertising_data_t.
+ */
+struct AdvertisingDataScanSource {
+    const advertising_data_t& data;
+
+    std::string name() const { return data.identifier; }
+    BluetoothAddress address() const { return data.mac_address; }
+    int16_t rssi() const { return data.rssi; }
+    const std::map<uint16_t, ByteArray>& manufacturer_data() const { return data.manufacturer_data; }
+    std::vector<BluetoothUUID> service_uuids() const {
+        std::vector<BluetoothUUID> uuids = data.service_uuids;
+        for (auto& [uuid, payload] : data.service_data) {
+            uuids.push_back(uuid);
+        }
+        return uuids;
+    }
+
+    uint64_t fingerprint() const {
+        uint64_t hash = std::hash<std::string>{}(data.identifier);
+        auto fold = [&hash](size_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+        for (auto& [manufacturer_id, payload] : data.manufacturer_data) {
+            fold(manufacturer_id);
+            fold(std::hash<std::string>{}(payload));
+        }
+        for (auto& [uuid, payload] : data.service_data) {
+            fold(std::hash<std::string>{}(uuid));
+            fold(std::hash<std::string>{}(payload));
+        }
+        for (auto& uuid : data.service_uuids) {
+            fold(std::hash<std::string>{}(uuid));
+        }
+        return hash;
+    }
+};
+
+}  // namespace SimpleBLE
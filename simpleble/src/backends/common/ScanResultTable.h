@@ -0,0 +1,359 @@
+#pragma once
+
+#include <simpleble/Types.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Concurrent table of the devices known to an adapter, and of those seen during the current scan.
+ *
+ * @details Entries are spread over independently locked shards keyed by the packed 48-bit address, so
+ *          advertisements for different devices do not contend with each other. Whether an entry was seen
+ *          during the current scan is recorded on the entry itself. The scan generation is guarded by every
+ *          shard lock, which clear_seen() takes at once.
+ *
+ *          First sightings are also appended to an append-only log published with atomic stores, so seen()
+ *          reads the current scan without taking any lock. The log grows by doubling, which keeps an append
+ *          at amortized constant cost, and is replaced at every new scan.
+ *
+ *          Every change is stamped with a version, so that consumers can ask for what changed since the
+ *          version they last observed instead of copying the whole list. Versions are epochs advanced by
+ *          the consumers: advertisements only read the current epoch, so they never write to memory
+ *          shared with other shards.
+ */
+template <typename T>
+class ScanResultTable {
+  public:
+    using Key = uint64_t;
+    using Snapshot = std::vector<std::shared_ptr<T>>;
+
+    struct Changes {
+        uint64_t version = 0;
+        // Set when the requested version can no longer be served incrementally, in which case
+        // `added` holds every device seen during the current scan.
+        bool reset = false;
+        Snapshot added;
+        Snapshot updated;
+        Snapshot lost;
+    };
+
+    /**
+     * @brief Packs a "XX:XX:XX:XX:XX:XX" address into an integer. Other formats fall back to a string hash.
+     */
+    static Key make_key(BluetoothAddress const& address) {
+        Key key = 0;
+        int digits = 0;
+        for (char c : address) {
+            int nibble;
+            if (c >= '0' && c <= '9') {
+                nibble = c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                nibble = c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                nibble = c - 'A' + 10;
+            } else if (c == ':' || c == '-') {
+                continue;
+            } else {
+                digits = -1;
+                break;
+            }
+            key = (key << 4) | static_cast<Key>(nibble);
+            digits++;
+        }
+
+        if (digits != 12) {
+            // Setting the top bit keeps hashed keys apart from packed 48-bit addresses.
+            return std::hash<BluetoothAddress>{}(address) | (Key(1) << 63);
+        }
+        return key;
+    }
+
+    /**
+     * @brief Looks up an entry, creating it with `factory` if needed, and marks it as seen during the current scan.
+     *
+     * @details Later sightings are not reported as updates until mark_updated() is called.
+     *
+     * @return The entry, and whether this is the first time it has been seen during the current scan.
+     */
+    template <typename Factory>
+    std::pair<std::shared_ptr<T>, bool> upsert(Key key, Factory&& factory) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            it = shard.entries.emplace(key, Entry{factory(), 0, 0, 0, 0}).first;
+        }
+
+        Entry& entry = it->second;
+        if (entry.seen_generation == generation_) {
+            return {entry.value, false};
+        }
+
+        entry.seen_generation = generation_;
+        entry.seen_order = ++seen_order_;
+        entry.added_version = entry.changed_version = stamp();
+        entry.seen_record = std::make_shared<SeenRecord>(entry.value);
+        seen_append(entry.seen_record);
+        return {entry.value, true};
+    }
+
+    /**
+     * @brief Reports an entry seen during the current scan as updated, once the update was deemed worth reporting.
+     */
+    void mark_updated(Key key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end() && it->second.seen_generation == generation_) {
+            it->second.changed_version = stamp();
+        }
+    }
+
+    /**
+     * @brief Drops an entry, reporting it as lost if it had been seen during the current scan.
+     */
+    void remove(Key key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            return;
+        }
+
+        Entry entry = it->second;
+        shard.entries.erase(it);
+        if (entry.seen_generation != generation_) {
+            return;
+        }
+        entry.seen_record->lost.store(true, std::memory_order_relaxed);
+
+        // Shard lock before history lock, never the other way around.
+        std::lock_guard<std::mutex> lost_lock(lost_mutex_);
+        lost_.push_back(LostEntry{entry.value, entry.seen_order, entry.added_version, stamp()});
+        if (lost_.size() > LOST_HISTORY_CAPACITY) {
+            // Consumers older than the forgotten entry can no longer be served incrementally.
+            horizon_.store(lost_.front().lost_version, std::memory_order_release);
+            lost_.pop_front();
+        }
+    }
+
+    /**
+     * @brief Forgets which entries have been seen, as done at the start of every scan. Entries are kept.
+     */
+    void clear_seen() {
+        // Holding every shard lock lets no upsert observe the old generation once the new one is set.
+        std::array<std::unique_lock<std::mutex>, SHARD_COUNT> locks;
+        for (size_t i = 0; i < SHARD_COUNT; i++) {
+            locks[i] = std::unique_lock<std::mutex>(shards_[i].mutex);
+        }
+
+        generation_++;
+        {
+            std::lock_guard<std::mutex> log_lock(seen_log_mutex_);
+            std::atomic_store(&seen_log_, std::make_shared<SeenLog>(0));
+        }
+
+        std::lock_guard<std::mutex> lost_lock(lost_mutex_);
+        lost_.clear();
+        horizon_.store(epoch_.fetch_add(1) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns the number of entries held, whether or not they were seen during the current scan.
+     */
+    size_t size() {
+        size_t count = 0;
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            count += shard.entries.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Returns the entries seen during the current scan, in order of discovery.
+     */
+    Snapshot seen() const {
+        std::shared_ptr<SeenLog> log = std::atomic_load(&seen_log_);
+        size_t count = log->count.load(std::memory_order_acquire);
+
+        Snapshot snapshot;
+        snapshot.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            if (!log->records[i]->lost.load(std::memory_order_relaxed)) {
+                snapshot.push_back(log->records[i]->value);
+            }
+        }
+        return snapshot;
+    }
+
+    /**
+     * @brief Returns the entries added, updated or lost after `since_version`, along with the version to pass next.
+     *
+     * @note Each change is reported once. Changes made while the call is in progress are left for the next one.
+     */
+    Changes changes(uint64_t since_version) {
+        Changes changes;
+
+        uint64_t horizon = horizon_.load(std::memory_order_acquire);
+        // Closes the current epoch: whatever is stamped from now on is left for the next call.
+        changes.version = epoch_.fetch_add(1);
+        changes.reset = since_version < horizon || since_version > changes.version;
+        if (changes.reset) {
+            since_version = 0;
+        }
+
+        // A change is stamped under its shard lock. One stamped with the closed epoch was thus applied
+        // before the shard is visited below, while one applied afterwards carries a later epoch.
+        auto in_range = [&](uint64_t version) { return version > since_version && version <= changes.version; };
+        std::vector<std::pair<uint64_t, std::shared_ptr<T>>> added;
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto& [key, entry] : shard.entries) {
+                if (entry.seen_generation != generation_) {
+                    continue;
+                }
+                if (in_range(entry.added_version)) {
+                    added.emplace_back(entry.seen_order, entry.value);
+                } else if (entry.added_version <= since_version && in_range(entry.changed_version)) {
+                    changes.updated.push_back(entry.value);
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lost_lock(lost_mutex_);
+            for (auto& lost : lost_) {
+                if (lost.lost_version <= changes.version) {
+                    // Entries that came and went since the last call were never reported to the consumer.
+                    if (!changes.reset && lost.lost_version > since_version && lost.added_version <= since_version) {
+                        changes.lost.push_back(lost.value);
+                    }
+                } else if (in_range(lost.added_version)) {
+                    // Lost after the epoch was closed, so it will be reported as such by the next call.
+                    added.emplace_back(lost.seen_order, lost.value);
+                }
+            }
+        }
+
+        // Report new entries in order of discovery, once even if they were removed during the walk.
+        std::sort(added.begin(), added.end());
+        added.erase(std::unique(added.begin(), added.end()), added.end());
+        for (auto& [order, value] : added) {
+            changes.added.push_back(value);
+        }
+
+        // If the scan was restarted meanwhile, make sure the next call starts over.
+        uint64_t current_horizon = horizon_.load(std::memory_order_acquire);
+        if (current_horizon != horizon) {
+            changes.version = std::min(changes.version, current_horizon - 1);
+        }
+
+        return changes;
+    }
+
+  private:
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t LOST_HISTORY_CAPACITY = 1024;
+
+    // Appearance of an entry in the seen log, flagged once the entry is removed.
+    struct SeenRecord {
+        explicit SeenRecord(std::shared_ptr<T> value) : value(std::move(value)) {}
+
+        std::shared_ptr<T> value;
+        std::atomic_bool lost{false};
+    };
+
+    // Records past `count` are only written by the appending thread, those before it are never written again.
+    struct SeenLog {
+        explicit SeenLog(size_t capacity) : records(capacity) {}
+
+        std::vector<std::shared_ptr<SeenRecord>> records;
+        std::atomic_size_t count{0};
+    };
+
+    struct Entry {
+        std::shared_ptr<T> value;
+        uint64_t seen_generation;
+        // Rank among the entries seen during the current scan, which only grows on first sightings.
+        uint64_t seen_order;
+        uint64_t added_version;
+        uint64_t changed_version;
+        // Set while the entry is seen during the current scan.
+        std::shared_ptr<SeenRecord> seen_record;
+    };
+
+    struct LostEntry {
+        std::shared_ptr<T> value;
+        uint64_t seen_order;
+        uint64_t added_version;
+        uint64_t lost_version;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<Key, Entry> entries;
+    };
+
+    // Only ever called with a shard lock held, which orders it against the epoch being closed.
+    uint64_t stamp() const { return epoch_.load(std::memory_order_relaxed); }
+
+    // Called with the shard lock of the entry held, shard lock before log lock.
+    void seen_append(std::shared_ptr<SeenRecord> record) {
+        std::lock_guard<std::mutex> log_lock(seen_log_mutex_);
+
+        // The log is only replaced with the lock held, so it can be read without an atomic load.
+        std::shared_ptr<SeenLog> log = seen_log_;
+        size_t count = log->count.load(std::memory_order_relaxed);
+        if (count == log->records.size()) {
+            auto grown = std::make_shared<SeenLog>(std::max<size_t>(2 * count, 64));
+            std::copy(log->records.begin(), log->records.end(), grown->records.begin());
+            grown->count.store(count, std::memory_order_relaxed);
+            std::atomic_store(&seen_log_, grown);
+            log = std::move(grown);
+        }
+
+        log->records[count] = std::move(record);
+        log->count.store(count + 1, std::memory_order_release);
+    }
+
+    Shard& shard_for(Key key) {
+        // The low bits of a packed address are the least vendor-specific ones.
+        return shards_[(key ^ (key >> 32)) % SHARD_COUNT];
+    }
+
+    std::array<Shard, SHARD_COUNT> shards_;
+
+    // Generation 0 is never current, so that new entries start out unseen. Written with every shard
+    // lock held, read with any of them.
+    uint64_t generation_ = 1;
+    std::atomic_uint64_t seen_order_{0};
+    // Version given to changes until the next call to changes(). Starts above 0, which asks for everything.
+    std::atomic_uint64_t epoch_{1};
+    // Oldest version from which changes can still be computed incrementally.
+    std::atomic_uint64_t horizon_{0};
+
+    std::mutex lost_mutex_;
+    std::deque<LostEntry> lost_;
+
+    // Replaced with atomic stores, as readers load it without any lock.
+    std::mutex seen_log_mutex_;
+    std::shared_ptr<SeenLog> seen_log_ = std::make_shared<SeenLog>(0);
+};
+
+}  // namespace SimpleBLE
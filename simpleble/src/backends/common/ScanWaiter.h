@@ -0,0 +1,110 @@
+#pragma once
+
+#include <simpleble/Peripheral.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Rendezvous between a `scan_until` call and the thread dispatching advertisements.
+ *
+ * @details Backends offer every peripheral they are about to report to the active waiter, if any.
+ *          The first peripheral accepted by the predicate is latched and the waiting thread is woken
+ *          up right away, or the settled callback is called; later offers are ignored.
+ */
+class ScanWaiter {
+  public:
+    explicit ScanWaiter(std::function<bool(Peripheral)> predicate) : predicate_(std::move(predicate)) {}
+
+    /**
+     * @brief Evaluates the predicate against a peripheral. Returns true if it was accepted.
+     */
+    bool offer(Peripheral peripheral) {
+        std::function<void(std::optional<Peripheral>)> on_settled;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (match_.has_value() || expired_) {
+                return false;
+            }
+
+            bool accepted = false;
+            try {
+                accepted = predicate_ ? predicate_(peripheral) : true;
+            } catch (...) {
+                // A throwing predicate is treated as a rejection, as would be the case for any other callback.
+            }
+
+            if (!accepted) {
+                return false;
+            }
+
+            match_ = peripheral;
+            on_settled = std::move(on_settled_);
+            cv_.notify_all();
+        }
+
+        if (on_settled) {
+            on_settled(peripheral);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Calls `callback` once, with the accepted peripheral, or std::nullopt if expire() is called first.
+     *
+     * @note Must be set before the waiter is published. The callback runs on the thread that settled the waiter.
+     */
+    void on_settled(std::function<void(std::optional<Peripheral>)> callback) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        on_settled_ = std::move(callback);
+    }
+
+    /**
+     * @brief Stops accepting peripherals, settling the waiter without a match unless one was already accepted.
+     */
+    void expire() {
+        std::function<void(std::optional<Peripheral>)> on_settled;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (match_.has_value() || expired_) {
+                return;
+            }
+            expired_ = true;
+            on_settled = std::move(on_settled_);
+            cv_.notify_all();
+        }
+
+        if (on_settled) {
+            on_settled(std::nullopt);
+        }
+    }
+
+    /**
+     * @brief Blocks until a peripheral has been accepted or the timeout expires. A negative timeout waits forever.
+     */
+    std::optional<Peripheral> wait(int timeout_ms) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto ready = [this] { return match_.has_value() || expired_; };
+        if (timeout_ms < 0) {
+            cv_.wait(lock, ready);
+        } else {
+            cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+        }
+        return match_;
+    }
+
+  private:
+    std::function<bool(Peripheral)> predicate_;
+    std::optional<Peripheral> match_;
+    bool expired_ = false;
+    std::function<void(std::optional<Peripheral>)> on_settled_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+}  // namespace SimpleBLE
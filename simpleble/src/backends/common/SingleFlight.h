@@ -0,0 +1,63 @@
+#pragma once
+
+#include <exception>
+#include <future>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Collapses concurrent calls for the same key into a single execution.
+ *
+ * @details The first caller for a key runs the function while any caller arriving before it completes
+ *          waits for, and receives, the same result or exception. Callers arriving afterwards start a
+ *          new execution.
+ */
+template <typename Key, typename Value>
+class SingleFlight {
+  public:
+    template <typename Function>
+    Value run(Key const& key, Function&& function) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        auto in_flight = in_flight_.find(key);
+        if (in_flight != in_flight_.end()) {
+            std::shared_future<Value> future = in_flight->second;
+            lock.unlock();
+            return future.get();
+        }
+
+        std::promise<Value> promise;
+        std::shared_future<Value> future = promise.get_future().share();
+        in_flight_.emplace(key, future);
+        lock.unlock();
+
+        std::exception_ptr exception;
+        Value value{};
+        try {
+            value = function();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        // The call is retired before its result is published, so that nobody joins a completed call.
+        lock.lock();
+        in_flight_.erase(key);
+        lock.unlock();
+
+        if (exception) {
+            promise.set_exception(exception);
+        } else {
+            promise.set_value(std::move(value));
+        }
+        return future.get();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::map<Key, std::shared_future<Value>> in_flight_;
+};
+
+}  // namespace SimpleBLE
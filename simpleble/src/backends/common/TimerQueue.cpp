@@ -0,0 +1,71 @@
+#include "TimerQueue.h"
+
+#include "CommonUtils.h"
+#include "LoggingInternal.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace SimpleBLE;
+
+TimerQueue::TimerQueue(size_t threads) {
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); i++) {
+        threads_.emplace_back(&TimerQueue::run, this);
+    }
+}
+
+TimerQueue::~TimerQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+TimerQueue& TimerQueue::shared() {
+    static TimerQueue instance;
+    return instance;
+}
+
+void TimerQueue::schedule(int delay_ms, std::function<void()> task) {
+    uint64_t due = monotonic_timestamp_ns() + static_cast<uint64_t>(std::max(delay_ms, 0)) * 1000000;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace(due, std::move(task));
+    }
+    cv_.notify_all();
+}
+
+void TimerQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        if (tasks_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+
+        uint64_t now = monotonic_timestamp_ns();
+        auto next = tasks_.begin();
+        if (next->first > now) {
+            cv_.wait_for(lock, std::chrono::nanoseconds(next->first - now));
+            continue;
+        }
+
+        std::function<void()> task = std::move(next->second);
+        tasks_.erase(next);
+
+        lock.unlock();
+        try {
+            task();
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_ERROR(fmt::format("Exception in deferred task: {}", e.what()));
+        } catch (...) {
+            SIMPLEBLE_LOG_ERROR("Unknown exception in deferred task");
+        }
+        lock.lock();
+    }
+}
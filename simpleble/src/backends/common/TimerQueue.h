@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Runs deferred tasks from a fixed set of threads, so that timeouts do not each need a waiting thread.
+ */
+class TimerQueue {
+  public:
+    explicit TimerQueue(size_t threads = 1);
+    virtual ~TimerQueue();
+
+    TimerQueue(TimerQueue const&) = delete;
+    TimerQueue& operator=(TimerQueue const&) = delete;
+
+    /**
+     * @brief Process-wide queue, shared by all backend objects.
+     */
+    static TimerQueue& shared();
+
+    /**
+     * @brief Runs `task` once `delay_ms` milliseconds have elapsed. Tasks due at the same time run in the order
+     *        they were scheduled.
+     *
+     * @note Tasks run on one of the queue's threads and should not block, as they delay the ones behind them.
+     */
+    void schedule(int delay_ms, std::function<void()> task);
+
+  protected:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    // Tasks keyed by due time, in nanoseconds on std::chrono::steady_clock.
+    std::multimap<uint64_t, std::function<void()>> tasks_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace SimpleBLE
@@ -1,16 +1,77 @@
 #include "AdapterBase.h"
 #include "Bluez.h"
 #include "CommonUtils.h"
+#include "LoggingInternal.h"
 #include "PeripheralBase.h"
 #include "PeripheralBuilder.h"
+#include "TimerQueue.h"
+
+#include <map>
+#include <mutex>
 
 using namespace SimpleBLE;
 
+static SimpleBluez::Adapter::DiscoveryFilter to_discovery_filter(ScanFilter const& filter) {
+    SimpleBluez::Adapter::DiscoveryFilter discovery_filter;
+    discovery_filter.UUIDs = filter.service_uuids;
+    discovery_filter.RSSI = filter.rssi_threshold;
+    discovery_filter.Pathloss = filter.pathloss_threshold;
+    discovery_filter.DuplicateData = filter.duplicate_data;
+    discovery_filter.Pattern = filter.pattern;
+
+    switch (filter.transport) {
+        case ScanFilter::Transport::AUTO:
+            discovery_filter.Transport = SimpleBluez::Adapter::DiscoveryFilter::TransportType::AUTO;
+            break;
+        case ScanFilter::Transport::BREDR:
+            discovery_filter.Transport = SimpleBluez::Adapter::DiscoveryFilter::TransportType::BREDR;
+            break;
+        case ScanFilter::Transport::LE:
+            discovery_filter.Transport = SimpleBluez::Adapter::DiscoveryFilter::TransportType::LE;
+            break;
+    }
+
+    return discovery_filter;
+}
+
+/**
+ * @brief ScanFilterMatcher source reading the locally cached Device1 properties, without any D-Bus round trip.
+ */
+struct DeviceScanSource {
+    SimpleBluez::Device& device;
+    BluetoothAddress const& device_address;
+
+    std::string name() { return device.name(); }
+    BluetoothAddress address() { return device_address; }
+    int16_t rssi() { return device.rssi(); }
+    std::vector<BluetoothUUID> service_uuids() { return device.uuids(); }
+    std::map<uint16_t, ByteArray> manufacturer_data() {
+        std::map<uint16_t, ByteArray> manufacturer_data;
+        for (auto& [manufacturer_id, value_array] : device.manufacturer_data(false)) {
+            manufacturer_data[manufacturer_id] = ByteArray((const char*)value_array.data(), value_array.size());
+        }
+        return manufacturer_data;
+    }
+};
+
+// The callbacks of a SimpleBluez adapter hold a single handler each, so only one AdapterBase may exist per adapter
+// at any time. Listing the adapters again hands out the objects that are still alive.
+static std::mutex adapter_registry_mutex;
+static std::map<SimpleBluez::Adapter*, std::weak_ptr<AdapterBase>> adapter_registry;
+
 std::vector<std::shared_ptr<AdapterBase>> AdapterBase::get_adapters() {
     std::vector<std::shared_ptr<AdapterBase>> adapter_list;
     auto internal_adapters = Bluez::get()->bluez.get_adapters();
+
+    std::lock_guard<std::mutex> lock(adapter_registry_mutex);
     for (auto& adapter : internal_adapters) {
-        adapter_list.push_back(std::make_shared<AdapterBase>(adapter));
+        auto& entry = adapter_registry[adapter.get()];
+        std::shared_ptr<AdapterBase> adapter_base = entry.lock();
+        if (!adapter_base) {
+            adapter_base = std::make_shared<AdapterBase>(adapter);
+            entry = adapter_base;
+        }
+        adapter_list.push_back(adapter_base);
     }
     return adapter_list;
 }
@@ -29,9 +90,50 @@ bool AdapterBase::bluetooth_enabled() {
     return enabled;
 }
 
-AdapterBase::AdapterBase(std::shared_ptr<SimpleBluez::Adapter> adapter) : adapter_(adapter) {}
+bool AdapterBase::use_external_event_loop() { return Bluez::use_external_event_loop(); }
+
+int AdapterBase::event_fd() { return Bluez::get()->event_fd(); }
+
+void AdapterBase::process_events() { Bluez::get()->process_events(); }
+
+bool AdapterBase::use_dedicated_connections(size_t count) { return Bluez::use_dedicated_connections(count); }
+
+AdapterBase::AdapterBase(std::shared_ptr<SimpleBluez::Adapter> adapter)
+    : adapter_(adapter), operation_scheduler_(std::make_shared<OperationScheduler>()) {
+    install_device_callbacks();
+}
 
-AdapterBase::~AdapterBase() { adapter_->clear_on_device_updated(); }
+AdapterBase::~AdapterBase() {
+    std::shared_ptr<AdapterBase> replacement;
+    {
+        // The handlers refer to this object, so they are always removed. A replacement may already have been
+        // created once this object could no longer be handed out, in which case it installs its own again.
+        std::lock_guard<std::mutex> lock(adapter_registry_mutex);
+        adapter_->clear_on_device_updated();
+        adapter_->clear_on_device_removed();
+
+        auto it = adapter_registry.find(adapter_.get());
+        if (it != adapter_registry.end()) {
+            replacement = it->second.lock();
+            if (replacement) {
+                replacement->install_device_callbacks();
+            } else {
+                adapter_registry.erase(it);
+            }
+        }
+    }
+    // Released outside the lock, as this might be the last reference to the replacement.
+    replacement.reset();
+
+    {
+        std::lock_guard<std::mutex> lock(device_cache_mutex_);
+        device_cache_stopping_ = true;
+    }
+    device_cache_cv_.notify_all();
+    if (device_cache_worker_.joinable()) {
+        device_cache_worker_.join();
+    }
+}
 
 void* AdapterBase::underlying() const { return adapter_.get(); }
 
@@ -39,35 +141,78 @@ std::string AdapterBase::identifier() { return adapter_->identifier(); }
 
 BluetoothAddress AdapterBase::address() { return adapter_->address(); }
 
-void AdapterBase::scan_start() {
-    seen_peripherals_.clear();
+void AdapterBase::install_device_callbacks() {
+    // BlueZ drops devices it has not heard from in a while, which is reported as a lost scan result.
+    adapter_->set_on_device_removed([this](std::shared_ptr<SimpleBluez::Device> device) {
+        this->peripherals_.remove(ScanResultTable<PeripheralBase>::make_key(device->address()));
+    });
 
-    adapter_->set_on_device_updated([this](std::shared_ptr<SimpleBluez::Device> device) {
+    adapter_->set_on_device_updated([this](std::shared_ptr<SimpleBluez::Device> device, uint64_t timestamp) {
         if (!this->is_scanning_) {
             return;
         }
 
-        if (this->peripherals_.count(device->address()) == 0) {
-            // If the incoming peripheral has never been seen before, create and save a reference to it.
-            auto base_peripheral = std::make_shared<PeripheralBase>(device, this->adapter_);
-            this->peripherals_.insert(std::make_pair(device->address(), base_peripheral));
+        // The address getter takes the property lock, so it is only fetched once per event.
+        BluetoothAddress address = device->address();
+
+        // Discard non-matching devices before any lookup, allocation or callback takes place.
+        auto matcher = std::atomic_load(&this->scan_filter_matcher_);
+        DeviceScanSource source{*device, address};
+        if (matcher && !matcher->matches(source)) {
+            return;
         }
 
-        // Update the received advertising data.
-        auto base_peripheral = this->peripherals_.at(device->address());
+        // Fetch the peripheral, creating it if it has never been seen before, and find out whether
+        // it is new to this scan to forward the correct call to the user.
+        auto key = ScanResultTable<PeripheralBase>::make_key(address);
+        auto [base_peripheral, first_seen] = this->peripherals_.upsert(
+            key,
+            [&]() { return std::make_shared<PeripheralBase>(device, this->adapter_, this->operation_scheduler_); });
+
+        // Drop updates that carry nothing new before any user-facing object is built.
+        if (matcher && !matcher->accept_update(base_peripheral->scan_update_state(), first_seen,
+                                               device->payload_fingerprint(), [&]() { return device->rssi(); })) {
+            return;
+        }
+        if (!first_seen) {
+            this->peripherals_.mark_updated(key);
+        }
 
         // Convert the base object into an external-facing Peripheral object
         PeripheralBuilder peripheral_builder(base_peripheral);
 
-        // Check if the device has been seen before, to forward the correct call to the user.
-        if (this->seen_peripherals_.count(device->address()) == 0) {
-            // Store it in our table of seen peripherals
-            this->seen_peripherals_.insert(std::make_pair(device->address(), base_peripheral));
-            SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder);
+        // Hand the peripheral to a pending scan_until call before anything else is reported.
+        auto waiter = std::atomic_load(&this->scan_waiter_);
+        if (waiter) {
+            waiter->offer(peripheral_builder);
+        }
+
+        if (first_seen) {
+            SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder, timestamp);
         } else {
-            SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder);
+            SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder, timestamp);
+        }
+
+        auto batcher = std::atomic_load(&this->scan_batcher_);
+        if (batcher) {
+            batcher->push(key, peripheral_builder, first_seen, timestamp);
         }
     });
+}
+
+void AdapterBase::scan_start() {
+    peripherals_.clear_seen();
+
+    // Let bluetoothd discard non-matching devices before they are signalled to us. Once a filter
+    // has been set, it is always pushed so that clearing it also resets the BlueZ side.
+    std::optional<ScanFilter> scan_filter;
+    {
+        std::lock_guard<std::mutex> lock(scan_filter_mutex_);
+        scan_filter = scan_filter_;
+    }
+    if (scan_filter.has_value()) {
+        adapter_->discovery_filter(to_discovery_filter(scan_filter.value()));
+    }
 
     // Start scanning and notify the user.
     adapter_->discovery_start();
@@ -78,6 +223,13 @@ void AdapterBase::scan_start() {
 void AdapterBase::scan_stop() {
     adapter_->discovery_stop();
     is_scanning_ = false;
+
+    // Deliver what is left of the current batch right away.
+    auto batcher = std::atomic_load(&this->scan_batcher_);
+    if (batcher) {
+        batcher->flush();
+    }
+
     SAFE_CALLBACK_CALL(this->callback_on_scan_stop_);
 
     // Important: Bluez might continue scanning if another process is also requesting
@@ -91,23 +243,144 @@ void AdapterBase::scan_for(int timeout_ms) {
     scan_stop();
 }
 
+std::optional<Peripheral> AdapterBase::scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    std::atomic_store(&scan_waiter_, waiter);
+
+    // A scan started by the user is joined and left running.
+    bool owns_scan = !scan_is_active();
+    if (owns_scan) {
+        scan_start();
+    }
+    auto match = waiter->wait(timeout_ms);
+
+    // Stop as soon as the waiter returns, so that no time is spent scanning past the first match.
+    std::atomic_store(&scan_waiter_, std::shared_ptr<ScanWaiter>());
+    if (owns_scan) {
+        scan_stop();
+    }
+
+    return match;
+}
+
+void AdapterBase::scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                                   std::function<void(std::optional<Peripheral>)> on_complete) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    bool owns_scan = !scan_is_active();
+
+    // The waiter settles on the thread dispatching advertisements, so the scan is stopped from the timer thread.
+    // The adapter may be gone by then, in which case there is no scan left to stop.
+    std::weak_ptr<AdapterBase> weak_this = weak_from_this();
+    waiter->on_settled([weak_this, waiter, owns_scan, on_complete](std::optional<Peripheral> match) {
+        TimerQueue::shared().schedule(0, [weak_this, waiter, owns_scan, on_complete, match]() {
+            if (auto self = weak_this.lock()) {
+                std::shared_ptr<ScanWaiter> expected = waiter;
+                bool current = std::atomic_compare_exchange_strong(&self->scan_waiter_, &expected,
+                                                                   std::shared_ptr<ScanWaiter>());
+                if (current && owns_scan) {
+                    try {
+                        self->scan_stop();
+                    } catch (...) {
+                        // Failing to stop the scan does not change the outcome of the search.
+                    }
+                }
+            }
+            on_complete(match);
+        });
+    });
+    std::atomic_store(&scan_waiter_, waiter);
+
+    if (owns_scan) {
+        scan_start();
+    }
+
+    if (timeout_ms >= 0) {
+        TimerQueue::shared().schedule(timeout_ms, [waiter]() { waiter->expire(); });
+    }
+}
+
 bool AdapterBase::scan_is_active() { return is_scanning_ && adapter_->discovering(); }
 
 std::vector<Peripheral> AdapterBase::scan_get_results() {
     std::vector<Peripheral> peripherals;
-    for (auto& [address, peripheral] : this->seen_peripherals_) {
+    for (auto& peripheral : peripherals_.seen()) {
         PeripheralBuilder peripheral_builder(peripheral);
         peripherals.push_back(peripheral_builder);
     }
     return peripherals;
 }
 
+ScanChanges AdapterBase::scan_get_changes(uint64_t since_version) {
+    auto table_changes = peripherals_.changes(since_version);
+
+    ScanChanges changes;
+    changes.version = table_changes.version;
+    changes.reset = table_changes.reset;
+    for (auto& peripheral : table_changes.added) {
+        changes.added.push_back(PeripheralBuilder(peripheral));
+    }
+    for (auto& peripheral : table_changes.updated) {
+        changes.updated.push_back(PeripheralBuilder(peripheral));
+    }
+    for (auto& peripheral : table_changes.lost) {
+        changes.lost.push_back(PeripheralBuilder(peripheral));
+    }
+    return changes;
+}
+
+void AdapterBase::set_scan_filter(ScanFilter const& filter) {
+    // BlueZ rejects the whole discovery filter when both are set, which would only surface at the next scan.
+    if (filter.rssi_threshold.has_value() && filter.pathloss_threshold.has_value()) {
+        throw Exception::OperationFailed("RSSI and pathloss thresholds cannot be combined");
+    }
+
+    auto matcher = std::make_shared<const ScanFilterMatcher>(filter);
+    std::lock_guard<std::mutex> lock(scan_filter_mutex_);
+    scan_filter_ = filter;
+    std::atomic_store(&scan_filter_matcher_, std::move(matcher));
+}
+
+void AdapterBase::set_device_cache_limits(DeviceCacheLimits const& limits) {
+    std::thread stopped_worker;
+    {
+        std::lock_guard<std::mutex> lock(device_cache_mutex_);
+        device_cache_limits_ = limits;
+        if (!device_cache_running_ && device_cache_limits_enabled(limits)) {
+            // A worker that stopped when the limits were last disabled may still be on its way out.
+            stopped_worker = std::move(device_cache_worker_);
+            device_cache_running_ = true;
+            device_cache_worker_ = std::thread(&AdapterBase::device_cache_run, this);
+        }
+    }
+
+    // Apply the new limits right away rather than at the next sweep, or let the worker stop if they are disabled.
+    device_cache_cv_.notify_all();
+
+    if (stopped_worker.joinable()) {
+        stopped_worker.join();
+    }
+}
+
+DeviceCacheStats AdapterBase::device_cache_stats() {
+    DeviceCacheStats stats;
+    stats.cached_devices = adapter_->device_count();
+    stats.evicted_devices = evicted_devices_;
+    return stats;
+}
+
+void AdapterBase::set_operation_concurrency(size_t max_concurrent) {
+    operation_scheduler_->set_max_concurrent(max_concurrent);
+}
+
+std::vector<OperationQueueStats> AdapterBase::operation_queue_stats() { return operation_scheduler_->stats(); }
+
 std::vector<Peripheral> AdapterBase::get_paired_peripherals() {
     std::vector<Peripheral> peripherals;
 
     auto paired_list = adapter_->device_paired_get();
     for (auto& device : paired_list) {
-        PeripheralBuilder peripheral_builder(std::make_shared<PeripheralBase>(device, this->adapter_));
+        auto base_peripheral = std::make_shared<PeripheralBase>(device, this->adapter_, this->operation_scheduler_);
+        PeripheralBuilder peripheral_builder(base_peripheral);
         peripherals.push_back(peripheral_builder);
     }
 
@@ -130,7 +403,7 @@ void AdapterBase::set_callback_on_scan_stop(std::function<void()> on_scan_stop)
     }
 }
 
-void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated) {
+void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t)> on_scan_updated) {
     if (on_scan_updated) {
         callback_on_scan_updated_.load(std::move(on_scan_updated));
     } else {
@@ -138,10 +411,73 @@ void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral)> o
     }
 }
 
-void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found) {
+void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral, uint64_t)> on_scan_found) {
     if (on_scan_found) {
         callback_on_scan_found_.load(std::move(on_scan_found));
     } else {
         callback_on_scan_found_.unload();
     }
 }
+
+void AdapterBase::set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const&)> on_scan_batch,
+                                             int interval_ms) {
+    std::shared_ptr<ScanBatcher> batcher;
+    if (on_scan_batch) {
+        batcher = std::make_shared<ScanBatcher>(std::move(on_scan_batch), std::chrono::milliseconds(interval_ms));
+    }
+
+    // Any previous batcher is stopped once the last advertisement being dispatched to it is done.
+    std::atomic_store(&scan_batcher_, batcher);
+}
+
+void AdapterBase::device_cache_run() {
+    std::unique_lock<std::mutex> lock(device_cache_mutex_);
+    device_cache_load_times_ = DeviceLoadTimes();
+    while (!device_cache_stopping_) {
+        DeviceCacheLimits limits = device_cache_limits_;
+        if (!device_cache_limits_enabled(limits)) {
+            break;
+        }
+
+        lock.unlock();
+        SAFE_RUN({ device_cache_sweep(limits); });
+        lock.lock();
+
+        device_cache_cv_.wait_for(lock, std::chrono::seconds(1));
+    }
+    device_cache_running_ = false;
+}
+
+void AdapterBase::device_cache_sweep(DeviceCacheLimits const& limits) {
+    uint64_t now = monotonic_timestamp_ns();
+    std::vector<SimpleBluez::Adapter::DeviceInfo> candidates;
+    std::vector<uint64_t> last_seen;
+    // The cached properties are kept up to date by BlueZ signals, so no round trip is needed here. Deferred
+    // devices are left deferred, as creating a proxy for every device at each sweep would defeat deferral.
+    for (auto& device : adapter_->device_info_list()) {
+        if (device.connected || device.paired) {
+            continue;
+        }
+        last_seen.push_back(device_cache_load_times_.resolve(device.path, device.last_update_timestamp, now));
+        candidates.push_back(std::move(device));
+    }
+    device_cache_load_times_.finish_sweep();
+
+    for (size_t index : select_device_evictions(last_seen, limits, now)) {
+        auto& device = candidates[index];
+
+        // Drop our own reference first, so that the proxy can be released as soon as BlueZ confirms the removal.
+        peripherals_.remove(ScanResultTable<PeripheralBase>::make_key(device.address));
+
+        try {
+            adapter_->device_remove(device.path);
+            evicted_devices_++;
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to evict device {}: {}", device.path, e.what()));
+        }
+    }
+
+    // Devices removed while a handle to them was still held stay in the proxy tree. Release those whose
+    // handles have been dropped since.
+    adapter_->path_prune();
+}
@@ -1,23 +1,36 @@
 #pragma once
 
+#include <simpleble/Adapter.h>
 #include <simpleble/Exceptions.h>
 #include <simpleble/Peripheral.h>
+#include <simpleble/ScanFilter.h>
 #include <simpleble/Types.h>
 
+#include "DeviceCachePolicy.h"
+#include "OperationScheduler.h"
+#include "ScanBatcher.h"
+#include "ScanFilterMatcher.h"
+#include "ScanResultTable.h"
+#include "ScanWaiter.h"
+
 #include <kvn_safe_callback.hpp>
 
 #include <simplebluez/Adapter.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace SimpleBLE {
 
-class AdapterBase {
+class AdapterBase : public std::enable_shared_from_this<AdapterBase> {
   public:
     AdapterBase(std::shared_ptr<SimpleBluez::Adapter> adapter);
     virtual ~AdapterBase();
@@ -30,31 +43,86 @@ class AdapterBase {
     void scan_start();
     void scan_stop();
     void scan_for(int timeout_ms);
+    std::optional<Peripheral> scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms);
+    void scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                          std::function<void(std::optional<Peripheral>)> on_complete);
     bool scan_is_active();
     std::vector<Peripheral> scan_get_results();
+    ScanChanges scan_get_changes(uint64_t since_version);
 
     void set_callback_on_scan_start(std::function<void()> on_scan_start);
     void set_callback_on_scan_stop(std::function<void()> on_scan_stop);
-    void set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated);
-    void set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found);
+    void set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t)> on_scan_updated);
+    void set_callback_on_scan_found(std::function<void(Peripheral, uint64_t)> on_scan_found);
+    void set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const&)> on_scan_batch,
+                                    int interval_ms);
+
+    void set_scan_filter(ScanFilter const& filter);
+
+    void set_device_cache_limits(DeviceCacheLimits const& limits);
+    DeviceCacheStats device_cache_stats();
+
+    void set_operation_concurrency(size_t max_concurrent);
+    std::vector<OperationQueueStats> operation_queue_stats();
 
     std::vector<Peripheral> get_paired_peripherals();
 
     static bool bluetooth_enabled();
     static std::vector<std::shared_ptr<AdapterBase>> get_adapters();
 
+    // Lets the application drive the backend from its own event loop. Only supported on Linux.
+    static bool use_external_event_loop();
+    static int event_fd();
+    static void process_events();
+
+    // Spreads adapters over connections of their own. Only supported on Linux.
+    static bool use_dedicated_connections(size_t count);
+
   private:
     std::shared_ptr<SimpleBluez::Adapter> adapter_;
 
-    std::atomic_bool is_scanning_;
+    // The SimpleBluez adapter holds a single handler per event, owned by the object registered for it.
+    void install_device_callbacks();
+
+    // Shared with every peripheral of this adapter, which may outlive it.
+    std::shared_ptr<OperationScheduler> operation_scheduler_;
+
+    std::atomic_bool is_scanning_{false};
+
+    // The filter and its matcher are replaced together under the lock. The matcher is immutable and also
+    // accessed atomically, as it is read without the lock while advertisements are being dispatched.
+    std::mutex scan_filter_mutex_;
+    std::optional<ScanFilter> scan_filter_;
+    std::shared_ptr<const ScanFilterMatcher> scan_filter_matcher_;
+
+    // Set while a scan_until call is pending. Accessed atomically, as it is read while dispatching.
+    std::shared_ptr<ScanWaiter> scan_waiter_;
+
+    // Set while batched delivery is enabled. Accessed atomically, as it is read while dispatching.
+    std::shared_ptr<ScanBatcher> scan_batcher_;
+
+    // Written from the D-Bus thread while user threads read scan results.
+    ScanResultTable<PeripheralBase> peripherals_;
+
+    // Stale devices are evicted from a dedicated thread, running while limits are set, as removing them
+    // involves blocking D-Bus calls.
+    void device_cache_run();
+    void device_cache_sweep(DeviceCacheLimits const& limits);
 
-    std::map<BluetoothAddress, std::shared_ptr<PeripheralBase>> peripherals_;
-    std::map<BluetoothAddress, std::shared_ptr<PeripheralBase>> seen_peripherals_;
+    std::mutex device_cache_mutex_;
+    std::condition_variable device_cache_cv_;
+    DeviceCacheLimits device_cache_limits_;
+    bool device_cache_stopping_ = false;
+    bool device_cache_running_ = false;
+    std::thread device_cache_worker_;
+    // Only used by the worker thread.
+    DeviceLoadTimes device_cache_load_times_;
+    std::atomic_uint64_t evicted_devices_{0};
 
     kvn::safe_callback<void()> callback_on_scan_start_;
     kvn::safe_callback<void()> callback_on_scan_stop_;
-    kvn::safe_callback<void(Peripheral)> callback_on_scan_updated_;
-    kvn::safe_callback<void(Peripheral)> callback_on_scan_found_;
+    kvn::safe_callback<void(Peripheral, uint64_t)> callback_on_scan_updated_;
+    kvn::safe_callback<void(Peripheral, uint64_t)> callback_on_scan_found_;
 };
 
 }  // namespace SimpleBLE
@@ -1,38 +1,88 @@
 #include "Bluez.h"
 
 #include "CommonUtils.h"
+#include "DispatchThread.h"
 
 #include <mutex>
 
 using namespace SimpleBLE;
 
+static std::mutex get_mutex;  // Static mutex to ensure thread safety when accessing the instance
+static bool instance_created = false;
+static bool external_event_loop = false;
+static size_t dedicated_connections = 0;
+
 Bluez* Bluez::get() {
-    static std::mutex get_mutex;       // Static mutex to ensure thread safety when accessing the logger
     std::scoped_lock lock(get_mutex);  // Unlock the mutex on function return
-    static Bluez instance;             // Static instance of the logger to ensure proper lifecycle management
+    instance_created = true;
+    static Bluez instance;             // Static instance to ensure proper lifecycle management
     return &instance;
 }
 
-Bluez::Bluez() {
-    bluez.init();
+bool Bluez::use_external_event_loop() {
+    std::scoped_lock lock(get_mutex);
+    if (instance_created) {
+        return external_event_loop;
+    }
+
+    external_event_loop = true;
+    return true;
+}
+
+bool Bluez::use_dedicated_connections(size_t count) {
+    std::scoped_lock lock(get_mutex);
+    if (instance_created) {
+        return false;
+    }
+
+    dedicated_connections = count;
+    return true;
+}
+
+Bluez::Bluez() : bluez(dedicated_connections), external_event_loop_(external_event_loop) {
+    // Devices and GATT objects cached by BlueZ are only materialized when first used, so that startup
+    // does not depend on how many devices the system remembers.
+    bluez.init(true);
+
+    if (external_event_loop_) {
+        event_fd_ = bluez.poll_fd();
+        SAFE_RUN({ bluez.register_agent(); });
+        return;
+    }
+
     async_thread_active = true;
-    async_thread = new std::thread(&Bluez::async_thread_function, this);
+    for (size_t i = 0; i < bluez.connection_count(); i++) {
+        async_threads.emplace_back(&Bluez::async_thread_function, this, i);
+    }
 }
 
 Bluez::~Bluez() {
     async_thread_active = false;
-    while (!async_thread->joinable()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    for (auto& thread : async_threads) {
+        thread.join();
+    }
+}
+
+int Bluez::event_fd() { return event_fd_; }
+
+void Bluez::process_events() {
+    if (!external_event_loop_) {
+        return;
     }
-    async_thread->join();
-    delete async_thread;
+
+    DispatchThreadScope dispatch_thread;
+    SAFE_RUN({ bluez.process_pending(); });
 }
 
-void Bluez::async_thread_function() {
-    SAFE_RUN({ bluez.register_agent(); });
+void Bluez::async_thread_function(size_t connection) {
+    DispatchThreadScope dispatch_thread;
+
+    if (connection == 0) {
+        SAFE_RUN({ bluez.register_agent(); });
+    }
 
     while (async_thread_active) {
-        SAFE_RUN({ bluez.run_async(); });
+        SAFE_RUN({ bluez.process_pending(connection); });
         std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
 }
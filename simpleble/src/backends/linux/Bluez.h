@@ -3,6 +3,7 @@
 #include <simplebluez/Bluez.h>
 #include <atomic>
 #include <thread>
+#include <vector>
 
 namespace SimpleBLE {
 
@@ -10,6 +11,24 @@ class Bluez {
   public:
     static Bluez* get();
 
+    /**
+     * @brief Leaves the processing of D-Bus messages to the application, instead of a dedicated thread.
+     *
+     * @return False if the singleton was already created, in which case its thread keeps running.
+     */
+    static bool use_external_event_loop();
+
+    /**
+     * @brief Spreads adapters over `count` private connections, each dispatched by a thread of its own.
+     *
+     * @return False if the singleton was already created.
+     */
+    static bool use_dedicated_connections(size_t count);
+
+    // Descriptor to watch in external mode, -1 otherwise.
+    int event_fd();
+    void process_events();
+
     SimpleBluez::Bluez bluez;
 
   private:
@@ -18,9 +37,13 @@ class Bluez {
     Bluez(Bluez& other) = delete;           // Remove the copy constructor
     void operator=(const Bluez&) = delete;  // Remove the copy assignment
 
-    std::thread* async_thread;
+    bool external_event_loop_ = false;
+    int event_fd_ = -1;
+
+    // One thread per connection, so that each one is dispatched independently.
+    std::vector<std::thread> async_threads;
     std::atomic_bool async_thread_active;
-    void async_thread_function();
+    void async_thread_function(size_t connection);
 };
 
 }  // namespace SimpleBLE
@@ -11,16 +11,21 @@
 #include "LoggingInternal.h"
 
 #include "Bluez.h"
+#include "TimerQueue.h"
 
 const SimpleBLE::BluetoothUUID BATTERY_SERVICE_UUID = "0000180f-0000-1000-8000-00805f9b34fb";
 const SimpleBLE::BluetoothUUID BATTERY_CHARACTERISTIC_UUID = "00002a19-0000-1000-8000-00805f9b34fb";
 
+// Time allowed for connect_async() to establish the link and resolve the services.
+constexpr int CONNECT_ASYNC_TIMEOUT_MS = 10000;
+
 using namespace SimpleBLE;
 using namespace std::chrono_literals;
 
 PeripheralBase::PeripheralBase(std::shared_ptr<SimpleBluez::Device> device,
-                               std::shared_ptr<SimpleBluez::Adapter> adapter)
-    : device_(std::move(device)), adapter_(std::move(adapter)) {}
+                               std::shared_ptr<SimpleBluez::Adapter> adapter,
+                               std::shared_ptr<OperationScheduler> operation_scheduler)
+    : device_(std::move(device)), adapter_(std::move(adapter)), operation_scheduler_(std::move(operation_scheduler)) {}
 
 PeripheralBase::~PeripheralBase() {
     // Clear the callbacks to prevent any further events from being sent to the user.
@@ -30,6 +35,24 @@ PeripheralBase::~PeripheralBase() {
     device_->clear_on_disconnected();
     device_->clear_on_services_resolved();
     _cleanup_characteristics();
+
+    // Stop following the device once it is released. A connected device can still be in use through another
+    // peripheral, so it stays tracked until BlueZ removes it. The cached state is used, as this can run on the
+    // dispatch thread, and a device whose object is already gone is always released.
+    bool connected = false;
+    try {
+        connected = device_->valid() && device_->connected(false);
+    } catch (std::exception const&) {
+        // The Device1 interface was removed along with the object.
+    }
+
+    try {
+        if (!connected) {
+            device_->untrack();
+        }
+    } catch (std::exception const& e) {
+        SIMPLEBLE_LOG_WARN(fmt::format("Failed to stop tracking {}: {}", device_->path(), e.what()));
+    }
 }
 
 void* PeripheralBase::underlying() const { return device_.get(); }
@@ -80,12 +103,7 @@ void PeripheralBase::connect() {
 
     // Set the on_disconnected callback once the connection attempts are finished, thus
     // preventing disconnection events that should not be seen by the user.
-    device_->set_on_disconnected([this]() {
-        this->_cleanup_characteristics();
-        this->disconnection_cv_.notify_all();
-
-        SAFE_CALLBACK_CALL(this->callback_on_disconnected_);
-    });
+    _watch_disconnection();
 
     if (!is_connected()) {
         throw Exception::OperationFailed();
@@ -94,6 +112,62 @@ void PeripheralBase::connect() {
     SAFE_CALLBACK_CALL(this->callback_on_connected_);
 }
 
+void PeripheralBase::connect_async(std::function<void(std::exception_ptr error)> on_complete) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(connect_async_mutex_);
+        if (connect_async_callback_) {
+            on_complete(std::make_exception_ptr(Exception::OperationFailed("A connection is already in progress")));
+            return;
+        }
+        connect_async_callback_ = std::move(on_complete);
+        generation = ++connect_async_generation_;
+    }
+
+    // The attempt completes once the Connect call has returned and the services are resolved, in either order.
+    std::weak_ptr<PeripheralBase> weak_this = weak_from_this();
+    device_->clear_on_disconnected();
+    device_->set_on_services_resolved([weak_this, generation]() {
+        if (auto self = weak_this.lock()) {
+            self->connection_cv_.notify_all();
+            self->_finish_connect_async(generation, nullptr);
+        }
+    });
+
+    try {
+        device_->connect([weak_this, generation](std::exception_ptr error) {
+            if (auto self = weak_this.lock()) {
+                self->_finish_connect_async(generation, error);
+            }
+        });
+    } catch (...) {
+        _finish_connect_async(generation, std::current_exception());
+        return;
+    }
+
+    TimerQueue::shared().schedule(CONNECT_ASYNC_TIMEOUT_MS, [weak_this, generation]() {
+        auto self = weak_this.lock();
+        if (!self) return;
+
+        auto timeout = std::make_exception_ptr(Exception::OperationFailed("Timed out waiting for services"));
+        if (!self->_finish_connect_async(generation, timeout)) return;
+
+        // The link might be up with the services still unresolved, or come up later, so the attempt is cancelled.
+        std::string path = self->device_->path();
+        try {
+            self->device_->disconnect([path](std::exception_ptr error) {
+                try {
+                    if (error) std::rethrow_exception(error);
+                } catch (std::exception const& e) {
+                    SIMPLEBLE_LOG_WARN(fmt::format("Failed to cancel the connection to {}: {}", path, e.what()));
+                }
+            });
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to cancel the connection to {}: {}", path, e.what()));
+        }
+    });
+}
+
 void PeripheralBase::disconnect() {
     // Attempt to connect to the device.
     for (size_t i = 0; i < 5; i++) {
@@ -198,7 +272,30 @@ ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const
     }
 
     // Otherwise, attempt to read the characteristic using default mechanisms
-    return _get_characteristic(service, characteristic)->read();
+    auto characteristic_object = _get_characteristic(service, characteristic);
+    return read_flights_.run(characteristic_object->path(), [&]() {
+        return _schedule(service, characteristic, [&]() { return characteristic_object->read(); });
+    });
+}
+
+ByteArray PeripheralBase::read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                      int max_age_ms) {
+    if (service == BATTERY_SERVICE_UUID && characteristic == BATTERY_CHARACTERISTIC_UUID &&
+        device_->has_battery_interface()) {
+        return read(service, characteristic);
+    }
+
+    // The cached value is kept up to date by both reads and notifications.
+    auto characteristic_object = _get_characteristic(service, characteristic);
+    uint64_t timestamp = characteristic_object->value_timestamp();
+    if (max_age_ms >= 0 && timestamp != 0 &&
+        monotonic_timestamp_ns() - timestamp <= static_cast<uint64_t>(max_age_ms) * 1000000) {
+        return characteristic_object->value();
+    }
+
+    return read_flights_.run(characteristic_object->path(), [&]() {
+        return _schedule(service, characteristic, [&]() { return characteristic_object->read(); });
+    });
 }
 
 void PeripheralBase::write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic,
@@ -206,7 +303,8 @@ void PeripheralBase::write_request(BluetoothUUID const& service, BluetoothUUID c
     // TODO: Check if the characteristic is writable.
     // TODO: SimpleBluez::Characteristic::write_request() should also take ByteArray by const reference (but that's
     // another library)
-    _get_characteristic(service, characteristic)->write_request(data);
+    auto characteristic_object = _get_characteristic(service, characteristic);
+    _schedule(service, characteristic, [&]() { characteristic_object->write_request(data); });
 }
 
 void PeripheralBase::write_command(BluetoothUUID const& service, BluetoothUUID const& characteristic,
@@ -214,18 +312,20 @@ void PeripheralBase::write_command(BluetoothUUID const& service, BluetoothUUID c
     // TODO: Check if the characteristic is writable.
     // TODO: SimpleBluez::Characteristic::write_command() should also take ByteArray by const reference (but that's
     // another library)
-    _get_characteristic(service, characteristic)->write_command(data);
+    auto characteristic_object = _get_characteristic(service, characteristic);
+    _schedule(service, characteristic, [&]() { characteristic_object->write_command(data); });
 }
 
 void PeripheralBase::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                            std::function<void(ByteArray payload)> callback) {
+                            std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
     // Check if the user is attempting to notify the battery service/characteristic and if so,
     //  emulate the battery service through the Battery1 interface if it's not available.
     if (service == BATTERY_SERVICE_UUID && characteristic == BATTERY_CHARACTERISTIC_UUID &&
         device_->has_battery_interface()) {
         // If this point is reached, the battery service needs to be emulated.
-        device_->set_on_battery_percentage_changed(
-            [callback](uint8_t new_value) { callback(ByteArray(reinterpret_cast<char*>(&new_value), 1)); });
+        device_->set_on_battery_percentage_changed([this, callback](uint8_t new_value) {
+            callback(ByteArray(reinterpret_cast<char*>(&new_value), 1), device_->last_update_timestamp());
+        });
         return;
     }
 
@@ -233,12 +333,13 @@ void PeripheralBase::notify(BluetoothUUID const& service, BluetoothUUID const& c
     // TODO: What to do if the characteristic is already being notified?
     // TODO: Check if the property can be notified.
     auto characteristic_object = _get_characteristic(service, characteristic);
-    characteristic_object->set_on_value_changed([callback](SimpleBluez::ByteArray new_value) { callback(new_value); });
-    characteristic_object->start_notify();
+    characteristic_object->set_on_value_changed(
+        [callback](SimpleBluez::ByteArray new_value, uint64_t timestamp) { callback(new_value, timestamp); });
+    _schedule(service, characteristic, [&]() { characteristic_object->start_notify(); });
 }
 
 void PeripheralBase::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                              std::function<void(ByteArray payload)> callback) {
+                              std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
     notify(service, characteristic, callback);
 }
 
@@ -254,7 +355,7 @@ void PeripheralBase::unsubscribe(BluetoothUUID const& service, BluetoothUUID con
 
     // TODO: What to do if the characteristic is not being notified?
     auto characteristic_object = _get_characteristic(service, characteristic);
-    characteristic_object->stop_notify();
+    _schedule(service, characteristic, [&]() { characteristic_object->stop_notify(); });
 
     // Wait for the characteristic to stop notifying.
     // TODO: Upgrade SimpleDBus to provide a way to wait for this signal.
@@ -264,14 +365,196 @@ void PeripheralBase::unsubscribe(BluetoothUUID const& service, BluetoothUUID con
     }
 }
 
+template <typename Request>
+std::vector<std::shared_ptr<SimpleBluez::Characteristic>> PeripheralBase::_resolve_batch(
+    std::vector<Request> const& requests, std::vector<OperationResult>& results, OperationPriority& priority) {
+    std::vector<std::shared_ptr<SimpleBluez::Characteristic>> characteristics(requests.size());
+
+    // The batch takes a single turn, at the most urgent priority among its items.
+    priority = OperationPriority::BULK;
+    for (size_t i = 0; i < requests.size(); i++) {
+        // Items already answered, such as emulated reads, are left as they are.
+        if (results[i].success || !results[i].error.empty()) continue;
+
+        try {
+            characteristics[i] = _get_characteristic(requests[i].service, requests[i].characteristic);
+            priority = std::min(priority, _operation_priority(requests[i].service, requests[i].characteristic));
+        } catch (std::exception const& e) {
+            results[i].error = e.what();
+        }
+    }
+    return characteristics;
+}
+
+template <typename Start, typename Finish>
+void PeripheralBase::_pipeline(std::vector<std::shared_ptr<SimpleBluez::Characteristic>> const& characteristics,
+                               OperationPriority priority, std::vector<OperationResult>& results, Start&& start,
+                               Finish&& finish) {
+    bool any = std::any_of(characteristics.begin(), characteristics.end(),
+                           [](auto const& characteristic) { return characteristic != nullptr; });
+    if (!any) return;
+
+    operation_scheduler_->run(device_->path(), priority, [&]() {
+        std::vector<SimpleDBus::PendingCall> calls(characteristics.size());
+        for (size_t i = 0; i < characteristics.size(); i++) {
+            if (characteristics[i] == nullptr) continue;
+            results[i] = capture_result([&]() { calls[i] = start(i); });
+        }
+
+        // Replies are collected in order, failed sends having already recorded their error.
+        for (size_t i = 0; i < characteristics.size(); i++) {
+            if (!calls[i].is_valid()) continue;
+            results[i] = capture_result([&]() { return finish(i, calls[i]); });
+        }
+    });
+}
+
+std::vector<OperationResult> PeripheralBase::read_many(std::vector<ReadRequest> const& requests) {
+    std::vector<OperationResult> results(requests.size());
+
+    // Emulated battery reads are answered from the Battery1 interface, without going through the pipeline.
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (requests[i].service == BATTERY_SERVICE_UUID && requests[i].characteristic == BATTERY_CHARACTERISTIC_UUID &&
+            device_->has_battery_interface()) {
+            results[i] = capture_result([&]() { return read(requests[i].service, requests[i].characteristic); });
+        }
+    }
+
+    OperationPriority priority;
+    auto characteristics = _resolve_batch(requests, results, priority);
+    _pipeline(
+        characteristics, priority, results, [&](size_t i) { return characteristics[i]->read_start(); },
+        [&](size_t i, SimpleDBus::PendingCall& call) { return characteristics[i]->read_finish(call); });
+    return results;
+}
+
+std::vector<OperationResult> PeripheralBase::write_many(std::vector<WriteRequest> const& requests) {
+    std::vector<OperationResult> results(requests.size());
+
+    OperationPriority priority;
+    auto characteristics = _resolve_batch(requests, results, priority);
+    _pipeline(
+        characteristics, priority, results,
+        [&](size_t i) {
+            return requests[i].with_response ? characteristics[i]->write_request_start(requests[i].data)
+                                             : characteristics[i]->write_command_start(requests[i].data);
+        },
+        [&](size_t, SimpleDBus::PendingCall& call) { call.wait(); });
+    return results;
+}
+
 ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                                BluetoothUUID const& descriptor) {
-    return _get_descriptor(service, characteristic, descriptor)->read();
+    auto descriptor_object = _get_descriptor(service, characteristic, descriptor);
+    return _schedule(service, characteristic, [&]() { return descriptor_object->read(); });
 }
 
 void PeripheralBase::write(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                            BluetoothUUID const& descriptor, ByteArray const& data) {
-    _get_descriptor(service, characteristic, descriptor)->write(data);
+    auto descriptor_object = _get_descriptor(service, characteristic, descriptor);
+    _schedule(service, characteristic, [&]() { descriptor_object->write(data); });
+}
+
+void PeripheralBase::read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                std::function<void(ByteArray value, std::exception_ptr error)> on_complete) {
+    // Only cached state is consulted, so that nothing here waits on the bus.
+    if (!device_->connected(false)) {
+        on_complete(ByteArray(), std::make_exception_ptr(Exception::NotConnected()));
+        return;
+    }
+
+    if (service == BATTERY_SERVICE_UUID && characteristic == BATTERY_CHARACTERISTIC_UUID &&
+        device_->has_battery_interface()) {
+        uint8_t battery_percentage = device_->battery_percentage();
+        on_complete(ByteArray(reinterpret_cast<char*>(&battery_percentage), 1), nullptr);
+        return;
+    }
+
+    _submit_async<ByteArray>(service, characteristic, std::move(on_complete),
+                             [](SimpleBluez::Characteristic& characteristic_object, auto done) {
+                                 characteristic_object.read(std::move(done));
+                             });
+}
+
+void PeripheralBase::write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    if (!device_->connected(false)) {
+        on_complete(std::make_exception_ptr(Exception::NotConnected()));
+        return;
+    }
+
+    _submit_async<>(service, characteristic, std::move(on_complete),
+                    [data](SimpleBluez::Characteristic& characteristic_object, auto done) {
+                        characteristic_object.write_request(data, std::move(done));
+                    });
+}
+
+void PeripheralBase::write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    if (!device_->connected(false)) {
+        on_complete(std::make_exception_ptr(Exception::NotConnected()));
+        return;
+    }
+
+    _submit_async<>(service, characteristic, std::move(on_complete),
+                    [data](SimpleBluez::Characteristic& characteristic_object, auto done) {
+                        characteristic_object.write_command(data, std::move(done));
+                    });
+}
+
+void PeripheralBase::notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                  std::function<void(ByteArray payload, uint64_t timestamp)> callback,
+                                  std::function<void(std::exception_ptr error)> on_complete) {
+    if (!device_->connected(false)) {
+        on_complete(std::make_exception_ptr(Exception::NotConnected()));
+        return;
+    }
+
+    if (service == BATTERY_SERVICE_UUID && characteristic == BATTERY_CHARACTERISTIC_UUID &&
+        device_->has_battery_interface()) {
+        notify(service, characteristic, std::move(callback));
+        on_complete(nullptr);
+        return;
+    }
+
+    _submit_async<>(service, characteristic, std::move(on_complete),
+                    [callback](SimpleBluez::Characteristic& characteristic_object, auto done) {
+                        characteristic_object.set_on_value_changed(
+                            [callback](SimpleBluez::ByteArray new_value, uint64_t timestamp) {
+                                callback(new_value, timestamp);
+                            });
+                        characteristic_object.start_notify(std::move(done));
+                    });
+}
+
+void PeripheralBase::unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                       std::function<void(std::exception_ptr error)> on_complete) {
+    if (!device_->connected(false)) {
+        on_complete(std::make_exception_ptr(Exception::NotConnected()));
+        return;
+    }
+
+    if (service == BATTERY_SERVICE_UUID && characteristic == BATTERY_CHARACTERISTIC_UUID &&
+        device_->has_battery_interface()) {
+        unsubscribe(service, characteristic);
+        on_complete(nullptr);
+        return;
+    }
+
+    // Unlike unsubscribe(), this does not poll for the Notifying property to clear, as BlueZ only replies
+    // to StopNotify once the session has been released.
+    _submit_async<>(service, characteristic, std::move(on_complete),
+                    [](SimpleBluez::Characteristic& characteristic_object, auto done) {
+                        characteristic_object.stop_notify(std::move(done));
+                    });
+}
+
+void PeripheralBase::set_operation_priority(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                            OperationPriority priority) {
+    std::lock_guard<std::mutex> lock(operation_priorities_mutex_);
+    operation_priorities_[{service, characteristic}] = priority;
 }
 
 void PeripheralBase::set_callback_on_connected(std::function<void()> on_connected) {
@@ -310,12 +593,18 @@ void PeripheralBase::_cleanup_characteristics() noexcept {
             }
         }
 
-        // Stop notifying all characteristics.
+        // BlueZ releases all notification sessions when the link goes down, so there is nothing left to stop.
+        if (!device_->connected(false)) {
+            return;
+        }
+
+        // Stop notifying all characteristics. The cached Notifying state is trusted and the requests are sent
+        // back to back without waiting for replies, as this can run on the D-Bus thread during a disconnection.
         for (auto bluez_service : device_->services()) {
             for (auto bluez_characteristic : bluez_service->characteristics()) {
                 try {
-                    if (bluez_characteristic->notifying()) {
-                        bluez_characteristic->stop_notify();
+                    if (bluez_characteristic->notifying(false)) {
+                        bluez_characteristic->stop_notify_async();
                     }
                 } catch (std::exception const& e) {
                     SIMPLEBLE_LOG_WARN(fmt::format("Exception during characteristic cleanup: {}", e.what()));
@@ -331,6 +620,75 @@ void PeripheralBase::_cleanup_characteristics() noexcept {
     }
 }
 
+bool PeripheralBase::_finish_connect_async(uint64_t generation, std::exception_ptr error) {
+    std::function<void(std::exception_ptr error)> callback;
+    {
+        std::lock_guard<std::mutex> lock(connect_async_mutex_);
+        if (generation != connect_async_generation_ || !connect_async_callback_) return false;
+
+        // Wait for the remaining event unless the attempt failed.
+        if (!error && !(device_->connected(false) && device_->services_resolved(false))) return false;
+
+        callback = std::move(connect_async_callback_);
+        connect_async_callback_ = nullptr;
+    }
+
+    if (error) {
+        // A successful attempt can finish from within the handler, which therefore stays in place. It is harmless
+        // once the attempt is over, as it only holds a weak reference and checks the generation.
+        device_->clear_on_services_resolved();
+    } else {
+        _watch_disconnection();
+        SAFE_CALLBACK_CALL(this->callback_on_connected_);
+    }
+    callback(error);
+    return true;
+}
+
+void PeripheralBase::_watch_disconnection() {
+    device_->set_on_disconnected([this]() {
+        this->_cleanup_characteristics();
+        this->disconnection_cv_.notify_all();
+
+        SAFE_CALLBACK_CALL(this->callback_on_disconnected_);
+    });
+}
+
+void PeripheralBase::_submit(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                             std::function<void(std::function<void()> release)> start) {
+    std::shared_ptr<OperationScheduler> scheduler = operation_scheduler_;
+    std::string path = device_->path();
+
+    scheduler->submit(path, _operation_priority(service, characteristic), [scheduler, path, start]() {
+        start([scheduler, path]() { scheduler->release(path); });
+    });
+}
+
+template <typename... Result>
+void PeripheralBase::_submit_async(
+    BluetoothUUID const& service, BluetoothUUID const& characteristic, AsyncCompletion<Result...> on_complete,
+    std::function<void(SimpleBluez::Characteristic& characteristic, AsyncCompletion<Result...> done)> start) {
+    std::shared_ptr<SimpleBluez::Characteristic> characteristic_object;
+    try {
+        characteristic_object = _get_characteristic(service, characteristic);
+    } catch (...) {
+        on_complete(Result()..., std::current_exception());
+        return;
+    }
+
+    _submit(service, characteristic, [characteristic_object, on_complete, start](std::function<void()> release) {
+        try {
+            start(*characteristic_object, [release, on_complete](Result... result, std::exception_ptr error) {
+                release();
+                on_complete(std::move(result)..., error);
+            });
+        } catch (...) {
+            release();
+            on_complete(Result()..., std::current_exception());
+        }
+    });
+}
+
 bool PeripheralBase::_attempt_connect() {
     try {
         device_->connect();
@@ -375,3 +733,12 @@ std::shared_ptr<SimpleBluez::Descriptor> PeripheralBase::_get_descriptor(Bluetoo
         throw Exception::DescriptorNotFound(descriptor_uuid);
     }
 }
+
+OperationPriority PeripheralBase::_operation_priority(BluetoothUUID const& service,
+                                                     BluetoothUUID const& characteristic) {
+    std::lock_guard<std::mutex> lock(operation_priorities_mutex_);
+    auto it = operation_priorities_.find({service, characteristic});
+    return it != operation_priorities_.end() ? it->second : OperationPriority::INTERACTIVE;
+}
+
+ScanUpdateState& PeripheralBase::scan_update_state() { return scan_update_state_; }
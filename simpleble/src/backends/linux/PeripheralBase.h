@@ -8,17 +8,29 @@
 #include <simplebluez/Characteristic.h>
 #include <simplebluez/Device.h>
 
+#include "BatchOperations.h"
+#include "OperationScheduler.h"
+#include "ScanFilterMatcher.h"
+#include "SingleFlight.h"
+
 #include <kvn_safe_callback.hpp>
 
 #include <atomic>
 #include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 
 namespace SimpleBLE {
 
-class PeripheralBase {
+class PeripheralBase : public std::enable_shared_from_this<PeripheralBase> {
   public:
-    PeripheralBase(std::shared_ptr<SimpleBluez::Device> device, std::shared_ptr<SimpleBluez::Adapter> adapter);
+    PeripheralBase(std::shared_ptr<SimpleBluez::Device> device, std::shared_ptr<SimpleBluez::Adapter> adapter,
+                   std::shared_ptr<OperationScheduler> operation_scheduler);
     virtual ~PeripheralBase();
 
     void* underlying() const;
@@ -43,25 +55,55 @@ class PeripheralBase {
 
     // clang-format off
     ByteArray read(BluetoothUUID const& service, BluetoothUUID const& characteristic);
+    ByteArray read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic, int max_age_ms);
     void write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data);
     void write_command(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data);
-    void notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback);
-    void indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback);
+    void notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback);
+    void indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback);
     void unsubscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic);
 
     ByteArray read(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor);
     void write(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor, ByteArray const& data);
     // clang-format on
 
+    std::vector<OperationResult> read_many(std::vector<ReadRequest> const& requests);
+    std::vector<OperationResult> write_many(std::vector<WriteRequest> const& requests);
+
+    // clang-format off
+    void connect_async(std::function<void(std::exception_ptr error)> on_complete);
+    void read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray value, std::exception_ptr error)> on_complete);
+    void write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete);
+    void write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete);
+    void notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback, std::function<void(std::exception_ptr error)> on_complete);
+    void unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(std::exception_ptr error)> on_complete);
+    // clang-format on
+
+    void set_operation_priority(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                OperationPriority priority);
+
     void set_callback_on_connected(std::function<void()> on_connected);
     void set_callback_on_disconnected(std::function<void()> on_disconnected);
 
+    // Only accessed from the thread dispatching scan results.
+    ScanUpdateState& scan_update_state();
+
   private:
     std::atomic_bool battery_emulation_required_{false};
 
+    ScanUpdateState scan_update_state_;
+
+    // Concurrent reads of the same characteristic, keyed by object path, share a single ReadValue call.
+    SingleFlight<std::string, ByteArray> read_flights_;
+
     std::shared_ptr<SimpleBluez::Adapter> adapter_;
     std::shared_ptr<SimpleBluez::Device> device_;
 
+    // GATT operations wait for their turn in the adapter-wide scheduler, keyed by device path.
+    std::shared_ptr<OperationScheduler> operation_scheduler_;
+
+    std::mutex operation_priorities_mutex_;
+    std::map<std::pair<BluetoothUUID, BluetoothUUID>, OperationPriority> operation_priorities_;
+
     std::condition_variable connection_cv_;
     std::mutex connection_mutex_;
 
@@ -71,6 +113,52 @@ class PeripheralBase {
     kvn::safe_callback<void()> callback_on_connected_;
     kvn::safe_callback<void()> callback_on_disconnected_;
 
+    // Pending connect_async() call, if any. The generation tells the events of successive attempts apart.
+    std::mutex connect_async_mutex_;
+    std::function<void(std::exception_ptr error)> connect_async_callback_;
+    uint64_t connect_async_generation_ = 0;
+
+    // Returns whether the pending attempt was completed by this call.
+    bool _finish_connect_async(uint64_t generation, std::exception_ptr error);
+    void _watch_disconnection();
+
+    // Queues an operation without blocking. `start` runs once its turn comes, and must call `release` once the
+    // operation has completed.
+    void _submit(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                 std::function<void(std::function<void()> release)> start);
+
+    // Spelled through a nested type, so that the result types of _submit_async() are only given explicitly.
+    template <typename... Result>
+    using AsyncCompletion = typename std::common_type<std::function<void(Result..., std::exception_ptr)>>::type;
+
+    // Looks up the characteristic and queues `start` on it, which reports through the `done` callback it is given.
+    // The turn is released before `on_complete` runs, which also receives any failure to look up or start the
+    // operation.
+    template <typename... Result>
+    void _submit_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                       AsyncCompletion<Result...> on_complete,
+                       std::function<void(SimpleBluez::Characteristic& characteristic, AsyncCompletion<Result...> done)>
+                           start);
+
+    OperationPriority _operation_priority(BluetoothUUID const& service, BluetoothUUID const& characteristic);
+
+    template <typename Function>
+    auto _schedule(BluetoothUUID const& service, BluetoothUUID const& characteristic, Function&& function) {
+        return operation_scheduler_->run(device_->path(), _operation_priority(service, characteristic),
+                                         std::forward<Function>(function));
+    }
+
+    // Resolves the characteristic of every item of a batch, recording failures in `results`.
+    template <typename Request>
+    std::vector<std::shared_ptr<SimpleBluez::Characteristic>> _resolve_batch(std::vector<Request> const& requests,
+                                                                             std::vector<OperationResult>& results,
+                                                                             OperationPriority& priority);
+
+    // Sends the call of every resolved item before waiting for the first reply, all within a single turn.
+    template <typename Start, typename Finish>
+    void _pipeline(std::vector<std::shared_ptr<SimpleBluez::Characteristic>> const& characteristics,
+                   OperationPriority priority, std::vector<OperationResult>& results, Start&& start, Finish&& finish);
+
     bool _attempt_connect();
     bool _attempt_disconnect();
     void _cleanup_characteristics() noexcept;
@@ -1,16 +1,23 @@
 #pragma once
 
+#include <simpleble/Adapter.h>
 #include <simpleble/Exceptions.h>
 #include <simpleble/Peripheral.h>
+#include <simpleble/ScanFilter.h>
 #include <simpleble/Types.h>
 
 #include "AdapterBaseTypes.h"
+#include "OperationScheduler.h"
+#include "ScanBatcher.h"
+#include "ScanFilterMatcher.h"
+#include "ScanWaiter.h"
 
 #include <kvn_safe_callback.hpp>
 
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -20,7 +27,7 @@ namespace SimpleBLE {
   This class definition acts as an abstraction layer between C++ and Objective-C.
   If Objective-C headers are included here, everything blows up.
  */
-class AdapterBase {
+class AdapterBase : public std::enable_shared_from_this<AdapterBase> {
   public:
     AdapterBase();
     virtual ~AdapterBase();
@@ -33,19 +40,41 @@ class AdapterBase {
     void scan_start();
     void scan_stop();
     void scan_for(int timeout_ms);
+    std::optional<Peripheral> scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms);
+    void scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                          std::function<void(std::optional<Peripheral>)> on_complete);
     bool scan_is_active();
     std::vector<Peripheral> scan_get_results();
+    ScanChanges scan_get_changes(uint64_t since_version);
 
     void set_callback_on_scan_start(std::function<void()> on_scan_start);
     void set_callback_on_scan_stop(std::function<void()> on_scan_stop);
-    void set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated);
-    void set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found);
+    void set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t)> on_scan_updated);
+    void set_callback_on_scan_found(std::function<void(Peripheral, uint64_t)> on_scan_found);
+    void set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const&)> on_scan_batch,
+                                    int interval_ms);
+
+    void set_scan_filter(ScanFilter const& filter);
+
+    void set_device_cache_limits(DeviceCacheLimits const& limits);
+    DeviceCacheStats device_cache_stats();
+
+    void set_operation_concurrency(size_t max_concurrent);
+    std::vector<OperationQueueStats> operation_queue_stats();
 
     std::vector<Peripheral> get_paired_peripherals();
 
     static bool bluetooth_enabled();
     static std::vector<std::shared_ptr<AdapterBase> > get_adapters();
 
+    // Lets the application drive the backend from its own event loop. Only supported on Linux.
+    static bool use_external_event_loop();
+    static int event_fd();
+    static void process_events();
+
+    // Spreads adapters over connections of their own. Only supported on Linux.
+    static bool use_dedicated_connections(size_t count);
+
     void delegate_did_discover_peripheral(void* opaque_peripheral, void* opaque_adapter,
                                           advertising_data_t advertising_data);
     void delegate_did_connect_peripheral(void* opaque_peripheral);
@@ -60,8 +89,8 @@ class AdapterBase {
 
     kvn::safe_callback<void()> callback_on_scan_start_;
     kvn::safe_callback<void()> callback_on_scan_stop_;
-    kvn::safe_callback<void(Peripheral)> callback_on_scan_updated_;
-    kvn::safe_callback<void(Peripheral)> callback_on_scan_found_;
+    kvn::safe_callback<void(Peripheral, uint64_t)> callback_on_scan_updated_;
+    kvn::safe_callback<void(Peripheral, uint64_t)> callback_on_scan_found_;
 
     /**
      * Holds a map of objective-c peripheral objects to their corresponding C++ objects.
@@ -73,6 +102,20 @@ class AdapterBase {
      */
     std::map<void*, std::shared_ptr<PeripheralBase> > peripherals_;
     std::map<void*, std::shared_ptr<PeripheralBase> > seen_peripherals_;
+
+    DeviceCacheLimits device_cache_limits_;
+
+    // Only keeps the concurrency setting and reports empty queues, as operations are not scheduled here.
+    OperationScheduler operation_scheduler_;
+
+    // Accessed atomically, as it can be replaced while advertisements are being dispatched.
+    std::shared_ptr<const ScanFilterMatcher> scan_filter_matcher_;
+
+    // Set while a scan_until call is pending. Accessed atomically, as it is read while dispatching.
+    std::shared_ptr<ScanWaiter> scan_waiter_;
+
+    // Set while batched delivery is enabled. Accessed atomically, as it is read while dispatching.
+    std::shared_ptr<ScanBatcher> scan_batcher_;
 };
 
 }  // namespace SimpleBLE
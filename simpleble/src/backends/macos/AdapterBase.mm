@@ -3,6 +3,7 @@
 #import "CommonUtils.h"
 #import "PeripheralBase.h"
 #import "PeripheralBuilder.h"
+#import "TimerQueue.h"
 
 #include <chrono>
 #include <thread>
@@ -35,6 +36,14 @@ bool AdapterBase::bluetooth_enabled() {
     return [internal isBluetoothEnabled];
 }
 
+bool AdapterBase::use_external_event_loop() { return false; }
+
+int AdapterBase::event_fd() { return -1; }
+
+void AdapterBase::process_events() {}
+
+bool AdapterBase::use_dedicated_connections([[maybe_unused]] size_t count) { return false; }
+
 std::vector<std::shared_ptr<AdapterBase> > AdapterBase::get_adapters() {
     // There doesn't seem to be a mechanism with Apple devices that openly
     // exposes more than the default Bluetooth device.
@@ -75,6 +84,12 @@ void AdapterBase::scan_stop() {
     AdapterBaseMacOS* internal = (__bridge AdapterBaseMacOS*)opaque_internal_;
     [internal scanStop];
 
+    // Deliver what is left of the current batch right away.
+    auto batcher = std::atomic_load(&this->scan_batcher_);
+    if (batcher) {
+        batcher->flush();
+    }
+
     SAFE_CALLBACK_CALL(this->callback_on_scan_stop_);
 }
 
@@ -84,6 +99,62 @@ void AdapterBase::scan_for(int timeout_ms) {
     this->scan_stop();
 }
 
+std::optional<Peripheral> AdapterBase::scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    std::atomic_store(&scan_waiter_, waiter);
+
+    // A scan started by the user is joined and left running.
+    bool owns_scan = !this->scan_is_active();
+    if (owns_scan) {
+        this->scan_start();
+    }
+    auto match = waiter->wait(timeout_ms);
+
+    // Stop as soon as the waiter returns, so that no time is spent scanning past the first match.
+    std::atomic_store(&scan_waiter_, std::shared_ptr<ScanWaiter>());
+    if (owns_scan) {
+        this->scan_stop();
+    }
+
+    return match;
+}
+
+void AdapterBase::scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                                   std::function<void(std::optional<Peripheral>)> on_complete) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    bool owns_scan = !scan_is_active();
+
+    // The waiter settles on the thread dispatching advertisements, so the scan is stopped from the timer thread.
+    // The adapter may be gone by then, in which case there is no scan left to stop.
+    std::weak_ptr<AdapterBase> weak_this = weak_from_this();
+    waiter->on_settled([weak_this, waiter, owns_scan, on_complete](std::optional<Peripheral> match) {
+        TimerQueue::shared().schedule(0, [weak_this, waiter, owns_scan, on_complete, match]() {
+            if (auto self = weak_this.lock()) {
+                std::shared_ptr<ScanWaiter> expected = waiter;
+                bool current = std::atomic_compare_exchange_strong(&self->scan_waiter_, &expected,
+                                                                   std::shared_ptr<ScanWaiter>());
+                if (current && owns_scan) {
+                    try {
+                        self->scan_stop();
+                    } catch (...) {
+                        // Failing to stop the scan does not change the outcome of the search.
+                    }
+                }
+            }
+            on_complete(match);
+        });
+    });
+    std::atomic_store(&scan_waiter_, waiter);
+
+    if (owns_scan) {
+        scan_start();
+    }
+
+    if (timeout_ms >= 0) {
+        TimerQueue::shared().schedule(timeout_ms, [waiter]() { waiter->expire(); });
+    }
+}
+
 bool AdapterBase::scan_is_active() {
     AdapterBaseMacOS* internal = (__bridge AdapterBaseMacOS*)opaque_internal_;
     return [internal scanIsActive];
@@ -98,6 +169,14 @@ std::vector<Peripheral> AdapterBase::scan_get_results() {
     return peripherals;
 }
 
+ScanChanges AdapterBase::scan_get_changes([[maybe_unused]] uint64_t since_version) {
+    // No versioned results table on this platform, so every call is a full refresh.
+    ScanChanges changes;
+    changes.reset = true;
+    changes.added = scan_get_results();
+    return changes;
+}
+
 void AdapterBase::set_callback_on_scan_start(std::function<void()> on_scan_start) {
     if (on_scan_start) {
         callback_on_scan_start_.load(on_scan_start);
@@ -112,14 +191,14 @@ void AdapterBase::set_callback_on_scan_stop(std::function<void()> on_scan_stop)
         callback_on_scan_stop_.unload();
     }
 }
-void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated) {
+void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t)> on_scan_updated) {
     if (on_scan_updated) {
         callback_on_scan_updated_.load(on_scan_updated);
     } else {
         callback_on_scan_updated_.unload();
     }
 }
-void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found) {
+void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral, uint64_t)> on_scan_found) {
     if (on_scan_found) {
         callback_on_scan_found_.load(on_scan_found);
     } else {
@@ -129,9 +208,39 @@ void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral)> on_
 
 std::vector<Peripheral> AdapterBase::get_paired_peripherals() { return {}; }
 
+void AdapterBase::set_scan_filter(ScanFilter const& filter) {
+    std::atomic_store(&scan_filter_matcher_, std::make_shared<const ScanFilterMatcher>(filter));
+}
+
+void AdapterBase::set_device_cache_limits(DeviceCacheLimits const& limits) {
+    // CoreBluetooth owns the device cache, so the limits are recorded but not enforced.
+    device_cache_limits_ = limits;
+}
+
+DeviceCacheStats AdapterBase::device_cache_stats() {
+    DeviceCacheStats stats;
+    stats.cached_devices = peripherals_.size();
+    return stats;
+}
+
+void AdapterBase::set_operation_concurrency(size_t max_concurrent) {
+    // CoreBluetooth queues GATT operations itself, so the setting is recorded but not enforced.
+    operation_scheduler_.set_max_concurrent(max_concurrent);
+}
+
+std::vector<OperationQueueStats> AdapterBase::operation_queue_stats() { return operation_scheduler_.stats(); }
+
 // Delegate methods passed for AdapterBaseMacOS
 
 void AdapterBase::delegate_did_discover_peripheral(void* opaque_peripheral, void* opaque_adapter, advertising_data_t advertising_data) {
+    uint64_t timestamp = monotonic_timestamp_ns();
+
+    auto matcher = std::atomic_load(&scan_filter_matcher_);
+    AdvertisingDataScanSource source{advertising_data};
+    if (matcher && !matcher->matches(source)) {
+        return;
+    }
+
     if (this->peripherals_.count(opaque_peripheral) == 0) {
         // If the incoming peripheral has never been seen before, create and save a reference to it.
         auto base_peripheral = std::make_shared<PeripheralBase>(opaque_peripheral, opaque_adapter, advertising_data);
@@ -145,13 +254,25 @@ void AdapterBase::delegate_did_discover_peripheral(void* opaque_peripheral, void
     // Convert the base object into an external-facing Peripheral object
     PeripheralBuilder peripheral_builder(base_peripheral);
 
+    // Hand the peripheral to a pending scan_until call before anything else is reported.
+    auto waiter = std::atomic_load(&this->scan_waiter_);
+    if (waiter) {
+        waiter->offer(peripheral_builder);
+    }
+
     // Check if the device has been seen before, to forward the correct call to the user.
-    if (this->seen_peripherals_.count(opaque_peripheral) == 0) {
+    bool first_seen = this->seen_peripherals_.count(opaque_peripheral) == 0;
+    if (first_seen) {
         // Store it in our table of seen peripherals
         this->seen_peripherals_.insert(std::make_pair(opaque_peripheral, base_peripheral));
-        SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder);
+        SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder, timestamp);
     } else {
-        SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder);
+        SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder, timestamp);
+    }
+
+    auto batcher = std::atomic_load(&this->scan_batcher_);
+    if (batcher) {
+        batcher->push(reinterpret_cast<uintptr_t>(opaque_peripheral), peripheral_builder, first_seen, timestamp);
     }
 }
 
@@ -184,3 +305,14 @@ void AdapterBase::delegate_did_disconnect_peripheral(void* opaque_peripheral, vo
     std::shared_ptr<PeripheralBase> base_peripheral = this->peripherals_.at(opaque_peripheral);
     base_peripheral->delegate_did_disconnect(opaque_error);
 }
+
+void AdapterBase::set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const&)> on_scan_batch,
+                                             int interval_ms) {
+    std::shared_ptr<ScanBatcher> batcher;
+    if (on_scan_batch) {
+        batcher = std::make_shared<ScanBatcher>(std::move(on_scan_batch), std::chrono::milliseconds(interval_ms));
+    }
+
+    // Any previous batcher is stopped once the last advertisement being dispatched to it is done.
+    std::atomic_store(&scan_batcher_, batcher);
+}
@@ -2,7 +2,10 @@
 #import "PeripheralBaseMacOS.h"
 #import "ServiceBuilder.h"
 
+#import "AsyncFallback.h"
+#import "BatchOperations.h"
 #import "CommonUtils.h"
+#import "DispatchThread.h"
 
 #include <iostream>
 
@@ -126,6 +129,12 @@ ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const
     return [internal read:service_uuid characteristic_uuid:characteristic_uuid];
 }
 
+ByteArray PeripheralBase::read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                      [[maybe_unused]] int max_age_ms) {
+    // No value cache is kept by this backend, so every read goes to the peripheral.
+    return read(service, characteristic);
+}
+
 void PeripheralBase::write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data) {
     PeripheralBaseMacOS* internal = (__bridge PeripheralBaseMacOS*)opaque_internal_;
 
@@ -147,21 +156,33 @@ void PeripheralBase::write_command(BluetoothUUID const& service, BluetoothUUID c
 }
 
 void PeripheralBase::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                            std::function<void(ByteArray payload)> callback) {
+                            std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
     PeripheralBaseMacOS* internal = (__bridge PeripheralBaseMacOS*)opaque_internal_;
 
     NSString* service_uuid = [NSString stringWithCString:service.c_str() encoding:NSString.defaultCStringEncoding];
     NSString* characteristic_uuid = [NSString stringWithCString:characteristic.c_str() encoding:NSString.defaultCStringEncoding];
-    [internal notify:service_uuid characteristic_uuid:characteristic_uuid callback:callback];
+    [internal notify:service_uuid
+        characteristic_uuid:characteristic_uuid
+                   callback:[callback](ByteArray payload) {
+                       // Delivered on the queue shared by every CoreBluetooth event.
+                       DispatchThreadScope dispatch_thread;
+                       callback(payload, monotonic_timestamp_ns());
+                   }];
 }
 
 void PeripheralBase::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                              std::function<void(ByteArray payload)> callback) {
+                              std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
     PeripheralBaseMacOS* internal = (__bridge PeripheralBaseMacOS*)opaque_internal_;
 
     NSString* service_uuid = [NSString stringWithCString:service.c_str() encoding:NSString.defaultCStringEncoding];
     NSString* characteristic_uuid = [NSString stringWithCString:characteristic.c_str() encoding:NSString.defaultCStringEncoding];
-    [internal indicate:service_uuid characteristic_uuid:characteristic_uuid callback:callback];
+    [internal indicate:service_uuid
+        characteristic_uuid:characteristic_uuid
+                   callback:[callback](ByteArray payload) {
+                       // Delivered on the queue shared by every CoreBluetooth event.
+                       DispatchThreadScope dispatch_thread;
+                       callback(payload, monotonic_timestamp_ns());
+                   }];
 }
 
 void PeripheralBase::unsubscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic) {
@@ -172,6 +193,79 @@ void PeripheralBase::unsubscribe(BluetoothUUID const& service, BluetoothUUID con
     [internal unsubscribe:service_uuid characteristic_uuid:characteristic_uuid];
 }
 
+std::vector<OperationResult> PeripheralBase::read_many(std::vector<ReadRequest> const& requests) {
+    return run_serially(requests, [this](ReadRequest const& request) {
+        return read(request.service, request.characteristic);
+    });
+}
+
+std::vector<OperationResult> PeripheralBase::write_many(std::vector<WriteRequest> const& requests) {
+    return run_serially(requests, [this](WriteRequest const& request) {
+        if (request.with_response) {
+            write_request(request.service, request.characteristic, request.data);
+        } else {
+            write_command(request.service, request.characteristic, request.data);
+        }
+    });
+}
+
+void PeripheralBase::connect_async(std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread([this]() { connect(); }, std::move(on_complete));
+}
+
+void PeripheralBase::read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                std::function<void(ByteArray value, std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            return read(service, characteristic);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, data]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            write_request(service, characteristic, data);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, data]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            write_command(service, characteristic, data);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                  std::function<void(ByteArray payload, uint64_t timestamp)> callback,
+                                  std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, callback]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            notify(service, characteristic, callback);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                       std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            unsubscribe(service, characteristic);
+        },
+        std::move(on_complete));
+}
+
 ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor) {
     PeripheralBaseMacOS* internal = (__bridge PeripheralBaseMacOS*)opaque_internal_;
 
@@ -194,6 +288,12 @@ void PeripheralBase::write(BluetoothUUID const& service, BluetoothUUID const& ch
     [internal write:service_uuid characteristic_uuid:characteristic_uuid descriptor_uuid:descriptor_uuid payload:payload];
 }
 
+void PeripheralBase::set_operation_priority([[maybe_unused]] BluetoothUUID const& service,
+                                            [[maybe_unused]] BluetoothUUID const& characteristic,
+                                            [[maybe_unused]] OperationPriority priority) {
+    // Operations are not scheduled by this backend, so there is nothing to prioritize.
+}
+
 void PeripheralBase::set_callback_on_connected(std::function<void()> on_connected) {
     if (on_connected) {
         callback_on_connected_.load(std::move(on_connected));
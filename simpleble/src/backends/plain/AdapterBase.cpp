@@ -2,6 +2,7 @@
 #include "CommonUtils.h"
 #include "PeripheralBase.h"
 #include "PeripheralBuilder.h"
+#include "TimerQueue.h"
 
 #include <thread>
 
@@ -15,6 +16,14 @@ std::vector<std::shared_ptr<AdapterBase>> AdapterBase::get_adapters() {
 
 bool AdapterBase::bluetooth_enabled() { return true; }
 
+bool AdapterBase::use_external_event_loop() { return false; }
+
+int AdapterBase::event_fd() { return -1; }
+
+void AdapterBase::process_events() {}
+
+bool AdapterBase::use_dedicated_connections([[maybe_unused]] size_t count) { return false; }
+
 AdapterBase::AdapterBase() {}
 
 AdapterBase::~AdapterBase() {}
@@ -29,13 +38,70 @@ void AdapterBase::scan_start() {
     is_scanning_ = true;
     SAFE_CALLBACK_CALL(this->callback_on_scan_start_);
 
-    PeripheralBuilder peripheral_builder(std::make_shared<PeripheralBase>());
-    SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder);
-    SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder);
+    peripherals_.clear_seen();
+
+    auto base_peripheral = std::make_shared<PeripheralBase>();
+
+    advertising_data_t data = {};
+    data.identifier = base_peripheral->identifier();
+    data.mac_address = base_peripheral->address();
+    data.rssi = base_peripheral->rssi();
+    data.manufacturer_data = base_peripheral->manufacturer_data();
+
+    // The plain peripheral advertises the same payload twice, which is reported once as found and once as updated.
+    _scan_received_callback(data, base_peripheral);
+    _scan_received_callback(data, base_peripheral);
+}
+
+void AdapterBase::_scan_received_callback(advertising_data_t const& data, std::shared_ptr<PeripheralBase> peripheral) {
+    auto matcher = std::atomic_load(&scan_filter_matcher_);
+    AdvertisingDataScanSource source{data};
+    if (matcher && !matcher->matches(source)) {
+        return;
+    }
+
+    auto key = ScanResultTable<PeripheralBase>::make_key(data.mac_address);
+    auto [base_peripheral, first_seen] = peripherals_.upsert(key, [&]() { return peripheral; });
+
+    // Drop updates that carry nothing new before any user-facing object is built.
+    if (matcher && !matcher->accept_update(base_peripheral->scan_update_state(), first_seen, source.fingerprint(),
+                                           [&]() { return data.rssi; })) {
+        return;
+    }
+    if (!first_seen) {
+        peripherals_.mark_updated(key);
+    }
+
+    PeripheralBuilder peripheral_builder(base_peripheral);
+    uint64_t timestamp = monotonic_timestamp_ns();
+
+    // Hand the peripheral to a pending scan_until call before anything else is reported.
+    auto waiter = std::atomic_load(&this->scan_waiter_);
+    if (waiter) {
+        waiter->offer(peripheral_builder);
+    }
+
+    if (first_seen) {
+        SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder, timestamp);
+    } else {
+        SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder, timestamp);
+    }
+
+    auto batcher = std::atomic_load(&this->scan_batcher_);
+    if (batcher) {
+        batcher->push(key, peripheral_builder, first_seen, timestamp);
+    }
 }
 
 void AdapterBase::scan_stop() {
     is_scanning_ = false;
+
+    // Deliver what is left of the current batch right away.
+    auto batcher = std::atomic_load(&this->scan_batcher_);
+    if (batcher) {
+        batcher->flush();
+    }
+
     SAFE_CALLBACK_CALL(this->callback_on_scan_stop_);
 }
 
@@ -45,6 +111,58 @@ void AdapterBase::scan_for(int timeout_ms) {
     scan_stop();
 }
 
+std::optional<Peripheral> AdapterBase::scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    std::atomic_store(&scan_waiter_, waiter);
+
+    // A scan started by the user is left running. The plain adapter reports its peripheral on every start.
+    bool owns_scan = !scan_is_active();
+    scan_start();
+    auto match = waiter->wait(timeout_ms);
+
+    // Stop as soon as the waiter returns, so that no time is spent scanning past the first match.
+    std::atomic_store(&scan_waiter_, std::shared_ptr<ScanWaiter>());
+    if (owns_scan) {
+        scan_stop();
+    }
+
+    return match;
+}
+
+void AdapterBase::scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                                   std::function<void(std::optional<Peripheral>)> on_complete) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    bool owns_scan = !scan_is_active();
+
+    // The waiter settles on the thread dispatching advertisements, so the scan is stopped from the timer thread.
+    // The adapter may be gone by then, in which case there is no scan left to stop.
+    std::weak_ptr<AdapterBase> weak_this = weak_from_this();
+    waiter->on_settled([weak_this, waiter, owns_scan, on_complete](std::optional<Peripheral> match) {
+        TimerQueue::shared().schedule(0, [weak_this, waiter, owns_scan, on_complete, match]() {
+            if (auto self = weak_this.lock()) {
+                std::shared_ptr<ScanWaiter> expected = waiter;
+                bool current = std::atomic_compare_exchange_strong(&self->scan_waiter_, &expected,
+                                                                   std::shared_ptr<ScanWaiter>());
+                if (current && owns_scan) {
+                    try {
+                        self->scan_stop();
+                    } catch (...) {
+                        // Failing to stop the scan does not change the outcome of the search.
+                    }
+                }
+            }
+            on_complete(match);
+        });
+    });
+    std::atomic_store(&scan_waiter_, waiter);
+
+    scan_start();
+
+    if (timeout_ms >= 0) {
+        TimerQueue::shared().schedule(timeout_ms, [waiter]() { waiter->expire(); });
+    }
+}
+
 bool AdapterBase::scan_is_active() { return is_scanning_; }
 
 std::vector<Peripheral> AdapterBase::scan_get_results() {
@@ -56,6 +174,46 @@ std::vector<Peripheral> AdapterBase::scan_get_results() {
     return peripherals;
 }
 
+ScanChanges AdapterBase::scan_get_changes(uint64_t since_version) {
+    auto table_changes = peripherals_.changes(since_version);
+
+    ScanChanges changes;
+    changes.version = table_changes.version;
+    changes.reset = table_changes.reset;
+    for (auto& peripheral : table_changes.added) {
+        changes.added.push_back(PeripheralBuilder(peripheral));
+    }
+    for (auto& peripheral : table_changes.updated) {
+        changes.updated.push_back(PeripheralBuilder(peripheral));
+    }
+    for (auto& peripheral : table_changes.lost) {
+        changes.lost.push_back(PeripheralBuilder(peripheral));
+    }
+    return changes;
+}
+
+void AdapterBase::set_scan_filter(ScanFilter const& filter) {
+    std::atomic_store(&scan_filter_matcher_, std::make_shared<const ScanFilterMatcher>(filter));
+}
+
+void AdapterBase::set_device_cache_limits(DeviceCacheLimits const& limits) {
+    // The plain backend only ever reports a single device, so there is nothing to evict.
+    device_cache_limits_ = limits;
+}
+
+DeviceCacheStats AdapterBase::device_cache_stats() {
+    DeviceCacheStats stats;
+    stats.cached_devices = peripherals_.size();
+    return stats;
+}
+
+void AdapterBase::set_operation_concurrency(size_t max_concurrent) {
+    // The plain backend has no real GATT traffic, so the setting is recorded but not enforced.
+    operation_scheduler_.set_max_concurrent(max_concurrent);
+}
+
+std::vector<OperationQueueStats> AdapterBase::operation_queue_stats() { return operation_scheduler_.stats(); }
+
 std::vector<Peripheral> AdapterBase::get_paired_peripherals() {
     std::vector<Peripheral> peripherals;
 
@@ -81,7 +239,7 @@ void AdapterBase::set_callback_on_scan_stop(std::function<void()> on_scan_stop)
     }
 }
 
-void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated) {
+void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t)> on_scan_updated) {
     if (on_scan_updated) {
         callback_on_scan_updated_.load(std::move(on_scan_updated));
     } else {
@@ -89,10 +247,21 @@ void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral)> o
     }
 }
 
-void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found) {
+void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral, uint64_t)> on_scan_found) {
     if (on_scan_found) {
         callback_on_scan_found_.load(std::move(on_scan_found));
     } else {
         callback_on_scan_found_.unload();
     }
 }
+
+void AdapterBase::set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const&)> on_scan_batch,
+                                             int interval_ms) {
+    std::shared_ptr<ScanBatcher> batcher;
+    if (on_scan_batch) {
+        batcher = std::make_shared<ScanBatcher>(std::move(on_scan_batch), std::chrono::milliseconds(interval_ms));
+    }
+
+    // Any previous batcher is stopped once the last advertisement being dispatched to it is done.
+    std::atomic_store(&scan_batcher_, batcher);
+}
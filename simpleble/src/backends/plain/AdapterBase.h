@@ -1,21 +1,30 @@
 #pragma once
 
+#include <simpleble/Adapter.h>
 #include <simpleble/Exceptions.h>
 #include <simpleble/Peripheral.h>
+#include <simpleble/ScanFilter.h>
 #include <simpleble/Types.h>
 
+#include "OperationScheduler.h"
+#include "ScanBatcher.h"
+#include "ScanFilterMatcher.h"
+#include "ScanResultTable.h"
+#include "ScanWaiter.h"
+
 #include <kvn_safe_callback.hpp>
 
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
 
 namespace SimpleBLE {
 
-class AdapterBase {
+class AdapterBase : public std::enable_shared_from_this<AdapterBase> {
   public:
     AdapterBase();
     virtual ~AdapterBase();
@@ -28,26 +37,66 @@ class AdapterBase {
     void scan_start();
     void scan_stop();
     void scan_for(int timeout_ms);
+    std::optional<Peripheral> scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms);
+    void scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                          std::function<void(std::optional<Peripheral>)> on_complete);
     bool scan_is_active();
     std::vector<Peripheral> scan_get_results();
+    ScanChanges scan_get_changes(uint64_t since_version);
 
     void set_callback_on_scan_start(std::function<void()> on_scan_start);
     void set_callback_on_scan_stop(std::function<void()> on_scan_stop);
-    void set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated);
-    void set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found);
+    void set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t)> on_scan_updated);
+    void set_callback_on_scan_found(std::function<void(Peripheral, uint64_t)> on_scan_found);
+    void set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const&)> on_scan_batch,
+                                    int interval_ms);
+
+    void set_scan_filter(ScanFilter const& filter);
+
+    void set_device_cache_limits(DeviceCacheLimits const& limits);
+    DeviceCacheStats device_cache_stats();
+
+    void set_operation_concurrency(size_t max_concurrent);
+    std::vector<OperationQueueStats> operation_queue_stats();
 
     std::vector<Peripheral> get_paired_peripherals();
 
     static bool bluetooth_enabled();
     static std::vector<std::shared_ptr<AdapterBase>> get_adapters();
 
+    // Lets the application drive the backend from its own event loop. Only supported on Linux.
+    static bool use_external_event_loop();
+    static int event_fd();
+    static void process_events();
+
+    // Spreads adapters over connections of their own. Only supported on Linux.
+    static bool use_dedicated_connections(size_t count);
+
   private:
+    void _scan_received_callback(advertising_data_t const& data, std::shared_ptr<PeripheralBase> peripheral);
+
     std::atomic_bool is_scanning_{false};
 
+    ScanResultTable<PeripheralBase> peripherals_;
+
+    DeviceCacheLimits device_cache_limits_;
+
+    // Only keeps the concurrency setting and reports empty queues, as operations are not scheduled here.
+    OperationScheduler operation_scheduler_;
+
+    // Accessed atomically, as it can be replaced while advertisements are being dispatched.
+    std::shared_ptr<const ScanFilterMatcher> scan_filter_matcher_;
+
+    // Set while a scan_until call is pending. Accessed atomically, as it is read while dispatching.
+    std::shared_ptr<ScanWaiter> scan_waiter_;
+
+    // Set while batched delivery is enabled. Accessed atomically, as it is read while dispatching.
+    std::shared_ptr<ScanBatcher> scan_batcher_;
+
     kvn::safe_callback<void()> callback_on_scan_start_;
     kvn::safe_callback<void()> callback_on_scan_stop_;
-    kvn::safe_callback<void(Peripheral)> callback_on_scan_updated_;
-    kvn::safe_callback<void(Peripheral)> callback_on_scan_found_;
+    kvn::safe_callback<void(Peripheral, uint64_t)> callback_on_scan_updated_;
+    kvn::safe_callback<void(Peripheral, uint64_t)> callback_on_scan_found_;
 };
 
 }  // namespace SimpleBLE
@@ -6,7 +6,10 @@
 
 #include <simpleble/Exceptions.h>
 #include <algorithm>
+#include "AsyncFallback.h"
+#include "BatchOperations.h"
 #include "CommonUtils.h"
+#include "DispatchThread.h"
 #include "LoggingInternal.h"
 
 using namespace SimpleBLE;
@@ -70,10 +73,16 @@ std::vector<Service> PeripheralBase::services() {
 
 std::vector<Service> PeripheralBase::advertised_services() { return {}; }
 
-std::map<uint16_t, ByteArray> PeripheralBase::manufacturer_data() { return {}; }
+std::map<uint16_t, ByteArray> PeripheralBase::manufacturer_data() { return {{0xFFFF, "\x01\x02\x03\x04"}}; }
 
 ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const& characteristic) { return {}; }
 
+ByteArray PeripheralBase::read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                      [[maybe_unused]] int max_age_ms) {
+    // No value cache is kept by this backend, so every read goes to the peripheral.
+    return read(service, characteristic);
+}
+
 void PeripheralBase::write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                                    ByteArray const& data) {}
 
@@ -81,13 +90,95 @@ void PeripheralBase::write_command(BluetoothUUID const& service, BluetoothUUID c
                                    ByteArray const& data) {}
 
 void PeripheralBase::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                            std::function<void(ByteArray payload)> callback) {}
+                            std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
+    // Emit a short, deterministic burst so that consumers can be exercised without hardware. Like a real event
+    // thread, the caller cannot be held up until the burst is consumed.
+    DispatchThreadScope dispatch_thread;
+    for (uint8_t i = 0; i < 10; i++) {
+        callback(ByteArray(1, static_cast<char>(i)), monotonic_timestamp_ns());
+    }
+}
 
 void PeripheralBase::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                              std::function<void(ByteArray payload)> callback) {}
+                              std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
+    notify(service, characteristic, std::move(callback));
+}
 
 void PeripheralBase::unsubscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic) {}
 
+std::vector<OperationResult> PeripheralBase::read_many(std::vector<ReadRequest> const& requests) {
+    return run_serially(requests, [this](ReadRequest const& request) {
+        return read(request.service, request.characteristic);
+    });
+}
+
+std::vector<OperationResult> PeripheralBase::write_many(std::vector<WriteRequest> const& requests) {
+    return run_serially(requests, [this](WriteRequest const& request) {
+        if (request.with_response) {
+            write_request(request.service, request.characteristic, request.data);
+        } else {
+            write_command(request.service, request.characteristic, request.data);
+        }
+    });
+}
+
+void PeripheralBase::connect_async(std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread([this]() { connect(); }, std::move(on_complete));
+}
+
+void PeripheralBase::read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                std::function<void(ByteArray value, std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            return read(service, characteristic);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, data]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            write_request(service, characteristic, data);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, data]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            write_command(service, characteristic, data);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                  std::function<void(ByteArray payload, uint64_t timestamp)> callback,
+                                  std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, callback]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            notify(service, characteristic, callback);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                       std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            unsubscribe(service, characteristic);
+        },
+        std::move(on_complete));
+}
+
 ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                                BluetoothUUID const& descriptor) {
     return {};
@@ -96,6 +187,12 @@ ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const
 void PeripheralBase::write(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                            BluetoothUUID const& descriptor, ByteArray const& data) {}
 
+void PeripheralBase::set_operation_priority([[maybe_unused]] BluetoothUUID const& service,
+                                            [[maybe_unused]] BluetoothUUID const& characteristic,
+                                            [[maybe_unused]] OperationPriority priority) {
+    // Operations are not scheduled by this backend, so there is nothing to prioritize.
+}
+
 void PeripheralBase::set_callback_on_connected(std::function<void()> on_connected) {
     if (on_connected) {
         callback_on_connected_.load(std::move(on_connected));
@@ -111,3 +208,5 @@ void PeripheralBase::set_callback_on_disconnected(std::function<void()> on_disco
         callback_on_disconnected_.unload();
     }
 }
+
+ScanUpdateState& PeripheralBase::scan_update_state() { return scan_update_state_; }
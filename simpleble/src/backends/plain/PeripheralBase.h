@@ -4,10 +4,14 @@
 #include <simpleble/Service.h>
 #include <simpleble/Types.h>
 
+#include "ScanFilterMatcher.h"
+
 #include <kvn_safe_callback.hpp>
 
 #include <atomic>
 #include <condition_variable>
+#include <exception>
+#include <functional>
 #include <map>
 #include <memory>
 
@@ -40,21 +44,42 @@ class PeripheralBase {
 
     // clang-format off
     ByteArray read(BluetoothUUID const& service, BluetoothUUID const& characteristic);
+    ByteArray read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic, int max_age_ms);
     void write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data);
     void write_command(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data);
-    void notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback);
-    void indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload)> callback);
+    void notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback);
+    void indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback);
     void unsubscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic);
 
     ByteArray read(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor);
     void write(BluetoothUUID const& service, BluetoothUUID const& characteristic, BluetoothUUID const& descriptor, ByteArray const& data);
     // clang-format on
 
+    std::vector<OperationResult> read_many(std::vector<ReadRequest> const& requests);
+    std::vector<OperationResult> write_many(std::vector<WriteRequest> const& requests);
+
+    // clang-format off
+    void connect_async(std::function<void(std::exception_ptr error)> on_complete);
+    void read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray value, std::exception_ptr error)> on_complete);
+    void write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete);
+    void write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete);
+    void notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(ByteArray payload, uint64_t timestamp)> callback, std::function<void(std::exception_ptr error)> on_complete);
+    void unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::function<void(std::exception_ptr error)> on_complete);
+    // clang-format on
+
+    void set_operation_priority(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                OperationPriority priority);
+
     void set_callback_on_connected(std::function<void()> on_connected);
     void set_callback_on_disconnected(std::function<void()> on_disconnected);
 
+    // Only accessed from the thread dispatching scan results.
+    ScanUpdateState& scan_update_state();
+
   private:
     std::atomic_bool connected_{false};
+
+    ScanUpdateState scan_update_state_;
     std::atomic_bool paired_{false};
 
     kvn::safe_callback<void()> callback_on_connected_;
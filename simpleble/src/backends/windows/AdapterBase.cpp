@@ -5,6 +5,7 @@
 #include "CommonUtils.h"
 #include "LoggingInternal.h"
 #include "PeripheralBuilder.h"
+#include "TimerQueue.h"
 #include "Utils.h"
 
 #include "winrt/Windows.Devices.Bluetooth.h"
@@ -124,6 +125,7 @@ AdapterBase::AdapterBase(std::string device_id)
             auto service_data = args.Advertisement().ServiceUuids();
             for (auto& service_guid : service_data) {
                 std::string service_uuid = guid_to_uuid(service_guid);
+                data.service_uuids.push_back(service_uuid);
                 data.service_data.emplace(std::make_pair(service_uuid, ByteArray()));
             }
 
@@ -166,6 +168,14 @@ bool AdapterBase::bluetooth_enabled() {
     return enabled;
 }
 
+bool AdapterBase::use_external_event_loop() { return false; }
+
+int AdapterBase::event_fd() { return -1; }
+
+void AdapterBase::process_events() {}
+
+bool AdapterBase::use_dedicated_connections([[maybe_unused]] size_t count) { return false; }
+
 std::vector<std::shared_ptr<AdapterBase>> AdapterBase::get_adapters() {
     initialize_winrt();
 
@@ -207,6 +217,12 @@ void AdapterBase::scan_stop() {
         // Scan did not stop, this can be because some other process
         // is using the adapter.
     }
+
+    // Deliver what is left of the current batch right away.
+    auto batcher = std::atomic_load(&this->scan_batcher_);
+    if (batcher) {
+        batcher->flush();
+    }
 }
 
 void AdapterBase::scan_for(int timeout_ms) {
@@ -215,6 +231,62 @@ void AdapterBase::scan_for(int timeout_ms) {
     scan_stop();
 }
 
+std::optional<Peripheral> AdapterBase::scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    std::atomic_store(&scan_waiter_, waiter);
+
+    // A scan started by the user is joined and left running.
+    bool owns_scan = !scan_is_active();
+    if (owns_scan) {
+        scan_start();
+    }
+    auto match = waiter->wait(timeout_ms);
+
+    // Stop as soon as the waiter returns, so that no time is spent scanning past the first match.
+    std::atomic_store(&scan_waiter_, std::shared_ptr<ScanWaiter>());
+    if (owns_scan) {
+        scan_stop();
+    }
+
+    return match;
+}
+
+void AdapterBase::scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                                   std::function<void(std::optional<Peripheral>)> on_complete) {
+    auto waiter = std::make_shared<ScanWaiter>(std::move(predicate));
+    bool owns_scan = !scan_is_active();
+
+    // The waiter settles on the thread dispatching advertisements, so the scan is stopped from the timer thread.
+    // The adapter may be gone by then, in which case there is no scan left to stop.
+    std::weak_ptr<AdapterBase> weak_this = weak_from_this();
+    waiter->on_settled([weak_this, waiter, owns_scan, on_complete](std::optional<Peripheral> match) {
+        TimerQueue::shared().schedule(0, [weak_this, waiter, owns_scan, on_complete, match]() {
+            if (auto self = weak_this.lock()) {
+                std::shared_ptr<ScanWaiter> expected = waiter;
+                bool current = std::atomic_compare_exchange_strong(&self->scan_waiter_, &expected,
+                                                                   std::shared_ptr<ScanWaiter>());
+                if (current && owns_scan) {
+                    try {
+                        self->scan_stop();
+                    } catch (...) {
+                        // Failing to stop the scan does not change the outcome of the search.
+                    }
+                }
+            }
+            on_complete(match);
+        });
+    });
+    std::atomic_store(&scan_waiter_, waiter);
+
+    if (owns_scan) {
+        scan_start();
+    }
+
+    if (timeout_ms >= 0) {
+        TimerQueue::shared().schedule(timeout_ms, [waiter]() { waiter->expire(); });
+    }
+}
+
 bool AdapterBase::scan_is_active() { return scan_is_active_; }
 
 std::vector<Peripheral> AdapterBase::scan_get_results() {
@@ -227,6 +299,14 @@ std::vector<Peripheral> AdapterBase::scan_get_results() {
     return peripherals;
 }
 
+ScanChanges AdapterBase::scan_get_changes([[maybe_unused]] uint64_t since_version) {
+    // No versioned results table on this platform, so every call is a full refresh.
+    ScanChanges changes;
+    changes.reset = true;
+    changes.added = scan_get_results();
+    return changes;
+}
+
 std::vector<Peripheral> AdapterBase::get_paired_peripherals() { return {}; }
 
 void AdapterBase::set_callback_on_scan_start(std::function<void()> on_scan_start) {
@@ -245,7 +325,7 @@ void AdapterBase::set_callback_on_scan_stop(std::function<void()> on_scan_stop)
     }
 }
 
-void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated) {
+void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t)> on_scan_updated) {
     if (on_scan_updated) {
         callback_on_scan_updated_.load(on_scan_updated);
     } else {
@@ -253,7 +333,7 @@ void AdapterBase::set_callback_on_scan_updated(std::function<void(Peripheral)> o
     }
 }
 
-void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found) {
+void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral, uint64_t)> on_scan_found) {
     if (on_scan_found) {
         callback_on_scan_found_.load(on_scan_found);
     } else {
@@ -261,6 +341,30 @@ void AdapterBase::set_callback_on_scan_found(std::function<void(Peripheral)> on_
     }
 }
 
+void AdapterBase::set_scan_filter(ScanFilter const& filter) {
+    std::atomic_store(&scan_filter_matcher_, std::make_shared<const ScanFilterMatcher>(filter));
+}
+
+void AdapterBase::set_device_cache_limits(DeviceCacheLimits const& limits) {
+    // Windows owns the device cache, so the limits are recorded but not enforced.
+    device_cache_limits_ = limits;
+}
+
+DeviceCacheStats AdapterBase::device_cache_stats() {
+    std::lock_guard<std::mutex> lock(scan_update_mutex_);
+
+    DeviceCacheStats stats;
+    stats.cached_devices = peripherals_.size();
+    return stats;
+}
+
+void AdapterBase::set_operation_concurrency(size_t max_concurrent) {
+    // WinRT queues GATT operations itself, so the setting is recorded but not enforced.
+    operation_scheduler_.set_max_concurrent(max_concurrent);
+}
+
+std::vector<OperationQueueStats> AdapterBase::operation_queue_stats() { return operation_scheduler_.stats(); }
+
 // Private functions
 
 void AdapterBase::_scan_stopped_callback() {
@@ -272,6 +376,14 @@ void AdapterBase::_scan_stopped_callback() {
 }
 
 void AdapterBase::_scan_received_callback(advertising_data_t data) {
+    uint64_t timestamp = monotonic_timestamp_ns();
+
+    auto matcher = std::atomic_load(&scan_filter_matcher_);
+    AdvertisingDataScanSource source{data};
+    if (matcher && !matcher->matches(source)) {
+        return;
+    }
+
     if (this->peripherals_.count(data.mac_address) == 0) {
         // If the incoming peripheral has never been seen before, create and save a reference to it.
         auto base_peripheral = std::make_shared<PeripheralBase>(data);
@@ -285,12 +397,35 @@ void AdapterBase::_scan_received_callback(advertising_data_t data) {
     // Convert the base object into an external-facing Peripheral object
     PeripheralBuilder peripheral_builder(base_peripheral);
 
+    // Hand the peripheral to a pending scan_until call before anything else is reported.
+    auto waiter = std::atomic_load(&this->scan_waiter_);
+    if (waiter) {
+        waiter->offer(peripheral_builder);
+    }
+
     // Check if the device has been seen before, to forward the correct call to the user.
-    if (this->seen_peripherals_.count(data.mac_address) == 0) {
+    bool first_seen = this->seen_peripherals_.count(data.mac_address) == 0;
+    if (first_seen) {
         // Store it in our table of seen peripherals
         this->seen_peripherals_.insert(std::make_pair(data.mac_address, base_peripheral));
-        SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder);
+        SAFE_CALLBACK_CALL(this->callback_on_scan_found_, peripheral_builder, timestamp);
     } else {
-        SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder);
+        SAFE_CALLBACK_CALL(this->callback_on_scan_updated_, peripheral_builder, timestamp);
     }
+
+    auto batcher = std::atomic_load(&this->scan_batcher_);
+    if (batcher) {
+        batcher->push(std::hash<BluetoothAddress>{}(data.mac_address), peripheral_builder, first_seen, timestamp);
+    }
+}
+
+void AdapterBase::set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const&)> on_scan_batch,
+                                             int interval_ms) {
+    std::shared_ptr<ScanBatcher> batcher;
+    if (on_scan_batch) {
+        batcher = std::make_shared<ScanBatcher>(std::move(on_scan_batch), std::chrono::milliseconds(interval_ms));
+    }
+
+    // Any previous batcher is stopped once the last advertisement being dispatched to it is done.
+    std::atomic_store(&scan_batcher_, batcher);
 }
@@ -2,6 +2,8 @@
 #pragma comment(lib, "windowsapp")
 
 #include "PeripheralBase.h"
+#include "AsyncFallback.h"
+#include "BatchOperations.h"
 #include "CommonUtils.h"
 #include "Utils.h"
 
@@ -181,6 +183,12 @@ ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const
     return ibuffer_to_bytearray(result.Value());
 }
 
+ByteArray PeripheralBase::read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                      [[maybe_unused]] int max_age_ms) {
+    // No value cache is kept by this backend, so every read goes to the peripheral.
+    return read(service, characteristic);
+}
+
 void PeripheralBase::write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                                    ByteArray const& data) {
     GattCharacteristic gatt_characteristic = _fetch_characteristic(service, characteristic).obj;
@@ -222,13 +230,13 @@ void PeripheralBase::write_command(BluetoothUUID const& service, BluetoothUUID c
 }
 
 void PeripheralBase::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                            std::function<void(ByteArray payload)> callback) {
+                            std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
     _subscribe(service, characteristic, std::move(callback), GattCharacteristicProperties::Notify,
                GattClientCharacteristicConfigurationDescriptorValue::Notify);
 }
 
 void PeripheralBase::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                              std::function<void(ByteArray payload)> callback) {
+                              std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
     _subscribe(service, characteristic, std::move(callback), GattCharacteristicProperties::Indicate,
                GattClientCharacteristicConfigurationDescriptorValue::Indicate);
 }
@@ -252,6 +260,79 @@ void PeripheralBase::unsubscribe(BluetoothUUID const& service, BluetoothUUID con
     }
 }
 
+std::vector<OperationResult> PeripheralBase::read_many(std::vector<ReadRequest> const& requests) {
+    return run_serially(requests, [this](ReadRequest const& request) {
+        return read(request.service, request.characteristic);
+    });
+}
+
+std::vector<OperationResult> PeripheralBase::write_many(std::vector<WriteRequest> const& requests) {
+    return run_serially(requests, [this](WriteRequest const& request) {
+        if (request.with_response) {
+            write_request(request.service, request.characteristic, request.data);
+        } else {
+            write_command(request.service, request.characteristic, request.data);
+        }
+    });
+}
+
+void PeripheralBase::connect_async(std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread([this]() { connect(); }, std::move(on_complete));
+}
+
+void PeripheralBase::read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                std::function<void(ByteArray value, std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            return read(service, characteristic);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, data]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            write_request(service, characteristic, data);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         ByteArray const& data,
+                                         std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, data]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            write_command(service, characteristic, data);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                  std::function<void(ByteArray payload, uint64_t timestamp)> callback,
+                                  std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic, callback]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            notify(service, characteristic, callback);
+        },
+        std::move(on_complete));
+}
+
+void PeripheralBase::unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                       std::function<void(std::exception_ptr error)> on_complete) {
+    run_on_helper_thread(
+        [this, service, characteristic]() {
+            if (!is_connected()) throw Exception::NotConnected();
+            unsubscribe(service, characteristic);
+        },
+        std::move(on_complete));
+}
+
 ByteArray PeripheralBase::read(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                                BluetoothUUID const& descriptor) {
     GattDescriptor gatt_descriptor = _fetch_descriptor(service, characteristic, descriptor);
@@ -278,6 +359,12 @@ void PeripheralBase::write(BluetoothUUID const& service, BluetoothUUID const& ch
     }
 }
 
+void PeripheralBase::set_operation_priority([[maybe_unused]] BluetoothUUID const& service,
+                                            [[maybe_unused]] BluetoothUUID const& characteristic,
+                                            [[maybe_unused]] OperationPriority priority) {
+    // Operations are not scheduled by this backend, so there is nothing to prioritize.
+}
+
 void PeripheralBase::set_callback_on_connected(std::function<void()> on_connected) {
     if (on_connected) {
         callback_on_connected_.load(std::move(on_connected));
@@ -297,7 +384,8 @@ void PeripheralBase::set_callback_on_disconnected(std::function<void()> on_disco
 // Private methods
 
 void PeripheralBase::_subscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic,
-                                std::function<void(ByteArray payload)> callback, GattCharacteristicProperties property,
+                                std::function<void(ByteArray payload, uint64_t timestamp)> callback,
+                                GattCharacteristicProperties property,
                                 GattClientCharacteristicConfigurationDescriptorValue descriptor_value) {
     gatt_characteristic_t& gatt_characteristic_holder = _fetch_characteristic(service, characteristic);
     GattCharacteristic gatt_characteristic = gatt_characteristic_holder.obj;
@@ -318,9 +406,11 @@ void PeripheralBase::_subscribe(BluetoothUUID const& service, BluetoothUUID cons
 
     gatt_characteristic_holder.value_changed_callback = [=](const GattCharacteristic& sender,
                                                             const GattValueChangedEventArgs& args) {
+        uint64_t timestamp = monotonic_timestamp_ns();
+
         // Convert the payload to a ByteArray.
         ByteArray payload = ibuffer_to_bytearray(args.CharacteristicValue());
-        callback(payload);
+        callback(payload, timestamp);
     };
 
     // Register the callback.
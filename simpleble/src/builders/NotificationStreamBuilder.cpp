@@ -0,0 +1,23 @@
+#include "NotificationStreamBuilder.h"
+
+#include "NotificationStreamBase.h"
+
+using namespace SimpleBLE;
+
+NotificationStreamBuilder::NotificationStreamBuilder(NotificationStream::Options const& options)
+    : queue_(std::make_shared<NotificationStreamBase>(options)) {
+    // The handles given to the user share an ownership of their own, which closes the stream once the last one is
+    // gone. A delivering thread holds the queue alive on its own, so it would otherwise never be woken up.
+    std::shared_ptr<NotificationStreamBase> queue = queue_;
+    internal_ = std::shared_ptr<NotificationStreamBase>(queue.get(), [queue](NotificationStreamBase*) { queue->close(); });
+}
+
+std::function<void(ByteArray payload, uint64_t timestamp)> NotificationStreamBuilder::sink() const {
+    std::weak_ptr<NotificationStreamBase> weak_internal = queue_;
+    return [weak_internal](ByteArray payload, uint64_t) {
+        auto internal = weak_internal.lock();
+        if (internal) {
+            internal->push(std::move(payload));
+        }
+    };
+}
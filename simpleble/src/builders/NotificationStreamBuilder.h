@@ -0,0 +1,35 @@
+#pragma once
+
+#include <simpleble/NotificationStream.h>
+
+#include <functional>
+#include <memory>
+
+namespace SimpleBLE {
+
+/**
+ * @brief Helper class to build a NotificationStream object.
+ *
+ * @details This class provides access to the protected properties of NotificationStream
+ *          and acts as a constructor, avoiding the need to expose any unneeded
+ *          functions to the user.
+ *
+ */
+class NotificationStreamBuilder : public NotificationStream {
+  public:
+    NotificationStreamBuilder(NotificationStream::Options const& options);
+    virtual ~NotificationStreamBuilder() = default;
+
+    /**
+     * @brief Provides a callback that feeds payloads into the stream.
+     *
+     * @details The callback only holds a weak reference to the stream, so it can
+     *          safely outlive it.
+     */
+    std::function<void(ByteArray payload, uint64_t timestamp)> sink() const;
+
+  private:
+    std::shared_ptr<NotificationStreamBase> queue_;
+};
+
+}  // namespace SimpleBLE
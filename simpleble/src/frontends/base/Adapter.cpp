@@ -3,6 +3,7 @@
 #include "AdapterBase.h"
 #include "AdapterBuilder.h"
 #include "LoggingInternal.h"
+#include "TimerQueue.h"
 
 using namespace SimpleBLE;
 
@@ -20,6 +21,14 @@ std::vector<Adapter> Adapter::get_adapters() {
 
 bool Adapter::bluetooth_enabled() { return AdapterBase::bluetooth_enabled(); }
 
+bool Adapter::use_external_event_loop() { return AdapterBase::use_external_event_loop(); }
+
+int Adapter::event_fd() { return AdapterBase::event_fd(); }
+
+void Adapter::process_events() { AdapterBase::process_events(); }
+
+bool Adapter::use_dedicated_connections(size_t count) { return AdapterBase::use_dedicated_connections(count); }
+
 bool Adapter::initialized() const { return internal_ != nullptr; }
 
 void* Adapter::underlying() const {
@@ -67,6 +76,85 @@ void Adapter::scan_for(int timeout_ms) {
     internal_->scan_for(timeout_ms);
 }
 
+std::future<void> Adapter::scan_for_async(int timeout_ms) {
+    auto promise = std::make_shared<std::promise<void>>();
+    scan_for_async(timeout_ms, [promise](std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value();
+        }
+    });
+    return promise->get_future();
+}
+
+void Adapter::scan_for_async(int timeout_ms, std::function<void(std::exception_ptr error)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!bluetooth_enabled()) {
+        SIMPLEBLE_LOG_WARN(fmt::format("Bluetooth is not enabled."));
+        on_complete(nullptr);
+        return;
+    }
+
+    internal_->scan_start();
+
+    // The scan is stopped from the timer thread instead of a thread sleeping through the timeout.
+    auto internal = internal_;
+    TimerQueue::shared().schedule(timeout_ms, [internal, on_complete]() {
+        std::exception_ptr error;
+        try {
+            internal->scan_stop();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        on_complete(error);
+    });
+}
+
+std::optional<Peripheral> Adapter::scan_until(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                                              bool connect) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!bluetooth_enabled()) {
+        SIMPLEBLE_LOG_WARN(fmt::format("Bluetooth is not enabled."));
+        return std::nullopt;
+    }
+
+    auto peripheral = internal_->scan_until(std::move(predicate), timeout_ms);
+    if (peripheral.has_value() && connect) {
+        // The match is returned even if connecting to it fails, as it could not be found again otherwise.
+        try {
+            peripheral->connect();
+        } catch (std::exception const& e) {
+            SIMPLEBLE_LOG_WARN(fmt::format("Failed to connect to {}: {}", peripheral->address(), e.what()));
+        }
+    }
+    return peripheral;
+}
+
+std::future<std::optional<Peripheral>> Adapter::scan_until_async(std::function<bool(Peripheral)> predicate,
+                                                                 int timeout_ms) {
+    auto promise = std::make_shared<std::promise<std::optional<Peripheral>>>();
+    scan_until_async(std::move(predicate), timeout_ms,
+                     [promise](std::optional<Peripheral> peripheral) { promise->set_value(std::move(peripheral)); });
+    return promise->get_future();
+}
+
+void Adapter::scan_until_async(std::function<bool(Peripheral)> predicate, int timeout_ms,
+                               std::function<void(std::optional<Peripheral> peripheral)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!bluetooth_enabled()) {
+        SIMPLEBLE_LOG_WARN(fmt::format("Bluetooth is not enabled."));
+        on_complete(std::nullopt);
+        return;
+    }
+
+    auto internal = internal_;
+    internal_->scan_until_async(std::move(predicate), timeout_ms,
+                                [internal, on_complete](std::optional<Peripheral> peripheral) {
+                                    on_complete(std::move(peripheral));
+                                });
+}
+
 bool Adapter::scan_is_active() {
     if (!initialized()) throw Exception::NotInitialized();
 
@@ -79,12 +167,55 @@ std::vector<Peripheral> Adapter::scan_get_results() {
     return internal_->scan_get_results();
 }
 
+ScanChanges Adapter::scan_get_changes(uint64_t since_version) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->scan_get_changes(since_version);
+}
+
+void Adapter::set_callback_on_scan_batch(std::function<void(std::vector<ScanEvent> const& events)> on_scan_batch,
+                                         int interval_ms) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_callback_on_scan_batch(std::move(on_scan_batch), interval_ms);
+}
+
+void Adapter::set_device_cache_limits(DeviceCacheLimits const& limits) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_device_cache_limits(limits);
+}
+
+DeviceCacheStats Adapter::device_cache_stats() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->device_cache_stats();
+}
+
+void Adapter::set_operation_concurrency(size_t max_concurrent) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_operation_concurrency(max_concurrent);
+}
+
+std::vector<OperationQueueStats> Adapter::operation_queue_stats() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->operation_queue_stats();
+}
+
 std::vector<Peripheral> Adapter::get_paired_peripherals() {
     if (!initialized()) throw Exception::NotInitialized();
 
     return internal_->get_paired_peripherals();
 }
 
+void Adapter::set_scan_filter(ScanFilter const& filter) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_scan_filter(filter);
+}
+
 void Adapter::set_callback_on_scan_start(std::function<void()> on_scan_start) {
     if (!initialized()) throw Exception::NotInitialized();
 
@@ -100,11 +231,41 @@ void Adapter::set_callback_on_scan_stop(std::function<void()> on_scan_stop) {
 void Adapter::set_callback_on_scan_updated(std::function<void(Peripheral)> on_scan_updated) {
     if (!initialized()) throw Exception::NotInitialized();
 
-    internal_->set_callback_on_scan_updated(std::move(on_scan_updated));
+    if (on_scan_updated) {
+        internal_->set_callback_on_scan_updated(
+            [on_scan_updated](Peripheral peripheral, uint64_t) { on_scan_updated(peripheral); });
+    } else {
+        internal_->set_callback_on_scan_updated(nullptr);
+    }
 }
 
 void Adapter::set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found) {
     if (!initialized()) throw Exception::NotInitialized();
 
+    if (on_scan_found) {
+        internal_->set_callback_on_scan_found(
+            [on_scan_found](Peripheral peripheral, uint64_t) { on_scan_found(peripheral); });
+    } else {
+        internal_->set_callback_on_scan_found(nullptr);
+    }
+}
+
+void Adapter::set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t timestamp)> on_scan_updated) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_callback_on_scan_updated(std::move(on_scan_updated));
+}
+
+void Adapter::set_callback_on_scan_found(std::function<void(Peripheral, uint64_t timestamp)> on_scan_found) {
+    if (!initialized()) throw Exception::NotInitialized();
+
     internal_->set_callback_on_scan_found(std::move(on_scan_found));
 }
+
+void Adapter::set_callback_on_scan_updated(std::nullptr_t) {
+    set_callback_on_scan_updated(std::function<void(Peripheral, uint64_t timestamp)>());
+}
+
+void Adapter::set_callback_on_scan_found(std::nullptr_t) {
+    set_callback_on_scan_found(std::function<void(Peripheral, uint64_t timestamp)>());
+}
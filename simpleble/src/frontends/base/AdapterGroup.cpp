@@ -0,0 +1,82 @@
+#include <simpleble/AdapterGroup.h>
+
+#include <simpleble/Exceptions.h>
+#include "AdapterGroupBase.h"
+
+using namespace SimpleBLE;
+
+AdapterGroup::AdapterGroup(std::vector<Adapter> adapters) {
+    for (auto& adapter : adapters) {
+        if (!adapter.initialized()) throw Exception::NotInitialized();
+    }
+
+    internal_ = std::make_shared<AdapterGroupBase>(adapters, false);
+}
+
+AdapterGroup AdapterGroup::all() {
+    AdapterGroup group;
+    group.internal_ = std::make_shared<AdapterGroupBase>(Adapter::get_adapters(), true);
+    return group;
+}
+
+bool AdapterGroup::initialized() const { return internal_ != nullptr; }
+
+std::vector<Adapter> AdapterGroup::adapters() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->adapters();
+}
+
+void AdapterGroup::scan_start() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->scan_start();
+}
+
+void AdapterGroup::scan_stop() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->scan_stop();
+}
+
+void AdapterGroup::scan_for(int timeout_ms) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->scan_for(timeout_ms);
+}
+
+bool AdapterGroup::scan_is_active() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->scan_is_active();
+}
+
+std::vector<Peripheral> AdapterGroup::scan_get_results() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->scan_get_results();
+}
+
+void AdapterGroup::set_callback_on_scan_found(std::function<void(Peripheral)> on_scan_found) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_callback_on_scan_found(std::move(on_scan_found));
+}
+
+Peripheral AdapterGroup::connect(BluetoothAddress const& address) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->connect(address);
+}
+
+std::vector<Peripheral> AdapterGroup::refresh() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->refresh();
+}
+
+std::vector<AdapterGroup::AdapterLoad> AdapterGroup::load() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->load();
+}
@@ -0,0 +1,84 @@
+#include <simpleble/ConnectionManager.h>
+
+#include <simpleble/Exceptions.h>
+#include "ConnectionManagerBase.h"
+
+using namespace SimpleBLE;
+
+ConnectionManager::ConnectionManager(Adapter adapter) : ConnectionManager(adapter, Options()) {}
+
+ConnectionManager::ConnectionManager(Adapter adapter, Options const& options) {
+    if (!adapter.initialized()) throw Exception::NotInitialized();
+
+    internal_ = std::make_shared<ConnectionManagerBase>(adapter, options);
+}
+
+bool ConnectionManager::initialized() const { return internal_ != nullptr; }
+
+void ConnectionManager::add(BluetoothAddress const& address) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->add(address);
+}
+
+void ConnectionManager::remove(BluetoothAddress const& address) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->remove(address);
+}
+
+std::vector<BluetoothAddress> ConnectionManager::targets() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->targets();
+}
+
+void ConnectionManager::start() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->start();
+}
+
+void ConnectionManager::stop() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->stop();
+}
+
+bool ConnectionManager::is_connected(BluetoothAddress const& address) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->is_connected(address);
+}
+
+std::optional<Peripheral> ConnectionManager::peripheral(BluetoothAddress const& address) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->peripheral(address);
+}
+
+void ConnectionManager::notify(BluetoothAddress const& address, BluetoothUUID const& service,
+                               BluetoothUUID const& characteristic,
+                               std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->notify(address, service, characteristic, std::move(callback));
+}
+
+void ConnectionManager::set_callback_on_connected(std::function<void(Peripheral)> on_connected) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_callback_on_connected(std::move(on_connected));
+}
+
+void ConnectionManager::set_callback_on_disconnected(std::function<void(Peripheral)> on_disconnected) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_callback_on_disconnected(std::move(on_disconnected));
+}
+
+ConnectionManager::Stats ConnectionManager::stats() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->stats();
+}
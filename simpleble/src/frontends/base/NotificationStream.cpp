@@ -0,0 +1,62 @@
+#include <simpleble/NotificationStream.h>
+
+#include <simpleble/Exceptions.h>
+#include "NotificationStreamBase.h"
+
+using namespace SimpleBLE;
+
+bool NotificationStream::initialized() const { return internal_ != nullptr; }
+
+std::optional<ByteArray> NotificationStream::next(int timeout_ms) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->next(timeout_ms);
+}
+
+std::vector<ByteArray> NotificationStream::drain(size_t max) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->drain(max);
+}
+
+void NotificationStream::close() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->close();
+}
+
+bool NotificationStream::is_closed() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->is_closed();
+}
+
+size_t NotificationStream::size() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->size();
+}
+
+size_t NotificationStream::capacity() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->capacity();
+}
+
+uint64_t NotificationStream::received() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->received();
+}
+
+uint64_t NotificationStream::dropped() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->dropped();
+}
+
+size_t NotificationStream::high_water_mark() {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    return internal_->high_water_mark();
+}
@@ -1,10 +1,22 @@
 #include <simpleble/Peripheral.h>
 
 #include <simpleble/Exceptions.h>
+#include "NotificationStreamBuilder.h"
 #include "PeripheralBase.h"
 
 using namespace SimpleBLE;
 
+// Completion handler that settles a promise with the outcome of an operation.
+static std::function<void(std::exception_ptr)> complete_promise(std::shared_ptr<std::promise<void>> promise) {
+    return [promise](std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value();
+        }
+    };
+}
+
 bool Peripheral::initialized() const { return internal_ != nullptr; }
 
 void* Peripheral::underlying() const {
@@ -110,6 +122,129 @@ ByteArray Peripheral::read(BluetoothUUID const& service, BluetoothUUID const& ch
     return internal_->read(service, characteristic);
 }
 
+ByteArray Peripheral::read_cached(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                  int max_age_ms) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!is_connected()) throw Exception::NotConnected();
+
+    return internal_->read_cached(service, characteristic, max_age_ms);
+}
+
+std::vector<OperationResult> Peripheral::read_many(std::vector<ReadRequest> const& requests) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!is_connected()) throw Exception::NotConnected();
+
+    return internal_->read_many(requests);
+}
+
+std::vector<OperationResult> Peripheral::write_many(std::vector<WriteRequest> const& requests) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!is_connected()) throw Exception::NotConnected();
+
+    return internal_->write_many(requests);
+}
+
+std::future<void> Peripheral::connect_async() {
+    auto promise = std::make_shared<std::promise<void>>();
+    connect_async(complete_promise(promise));
+    return promise->get_future();
+}
+
+std::future<ByteArray> Peripheral::read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic) {
+    auto promise = std::make_shared<std::promise<ByteArray>>();
+    read_async(service, characteristic, [promise](ByteArray value, std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(std::move(value));
+        }
+    });
+    return promise->get_future();
+}
+
+std::future<void> Peripheral::write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                                  ByteArray const& data) {
+    auto promise = std::make_shared<std::promise<void>>();
+    write_request_async(service, characteristic, data, complete_promise(promise));
+    return promise->get_future();
+}
+
+std::future<void> Peripheral::write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                                  ByteArray const& data) {
+    auto promise = std::make_shared<std::promise<void>>();
+    write_command_async(service, characteristic, data, complete_promise(promise));
+    return promise->get_future();
+}
+
+std::future<void> Peripheral::notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                           std::function<void(ByteArray payload)> callback) {
+    auto promise = std::make_shared<std::promise<void>>();
+    notify_async(service, characteristic, std::move(callback), complete_promise(promise));
+    return promise->get_future();
+}
+
+std::future<void> Peripheral::unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic) {
+    auto promise = std::make_shared<std::promise<void>>();
+    unsubscribe_async(service, characteristic, complete_promise(promise));
+    return promise->get_future();
+}
+
+void Peripheral::connect_async(std::function<void(std::exception_ptr error)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    // The backend object is kept alive until the operation has completed.
+    auto internal = internal_;
+    internal_->connect_async([internal, on_complete](std::exception_ptr error) { on_complete(error); });
+}
+
+void Peripheral::read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                            std::function<void(ByteArray value, std::exception_ptr error)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    auto internal = internal_;
+    internal_->read_async(service, characteristic, [internal, on_complete](ByteArray value, std::exception_ptr error) {
+        on_complete(std::move(value), error);
+    });
+}
+
+void Peripheral::write_request_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                     ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    auto internal = internal_;
+    internal_->write_request_async(service, characteristic, data,
+                                   [internal, on_complete](std::exception_ptr error) { on_complete(error); });
+}
+
+void Peripheral::write_command_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                     ByteArray const& data, std::function<void(std::exception_ptr error)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    auto internal = internal_;
+    internal_->write_command_async(service, characteristic, data,
+                                   [internal, on_complete](std::exception_ptr error) { on_complete(error); });
+}
+
+void Peripheral::notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                              std::function<void(ByteArray payload)> callback,
+                              std::function<void(std::exception_ptr error)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    auto internal = internal_;
+    internal_->notify_async(
+        service, characteristic, [callback](ByteArray payload, uint64_t) { callback(payload); },
+        [internal, on_complete](std::exception_ptr error) { on_complete(error); });
+}
+
+void Peripheral::unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                   std::function<void(std::exception_ptr error)> on_complete) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    auto internal = internal_;
+    internal_->unsubscribe_async(service, characteristic,
+                                 [internal, on_complete](std::exception_ptr error) { on_complete(error); });
+}
+
 void Peripheral::write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                                ByteArray const& data) {
     if (!initialized()) throw Exception::NotInitialized();
@@ -131,7 +266,7 @@ void Peripheral::notify(BluetoothUUID const& service, BluetoothUUID const& chara
     if (!initialized()) throw Exception::NotInitialized();
     if (!is_connected()) throw Exception::NotConnected();
 
-    internal_->notify(service, characteristic, std::move(callback));
+    internal_->notify(service, characteristic, [callback](ByteArray payload, uint64_t) { callback(payload); });
 }
 
 void Peripheral::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
@@ -139,9 +274,53 @@ void Peripheral::indicate(BluetoothUUID const& service, BluetoothUUID const& cha
     if (!initialized()) throw Exception::NotInitialized();
     if (!is_connected()) throw Exception::NotConnected();
 
+    internal_->indicate(service, characteristic, [callback](ByteArray payload, uint64_t) { callback(payload); });
+}
+
+void Peripheral::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                        std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!is_connected()) throw Exception::NotConnected();
+
+    internal_->notify(service, characteristic, std::move(callback));
+}
+
+void Peripheral::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                          std::function<void(ByteArray payload, uint64_t timestamp)> callback) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!is_connected()) throw Exception::NotConnected();
+
     internal_->indicate(service, characteristic, std::move(callback));
 }
 
+void Peripheral::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::nullptr_t) {
+    notify(service, characteristic, [](ByteArray, uint64_t) {});
+}
+
+void Peripheral::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic, std::nullptr_t) {
+    indicate(service, characteristic, [](ByteArray, uint64_t) {});
+}
+
+NotificationStream Peripheral::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                     NotificationStream::Options const& options) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!is_connected()) throw Exception::NotConnected();
+
+    NotificationStreamBuilder stream(options);
+    internal_->notify(service, characteristic, stream.sink());
+    return stream;
+}
+
+NotificationStream Peripheral::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                       NotificationStream::Options const& options) {
+    if (!initialized()) throw Exception::NotInitialized();
+    if (!is_connected()) throw Exception::NotConnected();
+
+    NotificationStreamBuilder stream(options);
+    internal_->indicate(service, characteristic, stream.sink());
+    return stream;
+}
+
 void Peripheral::unsubscribe(BluetoothUUID const& service, BluetoothUUID const& characteristic) {
     if (!initialized()) throw Exception::NotInitialized();
     if (!is_connected()) throw Exception::NotConnected();
@@ -165,6 +344,13 @@ void Peripheral::write(BluetoothUUID const& service, BluetoothUUID const& charac
     internal_->write(service, characteristic, descriptor, data);
 }
 
+void Peripheral::set_operation_priority(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                        OperationPriority priority) {
+    if (!initialized()) throw Exception::NotInitialized();
+
+    internal_->set_operation_priority(service, characteristic, priority);
+}
+
 void Peripheral::set_callback_on_connected(std::function<void()> on_connected) {
     if (!initialized()) throw Exception::NotInitialized();
 
@@ -45,6 +45,55 @@ bool SimpleBLE::Safe::Adapter::scan_for(int timeout_ms) noexcept {
     }
 }
 
+bool SimpleBLE::Safe::Adapter::scan_for_async(int timeout_ms, std::function<void(bool success)> on_complete) noexcept {
+    try {
+        SimpleBLE::Adapter::scan_for_async(timeout_ms,
+                                           [on_complete](std::exception_ptr error) { on_complete(!error); });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+std::optional<SimpleBLE::Safe::Peripheral> SimpleBLE::Safe::Adapter::scan_until(
+    std::function<bool(SimpleBLE::Safe::Peripheral)> predicate, int timeout_ms, bool connect) noexcept {
+    try {
+        auto peripheral = SimpleBLE::Adapter::scan_until(
+            [=](SimpleBLE::Peripheral p) { return predicate(SimpleBLE::Safe::Peripheral(p)); }, timeout_ms);
+        if (!peripheral.has_value()) {
+            return std::nullopt;
+        }
+
+        // The match is returned even if connecting to it fails, as it could not be found again otherwise.
+        SimpleBLE::Safe::Peripheral match(peripheral.value());
+        if (connect) {
+            match.connect();
+        }
+        return match;
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::scan_until_async(
+    std::function<bool(SimpleBLE::Safe::Peripheral)> predicate, int timeout_ms,
+    std::function<void(std::optional<SimpleBLE::Safe::Peripheral>)> on_complete) noexcept {
+    try {
+        SimpleBLE::Adapter::scan_until_async(
+            [=](SimpleBLE::Peripheral p) { return predicate(SimpleBLE::Safe::Peripheral(p)); }, timeout_ms,
+            [on_complete](std::optional<SimpleBLE::Peripheral> peripheral) {
+                if (!peripheral.has_value()) {
+                    on_complete(std::nullopt);
+                    return;
+                }
+                on_complete(SimpleBLE::Safe::Peripheral(peripheral.value()));
+            });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
 std::optional<bool> SimpleBLE::Safe::Adapter::scan_is_active() noexcept {
     try {
         return SimpleBLE::Adapter::scan_is_active();
@@ -67,6 +116,29 @@ std::optional<std::vector<SimpleBLE::Safe::Peripheral>> SimpleBLE::Safe::Adapter
     return std::nullopt;
 }
 
+std::optional<SimpleBLE::Safe::ScanChanges> SimpleBLE::Safe::Adapter::scan_get_changes(
+    uint64_t since_version) noexcept {
+    try {
+        auto changes = SimpleBLE::Adapter::scan_get_changes(since_version);
+
+        SimpleBLE::Safe::ScanChanges safe_changes;
+        safe_changes.version = changes.version;
+        safe_changes.reset = changes.reset;
+        for (auto& peripheral : changes.added) {
+            safe_changes.added.push_back(SimpleBLE::Safe::Peripheral(peripheral));
+        }
+        for (auto& peripheral : changes.updated) {
+            safe_changes.updated.push_back(SimpleBLE::Safe::Peripheral(peripheral));
+        }
+        for (auto& peripheral : changes.lost) {
+            safe_changes.lost.push_back(SimpleBLE::Safe::Peripheral(peripheral));
+        }
+        return safe_changes;
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
 std::optional<std::vector<SimpleBLE::Safe::Peripheral>> SimpleBLE::Safe::Adapter::get_paired_peripherals() noexcept {
     try {
         auto peripherals = SimpleBLE::Adapter::get_paired_peripherals();
@@ -81,6 +153,49 @@ std::optional<std::vector<SimpleBLE::Safe::Peripheral>> SimpleBLE::Safe::Adapter
     return std::nullopt;
 }
 
+bool SimpleBLE::Safe::Adapter::set_scan_filter(ScanFilter const& filter) noexcept {
+    try {
+        SimpleBLE::Adapter::set_scan_filter(filter);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::set_device_cache_limits(DeviceCacheLimits const& limits) noexcept {
+    try {
+        SimpleBLE::Adapter::set_device_cache_limits(limits);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+std::optional<SimpleBLE::DeviceCacheStats> SimpleBLE::Safe::Adapter::device_cache_stats() noexcept {
+    try {
+        return SimpleBLE::Adapter::device_cache_stats();
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::set_operation_concurrency(size_t max_concurrent) noexcept {
+    try {
+        SimpleBLE::Adapter::set_operation_concurrency(max_concurrent);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+std::optional<std::vector<SimpleBLE::OperationQueueStats>> SimpleBLE::Safe::Adapter::operation_queue_stats() noexcept {
+    try {
+        return SimpleBLE::Adapter::operation_queue_stats();
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
 bool SimpleBLE::Safe::Adapter::set_callback_on_scan_start(std::function<void()> on_scan_start) noexcept {
     try {
         SimpleBLE::Adapter::set_callback_on_scan_start(on_scan_start);
@@ -121,6 +236,73 @@ bool SimpleBLE::Safe::Adapter::set_callback_on_scan_found(
     }
 }
 
+bool SimpleBLE::Safe::Adapter::set_callback_on_scan_updated(
+    std::function<void(SimpleBLE::Safe::Peripheral, uint64_t timestamp)> on_scan_updated) noexcept {
+    try {
+        SimpleBLE::Adapter::set_callback_on_scan_updated([=](SimpleBLE::Peripheral p, uint64_t timestamp) {
+            on_scan_updated(SimpleBLE::Safe::Peripheral(p), timestamp);
+        });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::set_callback_on_scan_found(
+    std::function<void(SimpleBLE::Safe::Peripheral, uint64_t timestamp)> on_scan_found) noexcept {
+    try {
+        SimpleBLE::Adapter::set_callback_on_scan_found([=](SimpleBLE::Peripheral p, uint64_t timestamp) {
+            on_scan_found(SimpleBLE::Safe::Peripheral(p), timestamp);
+        });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::set_callback_on_scan_updated(std::nullptr_t) noexcept {
+    try {
+        SimpleBLE::Adapter::set_callback_on_scan_updated(nullptr);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::set_callback_on_scan_found(std::nullptr_t) noexcept {
+    try {
+        SimpleBLE::Adapter::set_callback_on_scan_found(nullptr);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::set_callback_on_scan_batch(
+    std::function<void(std::vector<SimpleBLE::Safe::ScanEvent> const& events)> on_scan_batch,
+    int interval_ms) noexcept {
+    try {
+        if (on_scan_batch) {
+            SimpleBLE::Adapter::set_callback_on_scan_batch(
+                [=](std::vector<SimpleBLE::ScanEvent> const& events) {
+                    std::vector<SimpleBLE::Safe::ScanEvent> safe_events;
+                    safe_events.reserve(events.size());
+                    for (auto event : events) {
+                        safe_events.push_back(SimpleBLE::Safe::ScanEvent{SimpleBLE::Safe::Peripheral(event.peripheral),
+                                                                         event.found, event.timestamp, event.count});
+                    }
+                    on_scan_batch(safe_events);
+                },
+                interval_ms);
+        } else {
+            SimpleBLE::Adapter::set_callback_on_scan_batch(nullptr, interval_ms);
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
 std::optional<bool> SimpleBLE::Safe::Adapter::bluetooth_enabled() noexcept {
     try {
         return SimpleBLE::Adapter::bluetooth_enabled();
@@ -140,4 +322,37 @@ std::optional<std::vector<SimpleBLE::Safe::Adapter>> SimpleBLE::Safe::Adapter::g
     } catch (...) {
         return std::nullopt;
     }
+}
+
+bool SimpleBLE::Safe::Adapter::use_external_event_loop() noexcept {
+    try {
+        return SimpleBLE::Adapter::use_external_event_loop();
+    } catch (...) {
+        return false;
+    }
+}
+
+std::optional<int> SimpleBLE::Safe::Adapter::event_fd() noexcept {
+    try {
+        return SimpleBLE::Adapter::event_fd();
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::process_events() noexcept {
+    try {
+        SimpleBLE::Adapter::process_events();
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Adapter::use_dedicated_connections(size_t count) noexcept {
+    try {
+        return SimpleBLE::Adapter::use_dedicated_connections(count);
+    } catch (...) {
+        return false;
+    }
 }
\ No newline at end of file
@@ -129,6 +129,16 @@ std::optional<SimpleBLE::ByteArray> SimpleBLE::Safe::Peripheral::read(BluetoothU
     }
 }
 
+std::optional<SimpleBLE::ByteArray> SimpleBLE::Safe::Peripheral::read_cached(BluetoothUUID const& service,
+                                                                             BluetoothUUID const& characteristic,
+                                                                             int max_age_ms) noexcept {
+    try {
+        return SimpleBLE::Peripheral::read_cached(service, characteristic, max_age_ms);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
 bool SimpleBLE::Safe::Peripheral::write_request(BluetoothUUID const& service, BluetoothUUID const& characteristic,
                                                 ByteArray const& data) noexcept {
     try {
@@ -169,6 +179,46 @@ bool SimpleBLE::Safe::Peripheral::indicate(BluetoothUUID const& service, Bluetoo
     }
 }
 
+bool SimpleBLE::Safe::Peripheral::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         std::function<void(ByteArray payload, uint64_t timestamp)> callback) noexcept {
+    try {
+        SimpleBLE::Peripheral::notify(service, characteristic, std::move(callback));
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                           std::function<void(ByteArray payload, uint64_t timestamp)> callback) noexcept {
+    try {
+        SimpleBLE::Peripheral::indicate(service, characteristic, std::move(callback));
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::notify(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                         std::nullptr_t) noexcept {
+    try {
+        SimpleBLE::Peripheral::notify(service, characteristic, nullptr);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::indicate(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                           std::nullptr_t) noexcept {
+    try {
+        SimpleBLE::Peripheral::indicate(service, characteristic, nullptr);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
 bool SimpleBLE::Safe::Peripheral::unsubscribe(BluetoothUUID const& service,
                                               BluetoothUUID const& characteristic) noexcept {
     try {
@@ -179,6 +229,26 @@ bool SimpleBLE::Safe::Peripheral::unsubscribe(BluetoothUUID const& service,
     }
 }
 
+std::optional<SimpleBLE::NotificationStream> SimpleBLE::Safe::Peripheral::notify(
+    BluetoothUUID const& service, BluetoothUUID const& characteristic,
+    NotificationStream::Options const& options) noexcept {
+    try {
+        return SimpleBLE::Peripheral::notify(service, characteristic, options);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+std::optional<SimpleBLE::NotificationStream> SimpleBLE::Safe::Peripheral::indicate(
+    BluetoothUUID const& service, BluetoothUUID const& characteristic,
+    NotificationStream::Options const& options) noexcept {
+    try {
+        return SimpleBLE::Peripheral::indicate(service, characteristic, options);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
 std::optional<SimpleBLE::ByteArray> SimpleBLE::Safe::Peripheral::read(BluetoothUUID const& service,
                                                                       BluetoothUUID const& characteristic,
                                                                       BluetoothUUID const& descriptor) noexcept {
@@ -199,6 +269,108 @@ bool SimpleBLE::Safe::Peripheral::write(BluetoothUUID const& service, BluetoothU
     }
 }
 
+std::optional<std::vector<SimpleBLE::OperationResult>> SimpleBLE::Safe::Peripheral::read_many(
+    std::vector<ReadRequest> const& requests) noexcept {
+    try {
+        return SimpleBLE::Peripheral::read_many(requests);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+std::optional<std::vector<SimpleBLE::OperationResult>> SimpleBLE::Safe::Peripheral::write_many(
+    std::vector<WriteRequest> const& requests) noexcept {
+    try {
+        return SimpleBLE::Peripheral::write_many(requests);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::connect_async(std::function<void(bool success)> on_complete) noexcept {
+    try {
+        SimpleBLE::Peripheral::connect_async([on_complete](std::exception_ptr error) { on_complete(!error); });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::read_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                             std::function<void(std::optional<ByteArray> value)> on_complete) noexcept {
+    try {
+        SimpleBLE::Peripheral::read_async(service, characteristic,
+                                          [on_complete](ByteArray value, std::exception_ptr error) {
+                                              if (error) {
+                                                  on_complete(std::nullopt);
+                                              } else {
+                                                  on_complete(std::move(value));
+                                              }
+                                          });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::write_request_async(BluetoothUUID const& service,
+                                                      BluetoothUUID const& characteristic, ByteArray const& data,
+                                                      std::function<void(bool success)> on_complete) noexcept {
+    try {
+        SimpleBLE::Peripheral::write_request_async(service, characteristic, data,
+                                                   [on_complete](std::exception_ptr error) { on_complete(!error); });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::write_command_async(BluetoothUUID const& service,
+                                                      BluetoothUUID const& characteristic, ByteArray const& data,
+                                                      std::function<void(bool success)> on_complete) noexcept {
+    try {
+        SimpleBLE::Peripheral::write_command_async(service, characteristic, data,
+                                                   [on_complete](std::exception_ptr error) { on_complete(!error); });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::notify_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                               std::function<void(ByteArray payload)> callback,
+                                               std::function<void(bool success)> on_complete) noexcept {
+    try {
+        SimpleBLE::Peripheral::notify_async(service, characteristic, std::move(callback),
+                                            [on_complete](std::exception_ptr error) { on_complete(!error); });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::unsubscribe_async(BluetoothUUID const& service, BluetoothUUID const& characteristic,
+                                                    std::function<void(bool success)> on_complete) noexcept {
+    try {
+        SimpleBLE::Peripheral::unsubscribe_async(service, characteristic,
+                                                 [on_complete](std::exception_ptr error) { on_complete(!error); });
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool SimpleBLE::Safe::Peripheral::set_operation_priority(BluetoothUUID const& service,
+                                                        BluetoothUUID const& characteristic,
+                                                        OperationPriority priority) noexcept {
+    try {
+        SimpleBLE::Peripheral::set_operation_priority(service, characteristic, priority);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
 bool SimpleBLE::Safe::Peripheral::set_callback_on_connected(std::function<void()> on_connected) noexcept {
     try {
         SimpleBLE::Peripheral::set_callback_on_connected(std::move(on_connected));
@@ -8,6 +8,18 @@ bool simpleble_adapter_is_bluetooth_enabled(void) {
     return SimpleBLE::Safe::Adapter::bluetooth_enabled().value_or(false);
 }
 
+bool simpleble_adapter_use_external_event_loop(void) { return SimpleBLE::Safe::Adapter::use_external_event_loop(); }
+
+int simpleble_adapter_event_fd(void) { return SimpleBLE::Safe::Adapter::event_fd().value_or(-1); }
+
+simpleble_err_t simpleble_adapter_process_events(void) {
+    return SimpleBLE::Safe::Adapter::process_events() ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+bool simpleble_adapter_use_dedicated_connections(size_t count) {
+    return SimpleBLE::Safe::Adapter::use_dedicated_connections(count);
+}
+
 size_t simpleble_adapter_get_count(void) {
     return SimpleBLE::Safe::Adapter::get_adapters().value_or(std::vector<SimpleBLE::Safe::Adapter>()).size();
 }
@@ -95,6 +107,69 @@ simpleble_err_t simpleble_adapter_scan_for(simpleble_adapter_t handle, int timeo
     return adapter->scan_for(timeout_ms) ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
 }
 
+simpleble_err_t simpleble_adapter_scan_for_async(simpleble_adapter_t handle, int timeout_ms,
+                                                 void (*callback)(simpleble_adapter_t, simpleble_err_t, void*),
+                                                 void* userdata) {
+    if (handle == nullptr || callback == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    bool success = adapter->scan_for_async(timeout_ms, [=](bool result) {
+        callback(handle, result ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE, userdata);
+    });
+
+    return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_adapter_scan_until(simpleble_adapter_t handle,
+                                             bool (*predicate)(simpleble_adapter_t, simpleble_peripheral_t, void*),
+                                             void* userdata, int timeout_ms, bool connect,
+                                             simpleble_peripheral_t* peripheral) {
+    if (handle == nullptr || predicate == nullptr || peripheral == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    *peripheral = nullptr;
+    auto match = adapter->scan_until(
+        [=](SimpleBLE::Safe::Peripheral candidate) { return predicate(handle, &candidate, userdata); }, timeout_ms);
+    if (!match.has_value()) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    auto* matched = new SimpleBLE::Safe::Peripheral(match.value());
+    *peripheral = matched;
+    if (connect && !matched->connect()) {
+        return SIMPLEBLE_FAILURE;
+    }
+    return SIMPLEBLE_SUCCESS;
+}
+
+simpleble_err_t simpleble_adapter_scan_until_async(
+    simpleble_adapter_t handle, bool (*predicate)(simpleble_adapter_t, simpleble_peripheral_t, void*), int timeout_ms,
+    void (*callback)(simpleble_adapter_t, simpleble_peripheral_t, void*), void* userdata) {
+    if (handle == nullptr || predicate == nullptr || callback == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    bool success = adapter->scan_until_async(
+        [=](SimpleBLE::Safe::Peripheral candidate) { return predicate(handle, &candidate, userdata); }, timeout_ms,
+        [=](std::optional<SimpleBLE::Safe::Peripheral> match) {
+            simpleble_peripheral_t peripheral = nullptr;
+            if (match.has_value()) {
+                peripheral = new SimpleBLE::Safe::Peripheral(match.value());
+            }
+            callback(handle, peripheral, userdata);
+        });
+
+    return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
 size_t simpleble_adapter_scan_get_results_count(simpleble_adapter_t handle) {
     if (handle == nullptr) {
         return 0;
@@ -120,6 +195,185 @@ simpleble_peripheral_t simpleble_adapter_scan_get_results_handle(simpleble_adapt
     return peripheral_handle;
 }
 
+simpleble_err_t simpleble_adapter_scan_get_changes(simpleble_adapter_t handle, uint64_t since_version,
+                                                   uint64_t* version, bool* reset, simpleble_scan_change_t** changes,
+                                                   size_t* changes_count) {
+    if (handle == nullptr || version == nullptr || reset == nullptr || changes == nullptr ||
+        changes_count == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    auto scan_changes = adapter->scan_get_changes(since_version);
+    if (!scan_changes.has_value()) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    *version = scan_changes->version;
+    *reset = scan_changes->reset;
+    *changes_count = scan_changes->added.size() + scan_changes->updated.size() + scan_changes->lost.size();
+    *changes = nullptr;
+    if (*changes_count == 0) {
+        return SIMPLEBLE_SUCCESS;
+    }
+
+    *changes = static_cast<simpleble_scan_change_t*>(malloc(*changes_count * sizeof(simpleble_scan_change_t)));
+    if (*changes == nullptr) {
+        *changes_count = 0;
+        return SIMPLEBLE_FAILURE;
+    }
+
+    size_t index = 0;
+    auto append = [&](std::vector<SimpleBLE::Safe::Peripheral>& peripherals, simpleble_scan_change_kind_t kind) {
+        for (auto& peripheral : peripherals) {
+            (*changes)[index].kind = kind;
+            (*changes)[index].peripheral = new SimpleBLE::Safe::Peripheral(peripheral);
+            index++;
+        }
+    };
+    append(scan_changes->added, SIMPLEBLE_SCAN_CHANGE_ADDED);
+    append(scan_changes->updated, SIMPLEBLE_SCAN_CHANGE_UPDATED);
+    append(scan_changes->lost, SIMPLEBLE_SCAN_CHANGE_LOST);
+
+    return SIMPLEBLE_SUCCESS;
+}
+
+simpleble_err_t simpleble_adapter_set_scan_filter(simpleble_adapter_t handle, const simpleble_scan_filter_t* filter) {
+    if (handle == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    SimpleBLE::ScanFilter scan_filter;
+    if (filter != nullptr) {
+        if (filter->service_uuid_count > SIMPLEBLE_SCAN_FILTER_UUID_MAX_COUNT) {
+            return SIMPLEBLE_FAILURE;
+        }
+
+        for (size_t i = 0; i < filter->service_uuid_count; i++) {
+            const simpleble_uuid_t& uuid = filter->service_uuids[i];
+            scan_filter.service_uuids.push_back(std::string(uuid.value, strnlen(uuid.value, SIMPLEBLE_UUID_STR_LEN)));
+        }
+
+        if (filter->has_rssi_threshold) {
+            scan_filter.rssi_threshold = filter->rssi_threshold;
+        }
+
+        if (filter->has_pathloss_threshold) {
+            scan_filter.pathloss_threshold = filter->pathloss_threshold;
+        }
+
+        switch (filter->transport) {
+            case SIMPLEBLE_TRANSPORT_BREDR:
+                scan_filter.transport = SimpleBLE::ScanFilter::Transport::BREDR;
+                break;
+            case SIMPLEBLE_TRANSPORT_LE:
+                scan_filter.transport = SimpleBLE::ScanFilter::Transport::LE;
+                break;
+            default:
+                scan_filter.transport = SimpleBLE::ScanFilter::Transport::AUTO;
+                break;
+        }
+
+        scan_filter.duplicate_data = filter->duplicate_data;
+        size_t pattern_length = strnlen(filter->pattern, SIMPLEBLE_SCAN_FILTER_PATTERN_MAX_LEN);
+        scan_filter.pattern = std::string(filter->pattern, pattern_length);
+
+        scan_filter.name = std::string(filter->name, strnlen(filter->name, SIMPLEBLE_SCAN_FILTER_NAME_MAX_LEN));
+        size_t name_prefix_length = strnlen(filter->name_prefix, SIMPLEBLE_SCAN_FILTER_NAME_MAX_LEN);
+        scan_filter.name_prefix = std::string(filter->name_prefix, name_prefix_length);
+
+        if (filter->has_manufacturer_id) {
+            if (filter->manufacturer_data_length > sizeof(filter->manufacturer_data)) {
+                return SIMPLEBLE_FAILURE;
+            }
+
+            scan_filter.manufacturer_id = filter->manufacturer_id;
+            scan_filter.manufacturer_data = SimpleBLE::ByteArray((const char*)filter->manufacturer_data,
+                                                                 filter->manufacturer_data_length);
+            // A zeroed mask is what an unset field looks like in C, so it means the same as an empty mask in C++.
+            SimpleBLE::ByteArray mask((const char*)filter->manufacturer_data_mask, filter->manufacturer_data_length);
+            if (mask.find_first_not_of('\0') != std::string::npos) {
+                scan_filter.manufacturer_data_mask = mask;
+            }
+        }
+    }
+
+    return adapter->set_scan_filter(scan_filter) ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_adapter_set_device_cache_limits(simpleble_adapter_t handle, size_t max_devices,
+                                                         int ttl_ms) {
+    if (handle == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    SimpleBLE::DeviceCacheLimits limits;
+    limits.max_devices = max_devices;
+    limits.ttl_ms = ttl_ms;
+    return adapter->set_device_cache_limits(limits) ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_adapter_get_device_cache_stats(simpleble_adapter_t handle, size_t* cached_devices,
+                                                        uint64_t* evicted_devices) {
+    if (handle == nullptr || cached_devices == nullptr || evicted_devices == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    auto stats = adapter->device_cache_stats();
+    if (!stats.has_value()) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    *cached_devices = stats->cached_devices;
+    *evicted_devices = stats->evicted_devices;
+    return SIMPLEBLE_SUCCESS;
+}
+
+simpleble_err_t simpleble_adapter_set_operation_concurrency(simpleble_adapter_t handle, size_t max_concurrent) {
+    if (handle == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+    return adapter->set_operation_concurrency(max_concurrent) ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_adapter_get_operation_queue_stats(simpleble_adapter_t handle,
+                                                            simpleble_operation_priority_t priority, size_t* queued,
+                                                            uint64_t* started, uint64_t* mean_wait_us,
+                                                            uint64_t* max_wait_us) {
+    if (handle == nullptr || queued == nullptr || started == nullptr || mean_wait_us == nullptr ||
+        max_wait_us == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Adapter* adapter = (SimpleBLE::Safe::Adapter*)handle;
+
+    auto stats = adapter->operation_queue_stats();
+    if (!stats.has_value()) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    for (auto const& class_stats : stats.value()) {
+        if (class_stats.priority == static_cast<SimpleBLE::OperationPriority>(priority)) {
+            *queued = class_stats.queued;
+            *started = class_stats.started;
+            *mean_wait_us = class_stats.mean_wait_us;
+            *max_wait_us = class_stats.max_wait_us;
+            return SIMPLEBLE_SUCCESS;
+        }
+    }
+
+    return SIMPLEBLE_FAILURE;
+}
+
 size_t simpleble_adapter_get_paired_peripherals_count(simpleble_adapter_t handle) {
     if (handle == nullptr) {
         return 0;
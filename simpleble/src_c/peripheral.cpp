@@ -2,9 +2,11 @@
 
 #include <simpleble/PeripheralSafe.h>
 
+#include <algorithm>
 #include <climits>
 #include <cstring>
 #include <map>
+#include <vector>
 
 void simpleble_peripheral_release_handle(simpleble_peripheral_t handle) {
     if (handle == nullptr) {
@@ -284,6 +286,31 @@ simpleble_err_t simpleble_peripheral_read(simpleble_peripheral_t handle, simpleb
     return SIMPLEBLE_SUCCESS;
 }
 
+simpleble_err_t simpleble_peripheral_read_cached(simpleble_peripheral_t handle, simpleble_uuid_t service,
+                                                 simpleble_uuid_t characteristic, int max_age_ms, uint8_t** data,
+                                                 size_t* data_length) {
+    if (handle == nullptr || data == nullptr || data_length == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    *data = nullptr;
+    *data_length = 0;
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+    std::optional<SimpleBLE::ByteArray> read_data = peripheral->read_cached(
+        SimpleBLE::BluetoothUUID(service.value), SimpleBLE::BluetoothUUID(characteristic.value), max_age_ms);
+
+    if (!read_data.has_value()) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    *data_length = read_data.value().size();
+    *data = static_cast<uint8_t*>(malloc(*data_length));
+    memcpy(*data, read_data.value().c_str(), *data_length);
+
+    return SIMPLEBLE_SUCCESS;
+}
+
 simpleble_err_t simpleble_peripheral_write_request(simpleble_peripheral_t handle, simpleble_uuid_t service,
                                                    simpleble_uuid_t characteristic, const uint8_t* data,
                                                    size_t data_length) {
@@ -411,6 +438,174 @@ simpleble_err_t simpleble_peripheral_write_descriptor(simpleble_peripheral_t han
     return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
 }
 
+simpleble_err_t simpleble_peripheral_read_many(simpleble_peripheral_t handle, simpleble_read_request_t* requests,
+                                               size_t count) {
+    if (handle == nullptr || (requests == nullptr && count > 0)) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    std::vector<SimpleBLE::ReadRequest> batch;
+    for (size_t i = 0; i < count; i++) {
+        requests[i].data_length = 0;
+        requests[i].result = SIMPLEBLE_FAILURE;
+        batch.push_back({SimpleBLE::BluetoothUUID(requests[i].service.value),
+                         SimpleBLE::BluetoothUUID(requests[i].characteristic.value)});
+    }
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+    std::optional<std::vector<SimpleBLE::OperationResult>> results = peripheral->read_many(batch);
+
+    if (!results.has_value()) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        SimpleBLE::OperationResult const& result = results.value()[i];
+        if (!result.success) continue;
+
+        requests[i].data_length = result.value.size();
+        if (requests[i].data != nullptr) {
+            memcpy(requests[i].data, result.value.c_str(), std::min(result.value.size(), requests[i].data_capacity));
+        }
+        requests[i].result = SIMPLEBLE_SUCCESS;
+    }
+
+    return SIMPLEBLE_SUCCESS;
+}
+
+simpleble_err_t simpleble_peripheral_write_many(simpleble_peripheral_t handle, simpleble_write_request_t* requests,
+                                                size_t count) {
+    if (handle == nullptr || (requests == nullptr && count > 0)) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    std::vector<SimpleBLE::WriteRequest> batch;
+    for (size_t i = 0; i < count; i++) {
+        requests[i].result = SIMPLEBLE_FAILURE;
+
+        SimpleBLE::WriteRequest request;
+        request.service = SimpleBLE::BluetoothUUID(requests[i].service.value);
+        request.characteristic = SimpleBLE::BluetoothUUID(requests[i].characteristic.value);
+        if (requests[i].data != nullptr) {
+            request.data = SimpleBLE::ByteArray((const char*)requests[i].data, requests[i].data_length);
+        }
+        request.with_response = requests[i].with_response;
+        batch.push_back(request);
+    }
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+    std::optional<std::vector<SimpleBLE::OperationResult>> results = peripheral->write_many(batch);
+
+    if (!results.has_value()) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        requests[i].result = results.value()[i].success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+    }
+
+    return SIMPLEBLE_SUCCESS;
+}
+
+simpleble_err_t simpleble_peripheral_connect_async(simpleble_peripheral_t handle,
+                                                   void (*callback)(simpleble_peripheral_t, simpleble_err_t, void*),
+                                                   void* userdata) {
+    if (handle == nullptr || callback == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+
+    bool success = peripheral->connect_async([=](bool result) {
+        callback(handle, result ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE, userdata);
+    });
+
+    return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_peripheral_read_async(
+    simpleble_peripheral_t handle, simpleble_uuid_t service, simpleble_uuid_t characteristic,
+    void (*callback)(simpleble_peripheral_t, simpleble_uuid_t, simpleble_uuid_t, const uint8_t*, size_t,
+                     simpleble_err_t, void*),
+    void* userdata) {
+    if (handle == nullptr || callback == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+
+    bool success = peripheral->read_async(SimpleBLE::BluetoothUUID(service.value),
+                                          SimpleBLE::BluetoothUUID(characteristic.value),
+                                          [=](std::optional<SimpleBLE::ByteArray> value) {
+                                              if (!value.has_value()) {
+                                                  callback(handle, service, characteristic, nullptr, 0,
+                                                           SIMPLEBLE_FAILURE, userdata);
+                                                  return;
+                                              }
+                                              callback(handle, service, characteristic,
+                                                       (const uint8_t*)value->data(), value->size(),
+                                                       SIMPLEBLE_SUCCESS, userdata);
+                                          });
+
+    return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_peripheral_write_request_async(
+    simpleble_peripheral_t handle, simpleble_uuid_t service, simpleble_uuid_t characteristic, const uint8_t* data,
+    size_t data_length,
+    void (*callback)(simpleble_peripheral_t, simpleble_uuid_t, simpleble_uuid_t, simpleble_err_t, void*),
+    void* userdata) {
+    if (handle == nullptr || data == nullptr || callback == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+
+    bool success = peripheral->write_request_async(
+        SimpleBLE::BluetoothUUID(service.value), SimpleBLE::BluetoothUUID(characteristic.value),
+        SimpleBLE::ByteArray((const char*)data, data_length), [=](bool result) {
+            callback(handle, service, characteristic, result ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE, userdata);
+        });
+
+    return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_peripheral_write_command_async(
+    simpleble_peripheral_t handle, simpleble_uuid_t service, simpleble_uuid_t characteristic, const uint8_t* data,
+    size_t data_length,
+    void (*callback)(simpleble_peripheral_t, simpleble_uuid_t, simpleble_uuid_t, simpleble_err_t, void*),
+    void* userdata) {
+    if (handle == nullptr || data == nullptr || callback == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+
+    bool success = peripheral->write_command_async(
+        SimpleBLE::BluetoothUUID(service.value), SimpleBLE::BluetoothUUID(characteristic.value),
+        SimpleBLE::ByteArray((const char*)data, data_length), [=](bool result) {
+            callback(handle, service, characteristic, result ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE, userdata);
+        });
+
+    return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
+simpleble_err_t simpleble_peripheral_set_operation_priority(simpleble_peripheral_t handle, simpleble_uuid_t service,
+                                                           simpleble_uuid_t characteristic,
+                                                           simpleble_operation_priority_t priority) {
+    if (handle == nullptr) {
+        return SIMPLEBLE_FAILURE;
+    }
+
+    SimpleBLE::Safe::Peripheral* peripheral = (SimpleBLE::Safe::Peripheral*)handle;
+
+    bool success = peripheral->set_operation_priority(SimpleBLE::BluetoothUUID(service.value),
+                                                      SimpleBLE::BluetoothUUID(characteristic.value),
+                                                      static_cast<SimpleBLE::OperationPriority>(priority));
+
+    return success ? SIMPLEBLE_SUCCESS : SIMPLEBLE_FAILURE;
+}
+
 simpleble_err_t simpleble_peripheral_set_callback_on_connected(simpleble_peripheral_t handle,
                                                                void (*callback)(simpleble_peripheral_t, void*),
                                                                void* userdata) {
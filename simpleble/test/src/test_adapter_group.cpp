@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "AdapterGroupPolicy.h"
+
+using namespace SimpleBLE;
+
+static AdapterCandidate candidate(bool sees_peripheral, size_t connections, uint64_t failures = 0,
+                                  bool available = true) {
+    AdapterCandidate result;
+    result.available = available;
+    result.sees_peripheral = sees_peripheral;
+    result.connections = connections;
+    result.failures = failures;
+    return result;
+}
+
+TEST(AdapterGroupPolicy, LeastLoadedFirst) {
+    std::vector<AdapterCandidate> candidates = {candidate(true, 5), candidate(true, 1), candidate(true, 3)};
+    EXPECT_EQ(rank_adapters(candidates), (std::vector<size_t>{1, 2, 0}));
+}
+
+TEST(AdapterGroupPolicy, OnlyAdaptersThatSawThePeripheral) {
+    std::vector<AdapterCandidate> candidates = {candidate(false, 0), candidate(true, 7), candidate(false, 1)};
+    EXPECT_EQ(rank_adapters(candidates), (std::vector<size_t>{1}));
+}
+
+TEST(AdapterGroupPolicy, SkipsUnavailableAdapters) {
+    std::vector<AdapterCandidate> candidates = {candidate(true, 0, 0, false), candidate(true, 2)};
+    EXPECT_EQ(rank_adapters(candidates), (std::vector<size_t>{1}));
+}
+
+TEST(AdapterGroupPolicy, FailuresBreakTies) {
+    std::vector<AdapterCandidate> candidates = {candidate(true, 2, 4), candidate(true, 2, 1), candidate(true, 2, 1)};
+    EXPECT_EQ(rank_adapters(candidates), (std::vector<size_t>{1, 2, 0}));
+}
+
+TEST(AdapterGroupPolicy, NoCandidates) {
+    EXPECT_TRUE(rank_adapters({}).empty());
+    EXPECT_TRUE(rank_adapters({candidate(false, 0)}).empty());
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BatchOperations.h"
+
+using namespace SimpleBLE;
+
+TEST(BatchOperations, ResultsFollowRequestOrder) {
+    std::vector<ReadRequest> requests = {{"s", "a"}, {"s", "b"}, {"s", "c"}};
+
+    auto results =
+        run_serially(requests, [](ReadRequest const& request) { return ByteArray("v" + request.characteristic); });
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].value, "va");
+    EXPECT_EQ(results[1].value, "vb");
+    EXPECT_EQ(results[2].value, "vc");
+    for (auto const& result : results) {
+        EXPECT_TRUE(result.success);
+        EXPECT_TRUE(result.error.empty());
+    }
+}
+
+TEST(BatchOperations, FailingItemDoesNotStopTheOthers) {
+    std::vector<WriteRequest> requests = {{"s", "a", "1"}, {"s", "bad", "2"}, {"s", "c", "3", false}};
+    std::vector<std::string> written;
+
+    auto results = run_serially(requests, [&](WriteRequest const& request) {
+        if (request.characteristic == "bad") throw std::runtime_error("Characteristic not found");
+        written.push_back(request.data);
+    });
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_FALSE(results[1].success);
+    EXPECT_EQ(results[1].error, "Characteristic not found");
+    EXPECT_TRUE(results[2].success);
+    EXPECT_EQ(written, (std::vector<std::string>{"1", "3"}));
+}
+
+TEST(BatchOperations, UnknownExceptionsAreReported) {
+    auto result = capture_result([]() -> ByteArray { throw 42; });
+
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.error.empty());
+    EXPECT_TRUE(result.value.empty());
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <simpleble/SimpleBLE.h>
+
+#include "ConnectionManagerBase.h"
+
+#include <atomic>
+#include <chrono>
+#include <fmt/core.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace SimpleBLE;
+
+namespace {
+
+// A fleet of virtual peripherals, each failing a given number of connection attempts before succeeding.
+class VirtualFleet {
+  public:
+    explicit VirtualFleet(size_t size, int failures_per_target = 0) {
+        for (size_t i = 0; i < size; i++) {
+            addresses.push_back(fmt::format("00:00:00:00:{:02X}:{:02X}", i / 256, i % 256));
+            remaining_failures[addresses.back()] = failures_per_target;
+        }
+    }
+
+    bool connect(BluetoothAddress const& address) {
+        size_t current = ++in_flight;
+        size_t peak = peak_in_flight.load();
+        while (current > peak && !peak_in_flight.compare_exchange_weak(peak, current)) {
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+        bool success;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            attempts[address]++;
+            success = remaining_failures[address]-- <= 0;
+        }
+
+        in_flight--;
+        return success;
+    }
+
+    std::vector<BluetoothAddress> addresses;
+    std::atomic<size_t> in_flight{0};
+    std::atomic<size_t> peak_in_flight{0};
+    std::mutex mutex;
+    std::map<BluetoothAddress, int> remaining_failures;
+    std::map<BluetoothAddress, int> attempts;
+};
+
+std::shared_ptr<ConnectionManagerBase> make_manager(VirtualFleet& fleet, ConnectionManager::Options const& options) {
+    return std::make_shared<ConnectionManagerBase>(
+        [&fleet](BluetoothAddress const& address) { return fleet.connect(address); },
+        [](BluetoothAddress const&) {}, options);
+}
+
+bool wait_for(std::function<bool()> condition, std::chrono::milliseconds timeout = std::chrono::seconds(10)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(ConnectionManager, ConnectsFleetWithinConcurrencyLimit) {
+    VirtualFleet fleet(300);
+
+    ConnectionManager::Options options;
+    options.max_concurrent = 8;
+    auto manager = make_manager(fleet, options);
+
+    for (auto const& address : fleet.addresses) {
+        manager->add(address);
+    }
+    manager->start();
+
+    EXPECT_TRUE(wait_for([&] { return manager->stats().connected == fleet.addresses.size(); }));
+    manager->stop();
+
+    EXPECT_LE(fleet.peak_in_flight, options.max_concurrent);
+    EXPECT_GT(fleet.peak_in_flight, 1);
+
+    auto stats = manager->stats();
+    EXPECT_EQ(stats.targets, 300);
+    EXPECT_EQ(stats.attempts, 300);
+    EXPECT_EQ(stats.failures, 0);
+    EXPECT_GE(stats.max_connect_ms, stats.mean_connect_ms);
+}
+
+TEST(ConnectionManager, RetriesWithBackoff) {
+    VirtualFleet fleet(20, 3);
+
+    ConnectionManager::Options options;
+    options.initial_backoff_ms = 5;
+    options.max_backoff_ms = 20;
+    auto manager = make_manager(fleet, options);
+
+    for (auto const& address : fleet.addresses) {
+        manager->add(address);
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    manager->start();
+    EXPECT_TRUE(wait_for([&] { return manager->stats().connected == fleet.addresses.size(); }));
+    manager->stop();
+
+    // Each target waits 5 + 10 + 20 ms between its four attempts.
+    EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(35));
+
+    auto stats = manager->stats();
+    EXPECT_EQ(stats.attempts, 80);
+    EXPECT_EQ(stats.failures, 60);
+    for (auto const& address : fleet.addresses) {
+        EXPECT_EQ(fleet.attempts[address], 4);
+    }
+}
+
+TEST(ConnectionManager, ReconnectsDroppedConnections) {
+    VirtualFleet fleet(100);
+
+    ConnectionManager::Options options;
+    options.initial_backoff_ms = 1;
+    auto manager = make_manager(fleet, options);
+
+    for (auto const& address : fleet.addresses) {
+        manager->add(address);
+    }
+    manager->start();
+    ASSERT_TRUE(wait_for([&] { return manager->stats().connected == fleet.addresses.size(); }));
+
+    for (size_t i = 0; i < fleet.addresses.size(); i += 2) {
+        manager->disconnected(fleet.addresses[i]);
+    }
+
+    EXPECT_TRUE(wait_for([&] { return manager->stats().reconnects == 50; }));
+    EXPECT_TRUE(wait_for([&] { return manager->stats().connected == fleet.addresses.size(); }));
+    manager->stop();
+
+    auto stats = manager->stats();
+    EXPECT_EQ(stats.disconnects, 50);
+    EXPECT_EQ(stats.attempts, 150);
+}
+
+// A connection that drops while it is being set up, such as while subscriptions are restored, fails the attempt.
+TEST(ConnectionManager, DropWhileConnectingFailsTheAttempt) {
+    BluetoothAddress address = "00:00:00:00:00:01";
+    std::atomic_int attempts{0};
+    std::shared_ptr<ConnectionManagerBase> manager;
+
+    ConnectionManager::Options options;
+    options.initial_backoff_ms = 1;
+    manager = std::make_shared<ConnectionManagerBase>(
+        [&](BluetoothAddress const& target) {
+            if (attempts++ == 0) {
+                manager->disconnected(target);
+            }
+            return true;
+        },
+        [](BluetoothAddress const&) {}, options);
+
+    manager->add(address);
+    manager->start();
+    EXPECT_TRUE(wait_for([&] { return manager->is_connected(address) && attempts == 2; }));
+    manager->stop();
+
+    auto stats = manager->stats();
+    EXPECT_EQ(stats.attempts, 2);
+    EXPECT_EQ(stats.failures, 1);
+    EXPECT_EQ(stats.disconnects, 0);
+}
+
+TEST(ConnectionManager, NoReconnectWhenDisabled) {
+    VirtualFleet fleet(1);
+
+    ConnectionManager::Options options;
+    options.auto_reconnect = false;
+    auto manager = make_manager(fleet, options);
+
+    manager->add(fleet.addresses[0]);
+    manager->start();
+    ASSERT_TRUE(wait_for([&] { return manager->is_connected(fleet.addresses[0]); }));
+
+    manager->disconnected(fleet.addresses[0]);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    manager->stop();
+
+    EXPECT_FALSE(manager->is_connected(fleet.addresses[0]));
+    EXPECT_EQ(manager->stats().attempts, 1);
+}
+
+TEST(ConnectionManager, AddressesAreCaseInsensitive) {
+    VirtualFleet fleet(0);
+    auto manager = make_manager(fleet, ConnectionManager::Options());
+
+    manager->add("aa:bb:cc:dd:ee:ff");
+    manager->add("AA:BB:CC:DD:EE:FF");
+    EXPECT_EQ(manager->targets(), (std::vector<BluetoothAddress>{"AA:BB:CC:DD:EE:FF"}));
+
+    manager->remove("Aa:Bb:Cc:Dd:Ee:Ff");
+    EXPECT_TRUE(manager->targets().empty());
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <simpleble/Coroutines.h>
+#include <simpleble/SimpleBLE.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace SimpleBLE;
+
+namespace {
+
+Coro::Task<int> add_later(int a, int b) {
+    co_await Coro::sleep_for(std::chrono::milliseconds(1));
+    co_return a + b;
+}
+
+Coro::Task<void> fail_later() {
+    co_await Coro::sleep_for(std::chrono::milliseconds(1));
+    throw std::runtime_error("failure");
+}
+
+}  // namespace
+
+TEST(Coroutines, NestedTasksReturnValues) {
+    Coro::Executor executor;
+    int result = 0;
+
+    executor.spawn([&]() -> Coro::Task<void> {
+        int first = co_await add_later(1, 2);
+        result = co_await add_later(first, 4);
+    }());
+    executor.run();
+
+    EXPECT_EQ(result, 7);
+}
+
+TEST(Coroutines, SleepsResumeInOrderOfDueTime) {
+    Coro::Executor executor;
+    std::vector<int> order;
+
+    auto sleeper = [&](int value, int delay_ms) -> Coro::Task<void> {
+        co_await Coro::sleep_for(std::chrono::milliseconds(delay_ms));
+        order.push_back(value);
+    };
+    executor.spawn(sleeper(3, 30));
+    executor.spawn(sleeper(1, 10));
+    executor.spawn(sleeper(2, 20));
+    executor.run();
+
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(Coroutines, ExceptionsPropagateToTheAwaitingTask) {
+    Coro::Executor executor;
+    bool caught = false;
+
+    executor.spawn([&]() -> Coro::Task<void> {
+        try {
+            co_await fail_later();
+        } catch (std::runtime_error const&) {
+            caught = true;
+        }
+    }());
+    executor.run();
+    EXPECT_TRUE(caught);
+
+    executor.spawn(fail_later());
+    EXPECT_THROW(executor.run(), std::runtime_error);
+}
+
+TEST(Coroutines, ProvisioningFlowRunsAsStraightLineCode) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    Coro::Executor executor;
+    bool completed = false;
+
+    executor.spawn([&]() -> Coro::Task<void> {
+        auto peripheral = co_await Coro::scan_until(
+            adapter, [](Peripheral p) { return p.identifier() == "Plain Peripheral"; }, 1000);
+        if (!peripheral.has_value()) co_return;
+
+        co_await Coro::connect(*peripheral);
+        auto service = peripheral->services().at(0);
+        auto characteristic = service.characteristics().at(0);
+
+        co_await Coro::write_request(*peripheral, service.uuid(), characteristic.uuid(), "ping");
+        co_await Coro::read(*peripheral, service.uuid(), characteristic.uuid());
+        completed = peripheral->is_connected();
+    }());
+    executor.run();
+
+    EXPECT_TRUE(completed);
+}
+
+TEST(Coroutines, ManyFlowsShareOneThread) {
+    auto adapter = Adapter::get_adapters().at(0);
+    auto peripheral = adapter.scan_get_results().at(0);
+    peripheral.connect();
+    auto service = peripheral.services().at(0);
+    auto characteristic = service.characteristics().at(0);
+
+    Coro::Executor executor;
+    int completed = 0;
+
+    for (int i = 0; i < 200; i++) {
+        executor.spawn([&]() -> Coro::Task<void> {
+            co_await Coro::read(peripheral, service.uuid(), characteristic.uuid());
+            completed++;
+        }());
+    }
+    executor.run();
+
+    EXPECT_EQ(completed, 200);
+}
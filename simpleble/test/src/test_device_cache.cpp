@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <simpleble/SimpleBLE.h>
+
+#include "DeviceCachePolicy.h"
+
+using namespace SimpleBLE;
+
+static constexpr uint64_t SECOND_NS = 1000000000ULL;
+
+TEST(DeviceCachePolicy, NoLimits) {
+    std::vector<uint64_t> last_seen = {0, 1 * SECOND_NS, 2 * SECOND_NS};
+    EXPECT_TRUE(select_device_evictions(last_seen, DeviceCacheLimits{}, 100 * SECOND_NS).empty());
+}
+
+TEST(DeviceCachePolicy, Ttl) {
+    std::vector<uint64_t> last_seen = {90 * SECOND_NS, 10 * SECOND_NS, 99 * SECOND_NS, 50 * SECOND_NS};
+
+    DeviceCacheLimits limits;
+    limits.ttl_ms = 30000;
+    auto evicted = select_device_evictions(last_seen, limits, 100 * SECOND_NS);
+    EXPECT_EQ(evicted, (std::vector<size_t>{1, 3}));
+}
+
+TEST(DeviceCachePolicy, CapEvictsLeastRecentlySeen) {
+    std::vector<uint64_t> last_seen = {40 * SECOND_NS, 10 * SECOND_NS, 30 * SECOND_NS, 20 * SECOND_NS};
+
+    DeviceCacheLimits limits;
+    limits.max_devices = 2;
+    auto evicted = select_device_evictions(last_seen, limits, 50 * SECOND_NS);
+    EXPECT_EQ(evicted, (std::vector<size_t>{1, 3}));
+
+    limits.max_devices = 4;
+    EXPECT_TRUE(select_device_evictions(last_seen, limits, 50 * SECOND_NS).empty());
+}
+
+TEST(DeviceCachePolicy, UnknownTimestampIsOldest) {
+    std::vector<uint64_t> last_seen = {10 * SECOND_NS, 0, 20 * SECOND_NS};
+
+    DeviceCacheLimits limits;
+    limits.max_devices = 2;
+    EXPECT_EQ(select_device_evictions(last_seen, limits, 30 * SECOND_NS), (std::vector<size_t>{1}));
+}
+
+TEST(DeviceCachePolicy, UnknownTimestampCountsFromFirstSweep) {
+    DeviceLoadTimes load_times;
+    DeviceCacheLimits limits;
+    limits.ttl_ms = 30000;
+
+    // Devices loaded but never heard from are not evicted by the first sweep.
+    std::vector<uint64_t> last_seen = {load_times.resolve("/dev_a", 0, 100 * SECOND_NS),
+                                       load_times.resolve("/dev_b", 90 * SECOND_NS, 100 * SECOND_NS)};
+    load_times.finish_sweep();
+    EXPECT_TRUE(select_device_evictions(last_seen, limits, 100 * SECOND_NS).empty());
+
+    // They expire once the TTL has elapsed since then.
+    last_seen = {load_times.resolve("/dev_a", 0, 140 * SECOND_NS)};
+    load_times.finish_sweep();
+    EXPECT_EQ(select_device_evictions(last_seen, limits, 140 * SECOND_NS), (std::vector<size_t>{0}));
+
+    // Devices missing from a sweep are forgotten.
+    load_times.finish_sweep();
+    EXPECT_EQ(load_times.resolve("/dev_a", 0, 150 * SECOND_NS), 150 * SECOND_NS);
+}
+
+TEST(DeviceCachePolicy, CapAndTtlCombined) {
+    std::vector<uint64_t> last_seen = {95 * SECOND_NS, 10 * SECOND_NS, 96 * SECOND_NS, 97 * SECOND_NS};
+
+    // The TTL alone evicts one device, the cap requires two.
+    DeviceCacheLimits limits;
+    limits.max_devices = 2;
+    limits.ttl_ms = 30000;
+    EXPECT_EQ(select_device_evictions(last_seen, limits, 100 * SECOND_NS), (std::vector<size_t>{1, 0}));
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <simpleble/SimpleBLE.h>
+
+using namespace SimpleBLE;
+
+static const BluetoothUUID SERVICE_UUID = "0000180f-0000-1000-8000-00805f9b34fb";
+static const BluetoothUUID CHARACTERISTIC_UUID = "00002a19-0000-1000-8000-00805f9b34fb";
+
+// The plain backend emits ten single-byte payloads, 0 to 9, when subscribing.
+static Peripheral connected_peripheral() {
+    auto adapter = Adapter::get_adapters().at(0);
+    auto peripheral = adapter.scan_get_results().at(0);
+    peripheral.connect();
+    return peripheral;
+}
+
+TEST(NotificationStream, Uninitialized) {
+    NotificationStream stream;
+    EXPECT_FALSE(stream.initialized());
+    EXPECT_THROW(stream.next(0), Exception::NotInitialized);
+}
+
+TEST(NotificationStream, ReceivesInOrder) {
+    auto peripheral = connected_peripheral();
+    auto stream = peripheral.notify(SERVICE_UUID, CHARACTERISTIC_UUID);
+
+    ASSERT_TRUE(stream.initialized());
+    EXPECT_EQ(stream.size(), 10);
+    for (char i = 0; i < 10; i++) {
+        auto payload = stream.next(0);
+        ASSERT_TRUE(payload.has_value());
+        EXPECT_EQ(*payload, ByteArray(1, i));
+    }
+    EXPECT_FALSE(stream.next(10).has_value());
+    EXPECT_EQ(stream.received(), 10);
+    EXPECT_EQ(stream.dropped(), 0);
+    EXPECT_EQ(stream.high_water_mark(), 10);
+}
+
+TEST(NotificationStream, DropOldest) {
+    auto peripheral = connected_peripheral();
+    auto stream = peripheral.notify(SERVICE_UUID, CHARACTERISTIC_UUID,
+                                    {4, NotificationStream::OverflowPolicy::DROP_OLDEST});
+
+    auto payloads = stream.drain();
+    ASSERT_EQ(payloads.size(), 4);
+    EXPECT_EQ(payloads.front(), ByteArray(1, 6));
+    EXPECT_EQ(payloads.back(), ByteArray(1, 9));
+    EXPECT_EQ(stream.dropped(), 6);
+    EXPECT_EQ(stream.high_water_mark(), 4);
+}
+
+TEST(NotificationStream, DropNewest) {
+    auto peripheral = connected_peripheral();
+    auto stream = peripheral.indicate(SERVICE_UUID, CHARACTERISTIC_UUID,
+                                      {4, NotificationStream::OverflowPolicy::DROP_NEWEST});
+
+    auto first = stream.drain(2);
+    ASSERT_EQ(first.size(), 2);
+    EXPECT_EQ(first.front(), ByteArray(1, 0));
+
+    auto rest = stream.drain();
+    ASSERT_EQ(rest.size(), 2);
+    EXPECT_EQ(rest.back(), ByteArray(1, 3));
+    EXPECT_EQ(stream.received(), 10);
+    EXPECT_EQ(stream.dropped(), 6);
+}
+
+// The burst is delivered like events from a backend thread, which are never held up by a full stream.
+TEST(NotificationStream, BlockDropsOldestOnDispatchThreads) {
+    auto peripheral = connected_peripheral();
+    auto stream = peripheral.notify(SERVICE_UUID, CHARACTERISTIC_UUID,
+                                    {4, NotificationStream::OverflowPolicy::BLOCK});
+
+    auto payloads = stream.drain();
+    ASSERT_EQ(payloads.size(), 4);
+    EXPECT_EQ(payloads.front(), ByteArray(1, 6));
+    EXPECT_EQ(stream.dropped(), 6);
+}
+
+TEST(NotificationStream, CloseKeepsQueuedPayloads) {
+    auto peripheral = connected_peripheral();
+    auto stream = peripheral.notify(SERVICE_UUID, CHARACTERISTIC_UUID);
+
+    stream.close();
+    EXPECT_TRUE(stream.is_closed());
+    EXPECT_EQ(stream.drain(5).size(), 5);
+    EXPECT_EQ(stream.drain().size(), 5);
+    EXPECT_FALSE(stream.next().has_value());
+}
+
+TEST(NotificationStream, RequiresConnection) {
+    auto adapter = Adapter::get_adapters().at(0);
+    auto peripheral = adapter.scan_get_results().at(0);
+    EXPECT_THROW(peripheral.notify(SERVICE_UUID, CHARACTERISTIC_UUID), Exception::NotConnected);
+
+    Safe::Peripheral safe_peripheral(peripheral);
+    EXPECT_FALSE(safe_peripheral.notify(SERVICE_UUID, CHARACTERISTIC_UUID).has_value());
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <simpleble/SimpleBLE.h>
+
+#include "OperationScheduler.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace SimpleBLE;
+
+namespace {
+
+// Occupies a peripheral's slot until released, so that the operations queued meanwhile can be observed.
+class Blocker {
+  public:
+    Blocker(OperationScheduler& scheduler, std::string const& peripheral) {
+        thread_ = std::thread([this, &scheduler, peripheral] {
+            scheduler.run(peripheral, OperationPriority::CONTROL, [this] {
+                std::unique_lock<std::mutex> lock(mutex_);
+                running_ = true;
+                cv_.notify_all();
+                cv_.wait(lock, [this] { return released_; });
+            });
+        });
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return running_; });
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            released_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    bool released_ = false;
+    std::thread thread_;
+};
+
+size_t queued(OperationScheduler& scheduler) {
+    size_t total = 0;
+    for (auto const& stats : scheduler.stats()) {
+        total += stats.queued;
+    }
+    return total;
+}
+
+// Queues an operation from a new thread and waits until the scheduler has registered it.
+void enqueue(OperationScheduler& scheduler, std::vector<std::thread>& threads, std::string const& peripheral,
+             OperationPriority priority, std::string const& name, std::mutex& mutex, std::vector<std::string>& order) {
+    size_t expected = queued(scheduler) + 1;
+    threads.emplace_back([&scheduler, &mutex, &order, peripheral, priority, name] {
+        scheduler.run(peripheral, priority, [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        });
+    });
+
+    while (queued(scheduler) < expected) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+}  // namespace
+
+TEST(OperationScheduler, HigherPriorityRunsFirst) {
+    OperationScheduler scheduler(1);
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> threads;
+
+    Blocker blocker(scheduler, "blocker");
+    enqueue(scheduler, threads, "a", OperationPriority::BULK, "bulk", mutex, order);
+    enqueue(scheduler, threads, "b", OperationPriority::INTERACTIVE, "interactive", mutex, order);
+    enqueue(scheduler, threads, "c", OperationPriority::CONTROL, "control", mutex, order);
+    blocker.release();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"control", "interactive", "bulk"}));
+}
+
+TEST(OperationScheduler, PeripheralsTakeTurns) {
+    OperationScheduler scheduler(1);
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> threads;
+
+    Blocker blocker(scheduler, "blocker");
+    enqueue(scheduler, threads, "a", OperationPriority::BULK, "a1", mutex, order);
+    enqueue(scheduler, threads, "a", OperationPriority::BULK, "a2", mutex, order);
+    enqueue(scheduler, threads, "a", OperationPriority::BULK, "a3", mutex, order);
+    enqueue(scheduler, threads, "b", OperationPriority::BULK, "b1", mutex, order);
+    blocker.release();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"a1", "b1", "a2", "a3"}));
+}
+
+TEST(OperationScheduler, SerializesPerPeripheral) {
+    OperationScheduler scheduler;
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> threads;
+
+    // Without a global limit, a busy peripheral only holds back its own operations.
+    Blocker blocker(scheduler, "a");
+    enqueue(scheduler, threads, "a", OperationPriority::CONTROL, "a1", mutex, order);
+    scheduler.run("b", OperationPriority::BULK, [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back("b1");
+    });
+    blocker.release();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"b1", "a1"}));
+}
+
+TEST(OperationScheduler, ExceptionReleasesSlot) {
+    OperationScheduler scheduler(1);
+
+    EXPECT_THROW(scheduler.run("a", OperationPriority::INTERACTIVE, []() -> int { throw std::runtime_error("x"); }),
+                 std::runtime_error);
+    EXPECT_EQ(scheduler.run("a", OperationPriority::INTERACTIVE, [] { return 7; }), 7);
+
+    auto stats = scheduler.stats();
+    ASSERT_EQ(stats.size(), 3);
+    EXPECT_EQ(stats[1].priority, OperationPriority::INTERACTIVE);
+    EXPECT_EQ(stats[1].started, 2);
+    EXPECT_EQ(stats[1].queued, 0);
+    EXPECT_EQ(stats[0].started, 0);
+}
+
+TEST(OperationScheduler, SubmittedOperationsStartWhenReleased) {
+    OperationScheduler scheduler;
+    std::vector<std::string> order;
+
+    // A single thread drives several operations on one peripheral, each starting as the previous one completes.
+    scheduler.submit("a", OperationPriority::INTERACTIVE, [&] { order.push_back("a1"); });
+    scheduler.submit("a", OperationPriority::BULK, [&] { order.push_back("a2"); });
+    scheduler.submit("a", OperationPriority::CONTROL, [&] { order.push_back("a3"); });
+    scheduler.submit("b", OperationPriority::BULK, [&] { order.push_back("b1"); });
+    EXPECT_EQ(order, (std::vector<std::string>{"a1", "b1"}));
+
+    scheduler.release("a");
+    EXPECT_EQ(order, (std::vector<std::string>{"a1", "b1", "a3"}));
+
+    scheduler.release("a");
+    scheduler.release("a");
+    scheduler.release("b");
+    EXPECT_EQ(order, (std::vector<std::string>{"a1", "b1", "a3", "a2"}));
+    EXPECT_EQ(queued(scheduler), 0);
+}
+
+TEST(OperationScheduler, SubmittedAndBlockingOperationsShareSlots) {
+    OperationScheduler scheduler(1);
+    std::mutex mutex;
+    std::vector<std::string> order;
+    std::vector<std::thread> threads;
+
+    scheduler.submit("a", OperationPriority::INTERACTIVE, [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back("submitted");
+    });
+    enqueue(scheduler, threads, "b", OperationPriority::CONTROL, "blocking", mutex, order);
+    scheduler.release("a");
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"submitted", "blocking"}));
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <simpleble/SimpleBLE.h>
+
+#include "ScanBatcher.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace SimpleBLE;
+
+TEST(ScanBatcher, CoalescesPerKey) {
+    std::vector<std::vector<ScanEvent>> batches;
+    ScanBatcher batcher([&](std::vector<ScanEvent> const& events) { batches.push_back(events); },
+                        std::chrono::hours(1));
+
+    batcher.push(1, Peripheral(), true, 10);
+    batcher.push(2, Peripheral(), false, 11);
+    batcher.push(1, Peripheral(), false, 12);
+    batcher.push(1, Peripheral(), false, 13);
+    batcher.flush();
+
+    ASSERT_EQ(batches.size(), 1);
+    ASSERT_EQ(batches[0].size(), 2);
+    EXPECT_TRUE(batches[0][0].found);
+    EXPECT_EQ(batches[0][0].timestamp, 13);
+    EXPECT_EQ(batches[0][0].count, 3);
+    EXPECT_FALSE(batches[0][1].found);
+    EXPECT_EQ(batches[0][1].count, 1);
+
+    // Nothing pending, nothing delivered.
+    batcher.flush();
+    EXPECT_EQ(batches.size(), 1);
+}
+
+TEST(ScanBatcher, DeliversOnInterval) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t delivered = 0;
+
+    ScanBatcher batcher(
+        [&](std::vector<ScanEvent> const& events) {
+            std::lock_guard<std::mutex> lock(mutex);
+            delivered += events.size();
+            cv.notify_all();
+        },
+        std::chrono::milliseconds(5));
+
+    for (uint64_t key = 0; key < 100; key++) {
+        batcher.push(key % 10, Peripheral(), false, key);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return delivered == 10; }));
+}
+
+TEST(ScanBatcher, ConcurrentPushAndFlush) {
+    std::atomic_uint64_t advertisements{0};
+    ScanBatcher batcher(
+        [&](std::vector<ScanEvent> const& events) {
+            for (auto& event : events) advertisements += event.count;
+        },
+        std::chrono::milliseconds(1));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (uint64_t i = 0; i < 10000; i++) {
+                batcher.push((i + t) % 64, Peripheral(), false, i);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    batcher.flush();
+
+    EXPECT_EQ(advertisements, 40000);
+}
+
+TEST(ScanBatch, Frontend) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    std::vector<ScanEvent> received;
+    adapter.set_callback_on_scan_batch([&](std::vector<ScanEvent> const& events) {
+        received.insert(received.end(), events.begin(), events.end());
+    }, 60000);
+
+    // The plain backend reports the peripheral as found and as updated, which is delivered as one event
+    // when the scan stops.
+    adapter.scan_for(0);
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_TRUE(received[0].found);
+    EXPECT_EQ(received[0].peripheral.identifier(), "Plain Peripheral");
+
+    adapter.set_callback_on_scan_batch(nullptr);
+    adapter.scan_for(0);
+    EXPECT_EQ(received.size(), 1);
+}
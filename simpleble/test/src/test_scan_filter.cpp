@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <simpleble/SimpleBLE.h>
+
+#include "ScanFilterMatcher.h"
+
+using namespace SimpleBLE;
+
+// The plain backend reports a single peripheral named "Plain Peripheral",
+// with address 11:22:33:44:55:66, an RSSI of -60 dBm and no advertised services.
+static int count_found(Adapter& adapter) {
+    int found = 0;
+    adapter.set_callback_on_scan_found([&](Peripheral) { found++; });
+    adapter.scan_for(0);
+    return found;
+}
+
+TEST(ScanFilter, EmptyFilterReportsEverything) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+    EXPECT_EQ(count_found(adapter), 1);
+}
+
+TEST(ScanFilter, RssiThreshold) {
+    auto adapter = Adapter::get_adapters().at(0);
+
+    ScanFilter filter;
+    filter.rssi_threshold = -50;
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 0);
+
+    filter.rssi_threshold = -70;
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+}
+
+TEST(ScanFilter, Pattern) {
+    auto adapter = Adapter::get_adapters().at(0);
+
+    ScanFilter filter;
+    filter.pattern = "11:22";
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+
+    filter.pattern = "Plain";
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+
+    filter.pattern = "Indra";
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 0);
+}
+
+TEST(ScanFilter, ServiceUuids) {
+    auto adapter = Adapter::get_adapters().at(0);
+
+    ScanFilter filter;
+    filter.service_uuids = {"180f"};
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 0);
+}
+
+// Advertised services do not need to carry service data to match.
+TEST(ScanFilter, AdvertisedServiceUuids) {
+    ScanFilter filter;
+    filter.service_uuids = {"180f"};
+    ScanFilterMatcher matcher(filter);
+
+    advertising_data_t data = {};
+    AdvertisingDataScanSource source{data};
+    EXPECT_FALSE(matcher.matches(source));
+
+    data.service_uuids = {"0000180f-0000-1000-8000-00805f9b34fb"};
+    EXPECT_TRUE(matcher.matches(source));
+
+    data.service_uuids.clear();
+    data.service_data["0000180f-0000-1000-8000-00805f9b34fb"] = ByteArray("\x01");
+    EXPECT_TRUE(matcher.matches(source));
+}
+
+TEST(ScanFilter, Name) {
+    auto adapter = Adapter::get_adapters().at(0);
+
+    ScanFilter filter;
+    filter.name = "Plain Peripheral";
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+
+    filter.name = "Plain";
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 0);
+
+    filter.name = "";
+    filter.name_prefix = "Plain";
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+}
+
+// The plain backend advertises manufacturer data 01 02 03 04 for company identifier 0xFFFF.
+TEST(ScanFilter, ManufacturerData) {
+    auto adapter = Adapter::get_adapters().at(0);
+
+    ScanFilter filter;
+    filter.manufacturer_id = 0x004C;
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 0);
+
+    filter.manufacturer_id = 0xFFFF;
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+
+    filter.manufacturer_data = ByteArray("\x01\x02", 2);
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+
+    filter.manufacturer_data = ByteArray("\x01\xFF\x03", 3);
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 0);
+
+    filter.manufacturer_data_mask = ByteArray("\xFF\x00\xFF", 3);
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 1);
+
+    filter.manufacturer_data = ByteArray("\x01\x02\x03\x04\x05", 5);
+    filter.manufacturer_data_mask = "";
+    adapter.set_scan_filter(filter);
+    EXPECT_EQ(count_found(adapter), 0);
+}
+
+// The plain peripheral advertises twice per scan with the same payload, so the second advertisement is an update.
+TEST(ScanFilter, RssiChangeThreshold) {
+    auto adapter = Adapter::get_adapters().at(0);
+
+    int updated = 0;
+    adapter.set_callback_on_scan_updated([&](Peripheral) { updated++; });
+
+    adapter.set_scan_filter(ScanFilter());
+    adapter.scan_for(0);
+    EXPECT_EQ(updated, 1);
+
+    ScanFilter filter;
+    filter.rssi_change_threshold = 5;
+    adapter.set_scan_filter(filter);
+    updated = 0;
+    EXPECT_EQ(count_found(adapter), 1);
+    EXPECT_EQ(updated, 0);
+
+    // A zero threshold lets every update through.
+    filter.rssi_change_threshold = 0;
+    adapter.set_scan_filter(filter);
+    updated = 0;
+    EXPECT_EQ(count_found(adapter), 1);
+    EXPECT_EQ(updated, 1);
+}
@@ -0,0 +1,258 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <simpleble/SimpleBLE.h>
+
+#include "ScanResultTable.h"
+
+using namespace SimpleBLE;
+
+struct Entry {
+    uint64_t id;
+};
+
+using Table = ScanResultTable<Entry>;
+
+TEST(ScanResultTable, MakeKey) {
+    EXPECT_EQ(Table::make_key("11:22:33:44:55:66"), 0x112233445566ULL);
+    EXPECT_EQ(Table::make_key("aa:bb:cc:dd:ee:ff"), Table::make_key("AA:BB:CC:DD:EE:FF"));
+    EXPECT_NE(Table::make_key("11:22:33:44:55:66"), Table::make_key("11:22:33:44:55:67"));
+
+    // Non-MAC identifiers are hashed into a disjoint key range.
+    auto hashed = Table::make_key("F2A1D0B4-0000-1000-8000-00805F9B34FB");
+    EXPECT_NE(hashed & (1ULL << 63), 0ULL);
+}
+
+TEST(ScanResultTable, UpsertAndClearSeen) {
+    Table table;
+    int created = 0;
+    auto factory = [&]() { return std::make_shared<Entry>(Entry{uint64_t(created++)}); };
+
+    auto [first, first_seen] = table.upsert(1, factory);
+    EXPECT_TRUE(first_seen);
+    auto [again, again_seen] = table.upsert(1, factory);
+    EXPECT_FALSE(again_seen);
+    EXPECT_EQ(first, again);
+    EXPECT_EQ(table.seen().size(), 1);
+
+    table.clear_seen();
+    EXPECT_EQ(table.seen().size(), 0);
+
+    // Entries survive a new scan, but are reported as found again.
+    auto [rescanned, rescanned_seen] = table.upsert(1, factory);
+    EXPECT_TRUE(rescanned_seen);
+    EXPECT_EQ(rescanned, first);
+    EXPECT_EQ(created, 1);
+}
+
+TEST(ScanResultTable, SeenKeepsDiscoveryOrder) {
+    constexpr uint64_t DEVICE_COUNT = 200;
+
+    Table table;
+    for (uint64_t key = DEVICE_COUNT; key > 0; key--) {
+        table.upsert(key, [key]() { return std::make_shared<Entry>(Entry{key}); });
+    }
+    table.remove(DEVICE_COUNT);
+    table.upsert(DEVICE_COUNT, []() { return std::make_shared<Entry>(Entry{DEVICE_COUNT}); });
+
+    // A device that was lost and found again moves to the end.
+    auto seen = table.seen();
+    ASSERT_EQ(seen.size(), DEVICE_COUNT);
+    for (uint64_t i = 0; i + 1 < DEVICE_COUNT; i++) {
+        EXPECT_EQ(seen[i]->id, DEVICE_COUNT - 1 - i);
+    }
+    EXPECT_EQ(seen.back()->id, DEVICE_COUNT);
+}
+
+TEST(ScanResultTable, Changes) {
+    Table table;
+    auto make = [](uint64_t id) { return [id]() { return std::make_shared<Entry>(Entry{id}); }; };
+
+    table.upsert(1, make(1));
+    table.upsert(2, make(2));
+
+    auto full = table.changes(0);
+    EXPECT_FALSE(full.reset);
+    ASSERT_EQ(full.added.size(), 2);
+    EXPECT_EQ(full.added[0]->id, 1);
+    EXPECT_EQ(full.added[1]->id, 2);
+    EXPECT_TRUE(full.updated.empty());
+
+    auto none = table.changes(full.version);
+    EXPECT_TRUE(none.added.empty() && none.updated.empty() && none.lost.empty());
+
+    // Sightings only count as updates once they are deemed worth reporting.
+    table.upsert(1, make(1));
+    table.upsert(2, make(2));
+    table.mark_updated(2);
+    table.upsert(3, make(3));
+    table.remove(1);
+
+    auto delta = table.changes(none.version);
+    EXPECT_FALSE(delta.reset);
+    ASSERT_EQ(delta.added.size(), 1);
+    EXPECT_EQ(delta.added[0]->id, 3);
+    ASSERT_EQ(delta.updated.size(), 1);
+    EXPECT_EQ(delta.updated[0]->id, 2);
+    ASSERT_EQ(delta.lost.size(), 1);
+    EXPECT_EQ(delta.lost[0]->id, 1);
+    EXPECT_EQ(table.seen().size(), 2);
+
+    // A device that came and went between two calls was never reported, so it is not reported lost either.
+    table.upsert(4, make(4));
+    table.remove(4);
+    auto transient = table.changes(delta.version);
+    EXPECT_TRUE(transient.added.empty() && transient.lost.empty());
+
+    // Restarting the scan invalidates all previous versions.
+    table.clear_seen();
+    table.upsert(2, make(2));
+    auto restarted = table.changes(transient.version);
+    EXPECT_TRUE(restarted.reset);
+    ASSERT_EQ(restarted.added.size(), 1);
+    EXPECT_EQ(restarted.added[0]->id, 2);
+
+    // Versions from the future, such as those from another table, also require a reset.
+    EXPECT_TRUE(table.changes(restarted.version + 100).reset);
+}
+
+TEST(ScanResultTable, LostHistoryOverflow) {
+    Table table;
+    for (uint64_t key = 0; key < 2000; key++) {
+        table.upsert(key, [key]() { return std::make_shared<Entry>(Entry{key}); });
+    }
+    auto before = table.changes(0);
+
+    for (uint64_t key = 0; key < 2000; key++) {
+        table.remove(key);
+    }
+
+    // Too many devices were lost to be remembered individually, so the consumer must start over.
+    auto after = table.changes(before.version);
+    EXPECT_TRUE(after.reset);
+    EXPECT_TRUE(after.added.empty());
+}
+
+TEST(ScanResultTable, ConcurrentScanAndPoll) {
+    constexpr uint64_t DEVICE_COUNT = 256;
+    constexpr int WRITER_COUNT = 4;
+    constexpr int EVENTS_PER_WRITER = 20000;
+
+    Table table;
+    std::atomic_bool done{false};
+    std::atomic_int created{0};
+    std::atomic_int violations{0};
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITER_COUNT; w++) {
+        writers.emplace_back([&, w]() {
+            for (int i = 0; i < EVENTS_PER_WRITER; i++) {
+                uint64_t key = (uint64_t(i) * 7 + w) % DEVICE_COUNT;
+                auto [entry, first_seen] = table.upsert(key, [&]() {
+                    created++;
+                    return std::make_shared<Entry>(Entry{key});
+                });
+                if (entry->id != key) violations++;
+            }
+        });
+    }
+
+    // Restarts the scan every now and then, as scan_start() does.
+    std::thread restarter([&]() {
+        while (!done) {
+            table.clear_seen();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                auto snapshot = table.seen();
+                std::set<uint64_t> ids;
+                for (auto& entry : snapshot) {
+                    if (!ids.insert(entry->id).second) violations++;
+                }
+                if (snapshot.size() > DEVICE_COUNT) violations++;
+            }
+        });
+    }
+
+    for (auto& writer : writers) writer.join();
+    done = true;
+    restarter.join();
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(violations, 0);
+    EXPECT_EQ(created, int(DEVICE_COUNT));
+
+    // Once the scan is left alone, every device is reported exactly once.
+    table.clear_seen();
+    for (uint64_t key = 0; key < DEVICE_COUNT; key++) {
+        EXPECT_TRUE(table.upsert(key, []() { return std::make_shared<Entry>(); }).second);
+    }
+    EXPECT_EQ(table.seen().size(), DEVICE_COUNT);
+}
+
+TEST(ScanResultTable, ConcurrentChangesReportEachDeviceOnce) {
+    constexpr uint64_t DEVICE_COUNT = 2000;
+    constexpr int WRITER_COUNT = 4;
+
+    Table table;
+    std::atomic_int running{WRITER_COUNT};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITER_COUNT; w++) {
+        writers.emplace_back([&, w]() {
+            for (uint64_t key = w; key < DEVICE_COUNT; key += WRITER_COUNT) {
+                table.upsert(key, [key]() { return std::make_shared<Entry>(Entry{key}); });
+                table.mark_updated(key);
+            }
+            running--;
+        });
+    }
+
+    // Polls while devices are being found, then once more after all of them were.
+    std::multiset<uint64_t> added;
+    uint64_t version = 0;
+    bool finished = false;
+    while (!finished) {
+        finished = running == 0;
+        auto changes = table.changes(version);
+        EXPECT_FALSE(changes.reset);
+        for (auto& entry : changes.added) {
+            added.insert(entry->id);
+        }
+        for (auto& entry : changes.updated) {
+            EXPECT_EQ(added.count(entry->id), 1u);
+        }
+        version = changes.version;
+    }
+    for (auto& writer : writers) writer.join();
+
+    EXPECT_EQ(added.size(), DEVICE_COUNT);
+    EXPECT_EQ(std::set<uint64_t>(added.begin(), added.end()).size(), DEVICE_COUNT);
+}
+
+TEST(ScanChanges, Frontend) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    adapter.scan_for(0);
+    auto first = adapter.scan_get_changes(0);
+    ASSERT_EQ(first.added.size(), 1);
+    EXPECT_EQ(first.added[0].identifier(), "Plain Peripheral");
+
+    auto second = adapter.scan_get_changes(first.version);
+    EXPECT_FALSE(second.reset);
+    EXPECT_TRUE(second.added.empty() && second.updated.empty() && second.lost.empty());
+
+    adapter.scan_for(0);
+    auto third = adapter.scan_get_changes(second.version);
+    EXPECT_TRUE(third.reset);
+    EXPECT_EQ(third.added.size(), 1);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <simpleble/SimpleBLE.h>
+
+#include <chrono>
+#include <future>
+
+using namespace SimpleBLE;
+
+TEST(ScanUntil, ReturnsFirstMatch) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    bool scan_stopped = false;
+    adapter.set_callback_on_scan_stop([&]() { scan_stopped = true; });
+
+    auto peripheral = adapter.scan_until([](Peripheral p) { return p.identifier() == "Plain Peripheral"; }, 1000);
+    ASSERT_TRUE(peripheral.has_value());
+    EXPECT_EQ(peripheral->address(), "11:22:33:44:55:66");
+    EXPECT_TRUE(scan_stopped);
+    EXPECT_FALSE(adapter.scan_is_active());
+    EXPECT_FALSE(peripheral->is_connected());
+}
+
+TEST(ScanUntil, TimesOutWithoutMatch) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    auto peripheral = adapter.scan_until([](Peripheral) { return false; }, 10);
+    EXPECT_FALSE(peripheral.has_value());
+    EXPECT_FALSE(adapter.scan_is_active());
+}
+
+TEST(ScanUntil, LeavesUserScanRunning) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    adapter.scan_start();
+    auto peripheral = adapter.scan_until([](Peripheral) { return true; }, 1000);
+    EXPECT_TRUE(peripheral.has_value());
+    EXPECT_TRUE(adapter.scan_is_active());
+
+    auto rejected = adapter.scan_until_async([](Peripheral) { return false; }, 10);
+    ASSERT_EQ(rejected.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_TRUE(adapter.scan_is_active());
+    adapter.scan_stop();
+}
+
+TEST(ScanUntil, ScanCallbacksStillFire) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    int found = 0;
+    adapter.set_callback_on_scan_found([&](Peripheral) { found++; });
+    auto peripheral = adapter.scan_until([](Peripheral) { return true; }, 1000);
+    EXPECT_TRUE(peripheral.has_value());
+    EXPECT_EQ(found, 1);
+}
+
+TEST(ScanUntil, SafeFrontend) {
+    auto adapters = Safe::Adapter::get_adapters();
+    ASSERT_TRUE(adapters.has_value());
+    auto adapter = adapters->at(0);
+
+    auto peripheral = adapter.scan_until([](Safe::Peripheral p) { return p.identifier() == "Plain Peripheral"; },
+                                         1000, true);
+    ASSERT_TRUE(peripheral.has_value());
+    EXPECT_EQ(peripheral->is_connected(), true);
+
+    auto rejected = adapter.scan_until([](Safe::Peripheral) { return false; }, 10);
+    EXPECT_FALSE(rejected.has_value());
+}
+
+TEST(ScanUntil, AsyncReturnsFirstMatchOrTimesOut) {
+    auto adapter = Adapter::get_adapters().at(0);
+    adapter.set_scan_filter(ScanFilter());
+
+    auto match = adapter.scan_until_async([](Peripheral p) { return p.identifier() == "Plain Peripheral"; }, 1000);
+    ASSERT_EQ(match.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    auto peripheral = match.get();
+    ASSERT_TRUE(peripheral.has_value());
+    EXPECT_EQ(peripheral->address(), "11:22:33:44:55:66");
+    EXPECT_FALSE(adapter.scan_is_active());
+
+    auto rejected = adapter.scan_until_async([](Peripheral) { return false; }, 10);
+    ASSERT_EQ(rejected.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_FALSE(rejected.get().has_value());
+    EXPECT_FALSE(adapter.scan_is_active());
+}
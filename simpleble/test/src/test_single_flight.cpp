@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SingleFlight.h"
+
+using namespace SimpleBLE;
+
+TEST(SingleFlight, ConcurrentCallersShareOneExecution) {
+    SingleFlight<std::string, int> flights;
+    std::atomic<int> executions{0};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+
+    auto function = [&] {
+        executions++;
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return release; });
+        return 42;
+    };
+
+    std::vector<int> results(4, 0);
+    std::vector<std::thread> threads;
+    threads.emplace_back([&] { results[0] = flights.run("a", function); });
+    while (executions == 0) {
+        std::this_thread::yield();
+    }
+    for (size_t i = 1; i < results.size(); i++) {
+        threads.emplace_back([&, i] { results[i] = flights.run("a", function); });
+    }
+
+    // Give the late callers time to join the call in flight before it completes.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    cv.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(executions, 1);
+    EXPECT_EQ(results, (std::vector<int>{42, 42, 42, 42}));
+}
+
+TEST(SingleFlight, SequentialCallsExecuteAgain) {
+    SingleFlight<std::string, int> flights;
+    int executions = 0;
+
+    EXPECT_EQ(flights.run("a", [&] { return ++executions; }), 1);
+    EXPECT_EQ(flights.run("a", [&] { return ++executions; }), 2);
+    EXPECT_EQ(flights.run("b", [&] { return ++executions; }), 3);
+}
+
+TEST(SingleFlight, ExceptionIsPropagated) {
+    SingleFlight<std::string, int> flights;
+
+    EXPECT_THROW(flights.run("a", []() -> int { throw std::runtime_error("read failed"); }), std::runtime_error);
+    EXPECT_EQ(flights.run("a", [] { return 7; }), 7);
+}
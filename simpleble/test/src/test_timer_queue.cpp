@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "TimerQueue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace SimpleBLE;
+
+TEST(TimerQueueTest, RunsTasksInOrderOfDueTime) {
+    TimerQueue queue;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<int> order;
+
+    auto record = [&](int value) {
+        return [&, value]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+            cv.notify_all();
+        };
+    };
+
+    queue.schedule(60, record(3));
+    queue.schedule(20, record(1));
+    queue.schedule(20, record(2));
+    queue.schedule(0, record(0));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return order.size() == 4; }));
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(TimerQueueTest, FailingTaskDoesNotStopTheQueue) {
+    TimerQueue queue;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool ran = false;
+
+    queue.schedule(0, []() { throw std::runtime_error("failure"); });
+    queue.schedule(10, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ran = true;
+        cv.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return ran; }));
+}
+
+TEST(TimerQueueTest, PendingTasksAreDroppedOnDestruction) {
+    bool ran = false;
+    {
+        TimerQueue queue;
+        queue.schedule(60000, [&]() { ran = true; });
+    }
+    EXPECT_FALSE(ran);
+}
+
+TEST(TimerQueueTest, BlockedTaskDoesNotHoldUpOtherThreads) {
+    TimerQueue queue(2);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool released = false;
+    bool ran = false;
+
+    queue.schedule(0, [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return released; });
+    });
+    queue.schedule(10, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ran = true;
+        cv.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return ran; }));
+    released = true;
+    cv.notify_all();
+}
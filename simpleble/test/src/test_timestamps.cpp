@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include <simpleble/SimpleBLE.h>
+
+using namespace SimpleBLE;
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+TEST(Timestamps, ScanCallbacks) {
+    auto adapter = Adapter::get_adapters().at(0);
+
+    uint64_t found_timestamp = 0;
+    uint64_t updated_timestamp = 0;
+    adapter.set_callback_on_scan_found([&](Peripheral, uint64_t timestamp) { found_timestamp = timestamp; });
+    adapter.set_callback_on_scan_updated([&](Peripheral, uint64_t timestamp) { updated_timestamp = timestamp; });
+
+    uint64_t before = now_ns();
+    adapter.scan_for(0);
+    uint64_t after = now_ns();
+
+    EXPECT_GE(found_timestamp, before);
+    EXPECT_LE(found_timestamp, after);
+    EXPECT_GE(updated_timestamp, found_timestamp);
+
+    // Clearing the callbacks must not be ambiguous between the overloads.
+    adapter.set_callback_on_scan_found(nullptr);
+    adapter.set_callback_on_scan_updated(nullptr);
+    found_timestamp = 0;
+    adapter.scan_for(0);
+    EXPECT_EQ(found_timestamp, 0);
+}
+
+TEST(Timestamps, Notify) {
+    auto adapter = Adapter::get_adapters().at(0);
+    auto peripheral = adapter.scan_get_results().at(0);
+    peripheral.connect();
+
+    std::vector<uint64_t> timestamps;
+    uint64_t before = now_ns();
+    peripheral.notify("0000180f-0000-1000-8000-00805f9b34fb", "00002a19-0000-1000-8000-00805f9b34fb",
+                      [&](ByteArray, uint64_t timestamp) { timestamps.push_back(timestamp); });
+    uint64_t after = now_ns();
+
+    ASSERT_FALSE(timestamps.empty());
+    EXPECT_GE(timestamps.front(), before);
+    EXPECT_LE(timestamps.back(), after);
+    for (size_t i = 1; i < timestamps.size(); i++) {
+        EXPECT_GE(timestamps[i], timestamps[i - 1]);
+    }
+
+    peripheral.notify("0000180f-0000-1000-8000-00805f9b34fb", "00002a19-0000-1000-8000-00805f9b34fb", nullptr);
+    Safe::Peripheral safe_peripheral(peripheral);
+    EXPECT_TRUE(safe_peripheral.indicate("0000180f-0000-1000-8000-00805f9b34fb",
+                                         "00002a19-0000-1000-8000-00805f9b34fb", nullptr));
+}
@@ -40,70 +40,32 @@ int main() {
 
     auto adapter = adapter_optional.value();
 
-    std::vector<SimpleBLE::Peripheral> peripherals;
-
     adapter.set_callback_on_scan_start([]() { std::cout << "Scan started." << std::endl; });
     adapter.set_callback_on_scan_stop([]() { std::cout << "Scan stopped." << std::endl; });
-    
-    // Start the scan 
-    adapter.scan_start();
-
-    // Set a boolean to indicate that the scan if happening
-    bool Scan_Active = true;
 
     // Initialise a counter to measure the delay time
     uint8_t Counter = 0;
 
-    // Initialise an Index to keep track of devices found
-    uint8_t Device_Index = 0;
-
-    // Initialise a string to hold the peripheral identifier
-    std::string New_Identifier;
-
-    // Declare a variable to store the index of the target device
-    uint8_t Target_Index = 0;
-
-    // Start a while loop for Delay Time and the Scan is Active
-    while ((Counter < DELAY_TIME) && (Scan_Active))
+    // Scan until the App is seen, for at most Delay Time seconds. The scan is
+    // stopped as soon as the target is found.
+    auto Target = adapter.scan_until([&](SimpleBLE::Peripheral peripheral)
     {
-        adapter.set_callback_on_scan_found([&](SimpleBLE::Peripheral peripheral) 
-        {
-            peripherals.push_back(peripheral);
-            // Does the peripheral identifier match the App name
-            if (peripheral.identifier() == INSTALLER_APP_NAME)
-            {
-                std::cout << "Found device Target" << std::endl;
-                // Exit the while loop
-                Scan_Active = false;
-                // Stop the scan
-                adapter.scan_stop();
-                // This is the device we want so to keep this index value
-                Target_Index = Device_Index;
-            }
-            else
-            {
-                // Not our device so increment the Device Index
-                Device_Index++;
-            }
-        });
-
-        // Add a delay
-        std::this_thread::sleep_for(1s);
+        // Does the peripheral identifier match the App name
+        return peripheral.identifier() == INSTALLER_APP_NAME;
+    }, DELAY_TIME * 1000);
 
-        // Increment the counter
-        Counter++;
-    }
-     
-    // If Scan Active is still false at this point then we have timed out so no
-    // App was detected and so we should exit with an error
-    if (Scan_Active)
+    // If no target was returned then we have timed out so no App was
+    // detected and so we should exit with an error
+    if (!Target.has_value())
     {
         std::cout << "Error: No Target Device Found" << std::endl;
         return EXIT_FAILURE;
-    } 
-    
-    // Scan was a success so select the device to connect to from vector list
-    auto peripheral = peripherals[Target_Index];
+    }
+
+    std::cout << "Found device Target" << std::endl;
+
+    // Scan was a success so select the device to connect to
+    auto peripheral = Target.value();
     
     // Declare a boolean to check is we are connected to the App
     bool App_Connected = false;
@@ -5,7 +5,11 @@
 #include <simplebluez/Device.h>
 #include <simplebluez/interfaces/Adapter1.h>
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace SimpleBluez {
 
@@ -13,6 +17,16 @@ class Adapter : public SimpleDBus::Proxy {
   public:
     typedef Adapter1::DiscoveryFilter DiscoveryFilter;
 
+    // Cached state of a device, read without creating its proxy.
+    struct DeviceInfo {
+        std::string path;
+        std::string address;
+        bool connected = false;
+        bool paired = false;
+        // Zero if the device has not been heard from since it was loaded.
+        uint64_t last_update_timestamp = 0;
+    };
+
     Adapter(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path);
     virtual ~Adapter();
 
@@ -30,14 +44,45 @@ class Adapter : public SimpleDBus::Proxy {
     void device_remove(const std::shared_ptr<Device>& device);
     std::vector<std::shared_ptr<Device>> device_paired_get();
 
+    /**
+     * @brief Returns every device currently known to BlueZ under this adapter.
+     */
+    std::vector<std::shared_ptr<Device>> device_list();
+
+    /**
+     * @brief Returns the cached state of every device known to BlueZ under this adapter, without creating proxies
+     *        for deferred devices.
+     */
+    std::vector<DeviceInfo> device_info_list();
+
+    /**
+     * @brief Number of device objects held, including removed devices still referenced elsewhere.
+     */
+    size_t device_count();
+
     void set_on_device_updated(std::function<void(std::shared_ptr<Device> device)> callback);
+    void set_on_device_updated(std::function<void(std::shared_ptr<Device> device, uint64_t timestamp)> callback);
     void clear_on_device_updated();
 
+    /**
+     * @brief Invoked when BlueZ drops a device object, either because it expired or was removed.
+     *
+     * @note The device is no longer valid, but its last known properties can still be read.
+     */
+    void set_on_device_removed(std::function<void(std::shared_ptr<Device> device)> callback);
+    void clear_on_device_removed();
+
   private:
     std::shared_ptr<SimpleDBus::Proxy> path_create(const std::string& path) override;
     std::shared_ptr<SimpleDBus::Interface> interfaces_create(const std::string& interface_name) override;
 
     std::shared_ptr<Adapter1> adapter1();
+
+    // Property changes of the adapter itself, subscribed to for its whole lifetime.
+    const std::string _properties_rule;
+    // Device1 property changes of the devices below the adapter, subscribed to while discovering.
+    const std::string _discovery_rule;
+    std::atomic_bool _discovery_subscribed{false};
 };
 
 }  // namespace SimpleBluez
@@ -1,23 +1,85 @@
 #pragma once
 
 #include <simpledbus/advanced/Proxy.h>
+#include <simpledbus/base/ConnectionPool.h>
 #include <simpledbus/interfaces/ObjectManager.h>
 
 #include <simplebluez/Adapter.h>
 #include <simplebluez/Agent.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace SimpleBluez {
 
 class Bluez : public SimpleDBus::Proxy {
   public:
-    Bluez();
+    /**
+     * @param adapter_connections Number of private connections over which adapters are spread, each adapter and
+     *                            everything below it using a single one of them. With zero, all traffic goes
+     *                            through the connection libdbus shares within the process.
+     */
+    explicit Bluez(size_t adapter_connections = 0);
     virtual ~Bluez();
 
-    void init();
+    /**
+     * @brief Connects to the bus and loads the objects managed by BlueZ.
+     *
+     * @param lazy If set, only adapters are created up front. Devices and their GATT objects are kept as raw
+     *             properties until first accessed or signalled, which keeps startup fast on systems that
+     *             remember thousands of devices.
+     */
+    void init(bool lazy = false);
+
+    /**
+     * @brief Processes the messages received since the last call. Equivalent to process_pending().
+     */
     void run_async();
 
+    /**
+     * @brief Descriptor to watch for readability when driving SimpleBluez from an external event loop, instead of
+     *        calling run_async() periodically from a dedicated thread.
+     *
+     * @note Call process_pending() whenever it is readable.
+     */
+    int poll_fd();
+
+    /**
+     * @brief Processes every message already received, without blocking.
+     */
+    void process_pending();
+
+    /**
+     * @brief Number of connections carrying traffic, the first one being the main connection and the others
+     *        those adapters are spread over.
+     */
+    size_t connection_count() const;
+
+    /**
+     * @brief Processes the messages already received on a single connection, without blocking.
+     *
+     * @note Each connection can be processed from a thread of its own.
+     */
+    void process_pending(size_t connection);
+
+    /**
+     * @brief Reloads the objects managed by BlueZ, applying only the differences to the existing tree.
+     *
+     * @details Proxies that are still present keep their callbacks and outstanding references, and the
+     *          pairing agent is registered again if it was before.
+     *
+     * @note Invoked automatically whenever org.bluez gets a new owner, such as after bluetoothd restarts. The
+     *       automatic resynchronization runs on a thread of its own, and the messages received on the main
+     *       connection meanwhile are handled once it completes, in the order they arrived.
+     */
+    void resync();
+
     std::vector<std::shared_ptr<Adapter>> get_adapters();
     std::shared_ptr<Agent> get_agent();
     void register_agent();
@@ -27,7 +89,35 @@ class Bluez : public SimpleDBus::Proxy {
 
     std::shared_ptr<SimpleDBus::ObjectManager> object_manager();
 
+    void name_owner_changed(SimpleDBus::Message& message);
+    void resync_run();
+    bool should_defer(const std::string& path) const;
+
+    std::shared_ptr<SimpleDBus::Connection> adapter_connection(const std::string& path);
+    void dispatch(SimpleDBus::Message& message, bool main_connection);
+
     std::shared_ptr<Agent> _agent;
+    std::atomic_bool _agent_registered{false};
+    bool _lazy = false;
+
+    // Private connections the adapters are spread over, if any. Match rules are only added once per adapter.
+    std::unique_ptr<SimpleDBus::ConnectionPool> _pool;
+    std::mutex _pool_mutex;
+    std::set<std::string> _pool_subscribed;
+    std::vector<std::string> _matches;
+
+    // Combines the descriptors of every connection when adapters have connections of their own.
+    int _poll_fd = -1;
+
+    // Reloading thousands of objects takes long enough to stall every signal if done while dispatching, so
+    // it is left to a thread started on the first owner change.
+    std::thread _resync_thread;
+    std::mutex _resync_mutex;
+    std::condition_variable _resync_cv;
+    bool _resync_pending = false;
+    bool _resync_active = false;
+    bool _resync_stopping = false;
+    std::deque<SimpleDBus::Message> _resync_backlog;
 };
 
 }  // namespace SimpleBluez
@@ -6,7 +6,9 @@
 #include <simplebluez/Types.h>
 #include <simplebluez/interfaces/GattCharacteristic1.h>
 
+#include <atomic>
 #include <cstdlib>
+#include <string>
 
 namespace SimpleBluez {
 
@@ -23,18 +25,34 @@ class Characteristic : public SimpleDBus::Proxy {
     void write_command(ByteArray value);
     void start_notify();
     void stop_notify();
+    void stop_notify_async();
+
+    // Send the call and return without waiting for its reply, so that several can be in flight at once.
+    SimpleDBus::PendingCall read_start();
+    ByteArray read_finish(SimpleDBus::PendingCall& call);
+    SimpleDBus::PendingCall write_request_start(ByteArray value);
+    SimpleDBus::PendingCall write_command_start(ByteArray value);
+
+    // Return right away, the outcome being reported to the callback from the thread receiving the reply.
+    void read(std::function<void(ByteArray value, std::exception_ptr error)> callback);
+    void write_request(ByteArray value, std::function<void(std::exception_ptr error)> callback);
+    void write_command(ByteArray value, std::function<void(std::exception_ptr error)> callback);
+    void start_notify(std::function<void(std::exception_ptr error)> callback);
+    void stop_notify(std::function<void(std::exception_ptr error)> callback);
 
     // ----- PROPERTIES -----
     std::vector<std::shared_ptr<Descriptor>> descriptors();
 
     std::string uuid();
     ByteArray value();
-    bool notifying();
+    uint64_t value_timestamp();
+    bool notifying(bool refresh = true);
     std::vector<std::string> flags();
     uint16_t mtu();
 
     // ----- CALLBACKS -----
     void set_on_value_changed(std::function<void(ByteArray new_value)> callback);
+    void set_on_value_changed(std::function<void(ByteArray new_value, uint64_t timestamp)> callback);
     void clear_on_value_changed();
 
   private:
@@ -42,6 +60,12 @@ class Characteristic : public SimpleDBus::Proxy {
     std::shared_ptr<SimpleDBus::Interface> interfaces_create(const std::string& interface_name) override;
 
     std::shared_ptr<GattCharacteristic1> gattcharacteristic1();
+
+    void notify_subscribe();
+    void notify_unsubscribe();
+
+    const std::string _notify_rule;
+    std::atomic_bool _notify_subscribed{false};
 };
 
 }  // namespace SimpleBluez
@@ -7,6 +7,9 @@
 #include <simplebluez/interfaces/Battery1.h>
 #include <simplebluez/interfaces/Device1.h>
 
+#include <atomic>
+#include <string>
+
 namespace SimpleBluez {
 
 class Device : public SimpleDBus::Proxy {
@@ -29,16 +32,29 @@ class Device : public SimpleDBus::Proxy {
     int16_t rssi();
     int16_t tx_power();
 
-    std::map<uint16_t, std::vector<uint8_t>> manufacturer_data();
+    std::map<uint16_t, std::vector<uint8_t>> manufacturer_data(bool refresh = true);
     std::map<std::string, std::vector<uint8_t>> service_data();
+    uint64_t payload_fingerprint();
 
-    bool paired();
-    bool connected();
-    bool services_resolved();
+    bool paired(bool refresh = true);
+    bool connected(bool refresh = true);
+    bool services_resolved(bool refresh = true);
 
     // ----- METHODS -----
+    /**
+     * @brief Subscribes to the property changes of the device and of its services, characteristics and
+     *        descriptors. Only tracked devices, and devices seen while their adapter is discovering, are kept up to
+     *        date. Connecting or pairing tracks the device, which stays tracked until untrack() or its destruction.
+     */
+    void track();
+    void untrack();
+
     void connect();
     void disconnect();
+
+    // Return right away, the outcome being reported to the callback from the thread receiving the reply.
+    void connect(std::function<void(std::exception_ptr error)> callback);
+    void disconnect(std::function<void(std::exception_ptr error)> callback);
     void pair();
     void cancel_pairing();
 
@@ -60,6 +76,9 @@ class Device : public SimpleDBus::Proxy {
 
     std::shared_ptr<Device1> device1();
     std::shared_ptr<Battery1> battery1();
+
+    const std::string _tracking_rule;
+    std::atomic_bool _tracked{false};
 };
 
 }  // namespace SimpleBluez
@@ -5,11 +5,17 @@
 #include <simplebluez/Adapter.h>
 #include <simplebluez/Agent.h>
 
+#include <functional>
+
 namespace SimpleBluez {
 
 class ProxyOrg : public SimpleDBus::Proxy {
   public:
-    ProxyOrg(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path);
+    // Picks the connection used by an adapter and everything below it.
+    using ConnectionProvider = std::function<std::shared_ptr<SimpleDBus::Connection>(const std::string& path)>;
+
+    ProxyOrg(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path,
+             ConnectionProvider adapter_connection = nullptr);
     virtual ~ProxyOrg() = default;
 
     std::vector<std::shared_ptr<Adapter>> get_adapters();
@@ -18,6 +24,8 @@ class ProxyOrg : public SimpleDBus::Proxy {
   private:
     std::shared_ptr<SimpleDBus::Proxy> path_create(const std::string& path) override;
     std::shared_ptr<SimpleDBus::Interface> interfaces_create(const std::string& interface_name) override;
+
+    ConnectionProvider _adapter_connection;
 };
 
 }  // namespace SimpleBluez
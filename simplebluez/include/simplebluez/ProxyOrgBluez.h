@@ -4,6 +4,7 @@
 
 #include <simplebluez/Adapter.h>
 #include <simplebluez/Agent.h>
+#include <simplebluez/ProxyOrg.h>
 
 #include <simplebluez/interfaces/AgentManager1.h>
 
@@ -11,7 +12,8 @@ namespace SimpleBluez {
 
 class ProxyOrgBluez : public SimpleDBus::Proxy {
   public:
-    ProxyOrgBluez(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path);
+    ProxyOrgBluez(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path,
+                  ProxyOrg::ConnectionProvider adapter_connection = nullptr);
     virtual ~ProxyOrgBluez() = default;
 
     void register_agent(std::shared_ptr<Agent> agent);
@@ -22,6 +24,8 @@ class ProxyOrgBluez : public SimpleDBus::Proxy {
     std::shared_ptr<SimpleDBus::Proxy> path_create(const std::string& path) override;
     std::shared_ptr<SimpleDBus::Interface> interfaces_create(const std::string& interface_name) override;
     std::shared_ptr<AgentManager1> agentmanager1();
+
+    ProxyOrg::ConnectionProvider _adapter_connection;
 };
 
 }  // namespace SimpleBluez
@@ -3,6 +3,9 @@
 #include <simpledbus/advanced/Interface.h>
 #include <simpledbus/external/kvn_safe_callback.hpp>
 
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <string>
 
 namespace SimpleBluez {
@@ -14,7 +17,11 @@ class Device1 : public SimpleDBus::Interface {
 
     // ----- METHODS -----
     void Connect();
+
+    // Reports the outcome to the callback, from the thread receiving the reply.
+    void Connect(std::function<void(std::exception_ptr error)> callback);
     void Disconnect();
+    void Disconnect(std::function<void(std::exception_ptr error)> callback);
     void Pair();
     void CancelPairing();
 
@@ -33,6 +40,13 @@ class Device1 : public SimpleDBus::Interface {
     bool Connected(bool refresh = true);
     bool ServicesResolved(bool refresh = true);
 
+    /**
+     * @brief Cheap fingerprint of the advertised payload: name, UUIDs, manufacturer data and service data.
+     *
+     * @note Maintained as properties change, so reading it costs no parsing. RSSI is deliberately left out.
+     */
+    uint64_t PayloadFingerprint() const;
+
     // ----- CALLBACKS -----
     kvn::safe_callback<void()> OnServicesResolved;
     kvn::safe_callback<void()> OnDisconnected;
@@ -50,6 +64,14 @@ class Device1 : public SimpleDBus::Interface {
     bool _services_resolved;
     std::map<uint16_t, std::vector<uint8_t>> _manufacturer_data;
     std::map<std::string, std::vector<uint8_t>> _service_data;
+
+    uint64_t _name_hash = 0;
+    uint64_t _uuids_hash = 0;
+    uint64_t _manufacturer_data_hash = 0;
+    uint64_t _service_data_hash = 0;
+    std::atomic_uint64_t _payload_fingerprint{0};
+
+    void update_payload_fingerprint();
 };
 
 }  // namespace SimpleBluez
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <simpledbus/advanced/Interface.h>
+#include <simpledbus/base/PendingCall.h>
 #include <simpledbus/external/kvn_safe_callback.hpp>
 
 #include <simplebluez/Types.h>
 
+#include <exception>
+#include <functional>
 #include <string>
 
 namespace SimpleBluez {
@@ -19,12 +22,34 @@ class GattCharacteristic1 : public SimpleDBus::Interface {
     // ----- METHODS -----
     void StartNotify();
     void StopNotify();
+
+    // Sends StopNotify without waiting for, or receiving, a reply.
+    void StopNotifyNoReply();
+
     void WriteValue(const ByteArray& value, WriteType type);
     ByteArray ReadValue();
 
+    // Variants that return as soon as the call is sent, so that several can be in flight at once.
+    SimpleDBus::PendingCall WriteValueStart(const ByteArray& value, WriteType type);
+    SimpleDBus::PendingCall ReadValueStart();
+    ByteArray ReadValueFinish(SimpleDBus::PendingCall& call);
+
+    // Variants that report their outcome to the callback, from the thread receiving the reply.
+    // The interface must be kept alive until the callback has run.
+    void StartNotify(std::function<void(std::exception_ptr error)> callback);
+    void StopNotify(std::function<void(std::exception_ptr error)> callback);
+    void WriteValue(const ByteArray& value, WriteType type, std::function<void(std::exception_ptr error)> callback);
+    void ReadValue(std::function<void(ByteArray value, std::exception_ptr error)> callback);
+
     // ----- PROPERTIES -----
     std::string UUID();
     ByteArray Value();
+
+    /**
+     * @brief Time at which the cached value was last updated, by a read or a notification, in nanoseconds on
+     *        std::chrono::steady_clock. Zero if no value has been received yet.
+     */
+    uint64_t ValueTimestamp();
     bool Notifying(bool refresh = true);
     std::vector<std::string> Flags();
     uint16_t MTU();
@@ -34,10 +59,15 @@ class GattCharacteristic1 : public SimpleDBus::Interface {
 
   protected:
     void property_changed(std::string option_name) override;
-    void update_value(SimpleDBus::Holder& new_value);
+    void update_value(SimpleDBus::Holder& new_value, uint64_t timestamp);
+
+    SimpleDBus::Message create_write_value_call(const ByteArray& value, WriteType type);
+    SimpleDBus::Message create_read_value_call();
+    ByteArray read_value_reply(SimpleDBus::Message& reply_msg);
 
     std::string _uuid;
     ByteArray _value;
+    uint64_t _value_timestamp = 0;
 };
 
 }  // namespace SimpleBluez
@@ -3,12 +3,29 @@
 
 #include <simplebluez/interfaces/Adapter1.h>
 
+#include "Logging.h"
+
 using namespace SimpleBluez;
 
 Adapter::Adapter(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path)
-    : Proxy(conn, bus_name, path) {}
+    : Proxy(conn, bus_name, path),
+      _properties_rule(SimpleDBus::MatchRules::properties_changed(bus_name, path, false)),
+      _discovery_rule(SimpleDBus::MatchRules::properties_changed(bus_name, path, true, "org.bluez.Device1")) {
+    if (_conn->is_initialized()) {
+        _conn->match_rules().add(_properties_rule);
+    }
+}
 
-Adapter::~Adapter() {}
+Adapter::~Adapter() {
+    try {
+        _conn->match_rules().remove(_properties_rule);
+        if (_discovery_subscribed.exchange(false)) {
+            _conn->match_rules().remove(_discovery_rule);
+        }
+    } catch (const std::exception& e) {
+        LOG_WARN("Failed to unsubscribe from {}: {}", _path, e.what());
+    }
+}
 
 std::shared_ptr<SimpleDBus::Proxy> Adapter::path_create(const std::string& path) {
     auto child = std::make_shared<Device>(_conn, _bus_name, path);
@@ -41,9 +58,31 @@ bool Adapter::powered() { return adapter1()->Powered(); }
 
 void Adapter::discovery_filter(const DiscoveryFilter& filter) { adapter1()->SetDiscoveryFilter(filter); }
 
-void Adapter::discovery_start() { adapter1()->StartDiscovery(); }
+void Adapter::discovery_start() {
+    // Devices in range only report their advertisements to us while we are discovering.
+    bool subscribed = !_discovery_subscribed.exchange(true);
+    if (subscribed) {
+        _conn->match_rules().add(_discovery_rule);
+    }
+
+    try {
+        adapter1()->StartDiscovery();
+    } catch (...) {
+        if (subscribed) {
+            _discovery_subscribed = false;
+            _conn->match_rules().remove(_discovery_rule);
+        }
+        throw;
+    }
+}
 
-void Adapter::discovery_stop() { adapter1()->StopDiscovery(); }
+void Adapter::discovery_stop() {
+    adapter1()->StopDiscovery();
+
+    if (_discovery_subscribed.exchange(false)) {
+        _conn->match_rules().remove(_discovery_rule);
+    }
+}
 
 std::shared_ptr<Device> Adapter::device_get(const std::string& path) {
     return std::dynamic_pointer_cast<Device>(path_get(path));
@@ -54,9 +93,23 @@ void Adapter::device_remove(const std::string& path) { adapter1()->RemoveDevice(
 void Adapter::device_remove(const std::shared_ptr<Device>& device) { adapter1()->RemoveDevice(device->path()); }
 
 std::vector<std::shared_ptr<Device>> Adapter::device_paired_get() {
+    std::scoped_lock lock(_child_access_mutex);
+
+    // Deferred devices are only created if their cached properties say they are paired.
+    path_materialize_if([](const SimpleDBus::Holder& managed_interfaces) {
+        auto interfaces = managed_interfaces.get_dict_string();
+        auto device1 = interfaces.find("org.bluez.Device1");
+        if (device1 == interfaces.end()) {
+            return false;
+        }
+
+        auto properties = device1->second.get_dict_string();
+        auto paired = properties.find("Paired");
+        return paired != properties.end() && paired->second.get_boolean();
+    });
+
     // Traverse all child paths and return only those that are paired.
     std::vector<std::shared_ptr<Device>> paired_devices;
-
     for (auto& [path, child] : _children) {
         if (!child->valid()) continue;
 
@@ -69,6 +122,56 @@ std::vector<std::shared_ptr<Device>> Adapter::device_paired_get() {
     return paired_devices;
 }
 
+std::vector<std::shared_ptr<Device>> Adapter::device_list() {
+    std::vector<std::shared_ptr<Device>> devices;
+
+    for (auto& device : children_casted<Device>()) {
+        if (device && device->valid()) {
+            devices.push_back(device);
+        }
+    }
+
+    return devices;
+}
+
+std::vector<Adapter::DeviceInfo> Adapter::device_info_list() {
+    std::scoped_lock lock(_child_access_mutex);
+
+    std::vector<DeviceInfo> devices;
+    for (auto& [path, child] : _children) {
+        std::shared_ptr<Device> device = std::dynamic_pointer_cast<Device>(child);
+        if (!device || !device->valid()) continue;
+
+        devices.push_back(DeviceInfo{path, device->address(), device->connected(false), device->paired(false),
+                                     device->last_update_timestamp()});
+    }
+
+    // Deferred devices are described by the properties they were loaded with.
+    for (auto& [path, objects] : _deferred) {
+        auto own = objects.find(path);
+        if (own == objects.end()) continue;
+
+        auto interfaces = own->second.get_dict_string();
+        auto device1 = interfaces.find("org.bluez.Device1");
+        if (device1 == interfaces.end()) continue;
+
+        auto properties = device1->second.get_dict_string();
+        DeviceInfo info;
+        info.path = path;
+        if (properties.count("Address")) info.address = properties["Address"].get_string();
+        if (properties.count("Connected")) info.connected = properties["Connected"].get_boolean();
+        if (properties.count("Paired")) info.paired = properties["Paired"].get_boolean();
+        devices.push_back(info);
+    }
+
+    return devices;
+}
+
+size_t Adapter::device_count() {
+    std::scoped_lock lock(_child_access_mutex);
+    return _children.size() + _deferred.size();
+}
+
 void Adapter::set_on_device_updated(std::function<void(std::shared_ptr<Device> device)> callback) {
     auto on_device_updated = [this, callback](std::string child_path) {
         auto device = device_get(child_path);
@@ -81,7 +184,30 @@ void Adapter::set_on_device_updated(std::function<void(std::shared_ptr<Device> d
     on_child_signal_received.load(on_device_updated);
 }
 
+void Adapter::set_on_device_updated(std::function<void(std::shared_ptr<Device> device, uint64_t timestamp)> callback) {
+    auto on_device_updated = [this, callback](std::string child_path) {
+        auto device = device_get(child_path);
+        if (device) {
+            callback(device, device->last_update_timestamp());
+        }
+    };
+
+    on_child_created.load(on_device_updated);
+    on_child_signal_received.load(on_device_updated);
+}
+
 void Adapter::clear_on_device_updated() {
     on_child_created.unload();
     on_child_signal_received.unload();
 }
+
+void Adapter::set_on_device_removed(std::function<void(std::shared_ptr<Device> device)> callback) {
+    on_child_removed.load([this, callback](std::string child_path) {
+        auto device = device_get(child_path);
+        if (device) {
+            callback(device);
+        }
+    });
+}
+
+void Adapter::clear_on_device_removed() { on_child_removed.unload(); }
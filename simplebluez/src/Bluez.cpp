@@ -1,68 +1,333 @@
 #include <simplebluez/Bluez.h>
 #include <simplebluez/ProxyOrg.h>
+#include <simpledbus/base/Exceptions.h>
+#include <simpledbus/base/Path.h>
 #include <simpledbus/interfaces/ObjectManager.h>
 
+#include "Logging.h"
+
+#include <algorithm>
+#include <chrono>
+
 #include <iostream>
 
+#include <sys/epoll.h>
+#include <unistd.h>
+
 using namespace SimpleBluez;
 
+// Adapters live at /org/bluez/hciX, everything deeper belongs to a device.
+static constexpr size_t ADAPTER_PATH_ELEMENTS = 3;
+
+// Only the object manager signals are subscribed to for the whole tree, as they announce and remove objects.
+// Property changes are subscribed to by the objects that need them, for as long as they do, which spares the
+// process the traffic of every device in range.
+static const char* OBJECT_MANAGER_MATCH =
+    "type='signal',sender='org.bluez',path='/',interface='org.freedesktop.DBus.ObjectManager'";
+
+// The bus keeps matching signals sent by org.bluez across owner changes, so this is the only extra
+// subscription needed to notice that bluetoothd went away or came back.
+static const char* NAME_OWNER_CHANGED_MATCH =
+    "type='signal',sender='org.freedesktop.DBus',interface='org.freedesktop.DBus',member='NameOwnerChanged',"
+    "arg0='org.bluez'";
+
+// Messages taken off the connection per lock acquisition. Bounded so that senders are not held up for long.
+static constexpr size_t DRAIN_BATCH_SIZE = 64;
+
 #ifdef SIMPLEBLUEZ_USE_SESSION_DBUS
 #define DBUS_BUS DBUS_BUS_SESSION
 #else
 #define DBUS_BUS DBUS_BUS_SYSTEM
 #endif
 
-Bluez::Bluez() : Proxy(std::make_shared<SimpleDBus::Connection>(DBUS_BUS), "org.bluez", "/") {
+Bluez::Bluez(size_t adapter_connections)
+    : Proxy(std::make_shared<SimpleDBus::Connection>(DBUS_BUS), "org.bluez", "/") {
+    if (adapter_connections > 0) {
+        _pool = std::make_unique<SimpleDBus::ConnectionPool>(DBUS_BUS, adapter_connections);
+    }
+
     _interfaces["org.freedesktop.DBus.ObjectManager"] = std::static_pointer_cast<SimpleDBus::Interface>(
         std::make_shared<SimpleDBus::ObjectManager>(_conn, "org.bluez", "/"));
 
-    object_manager()->InterfacesAdded = [&](std::string path, SimpleDBus::Holder options) { path_add(path, options); };
+    // The signal was routed through this proxy, so its receive timestamp is the one of the InterfacesAdded message.
+    object_manager()->InterfacesAdded = [&](std::string path, SimpleDBus::Holder options) {
+        path_add(path, options, last_update_timestamp());
+    };
     object_manager()->InterfacesRemoved = [&](std::string path, SimpleDBus::Holder options) {
         path_remove(path, options);
     };
 }
 
 Bluez::~Bluez() {
+    {
+        std::lock_guard<std::mutex> lock(_resync_mutex);
+        _resync_stopping = true;
+    }
+    _resync_cv.notify_all();
+    if (_resync_thread.joinable()) {
+        _resync_thread.join();
+    }
+
     if (_conn->is_initialized()) {
-        _conn->remove_match("type='signal',sender='org.bluez'");
+        for (auto& rule : _matches) {
+            _conn->match_rules().remove(rule);
+        }
+    }
+
+    // Rules added on the connections of the pool go away along with them.
+    if (_pool) {
+        _pool->uninit();
+    }
+
+    if (_poll_fd >= 0) {
+        close(_poll_fd);
     }
 }
 
-void Bluez::init() {
+void Bluez::init(bool lazy) {
     _conn->init();
+    if (_pool) {
+        _pool->init();
+    }
+    _lazy = lazy;
 
-    // Load all managed objects
-    SimpleDBus::Holder managed_objects = object_manager()->GetManagedObjects();
-    for (auto& [path, managed_interfaces] : managed_objects.get_dict_object_path()) {
-        path_add(path, managed_interfaces);
+    auto start = std::chrono::steady_clock::now();
+
+    // Load all managed objects. Paths come sorted, so adapters are always created before their devices.
+    size_t deferred = 0;
+    auto managed_objects = object_manager()->GetManagedObjects().get_dict_object_path();
+    for (auto& [path, managed_interfaces] : managed_objects) {
+        if (should_defer(path)) {
+            path_defer(path, std::move(managed_interfaces));
+            deferred++;
+        } else {
+            path_add(path, managed_interfaces);
+        }
     }
 
-    _conn->add_match("type='signal',sender='org.bluez'");
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    LOG_DEBUG("Loaded {} BlueZ objects ({} deferred) in {} us", managed_objects.size(), deferred, elapsed.count());
+
+    _matches = {OBJECT_MANAGER_MATCH, NAME_OWNER_CHANGED_MATCH};
+    for (auto& rule : _matches) {
+        _conn->match_rules().add(rule);
+    }
 
     // Create the agent that will handle pairing.
     _agent = std::make_shared<Agent>(_conn, "org.bluez", "/agent");
     path_append_child("/agent", std::static_pointer_cast<SimpleDBus::Proxy>(_agent));
 }
 
-void Bluez::run_async() {
-    _conn->read_write();
-    SimpleDBus::Message message = _conn->pop_message();
-    while (message.is_valid()) {
-        message_forward(message);
-        message = _conn->pop_message();
+void Bluez::run_async() { process_pending(); }
+
+int Bluez::poll_fd() {
+    if (!_pool) {
+        return _conn->poll_fd();
+    }
+
+    if (_poll_fd >= 0) {
+        return _poll_fd;
+    }
+
+    // An epoll descriptor is readable whenever one of the descriptors it watches is.
+    _poll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_poll_fd < 0) {
+        throw SimpleDBus::Exception::DBusException("org.freedesktop.DBus.Error.Failed", "Unable to set up polling");
+    }
+
+    for (size_t i = 0; i < connection_count(); i++) {
+        int fd = (i == 0 ? _conn : _pool->connection(i - 1))->poll_fd();
+
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(_poll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(_poll_fd);
+            _poll_fd = -1;
+            throw SimpleDBus::Exception::DBusException("org.freedesktop.DBus.Error.Failed",
+                                                       "Unable to set up polling");
+        }
+    }
+
+    return _poll_fd;
+}
+
+void Bluez::process_pending() {
+    for (size_t i = 0; i < connection_count(); i++) {
+        process_pending(i);
+    }
+}
+
+size_t Bluez::connection_count() const { return 1 + (_pool ? _pool->size() : 0); }
+
+void Bluez::process_pending(size_t connection) {
+    bool main_connection = connection == 0;
+    auto conn = main_connection ? _conn : _pool->connection(connection - 1);
+    auto dispatch = [this, main_connection](SimpleDBus::Message& message) { this->dispatch(message, main_connection); };
+
+    while (conn->drain(DRAIN_BATCH_SIZE, dispatch) == DRAIN_BATCH_SIZE) {
     }
 }
 
+void Bluez::dispatch(SimpleDBus::Message& message, bool main_connection) {
+    if (message.is_signal("org.freedesktop.DBus", "NameOwnerChanged")) {
+        name_owner_changed(message);
+        return;
+    }
+
+    // The object manager announces objects below an adapter on the connection of that adapter as well, which
+    // is the one that handles them so that they are processed in order with the rest of their traffic.
+    if (main_connection && _pool &&
+        (message.is_signal("org.freedesktop.DBus.ObjectManager", "InterfacesAdded") ||
+         message.is_signal("org.freedesktop.DBus.ObjectManager", "InterfacesRemoved")) &&
+        SimpleDBus::Path::count_elements(message.extract().get_string()) > ADAPTER_PATH_ELEMENTS) {
+        return;
+    }
+
+    // Applying messages sent after the new objects were fetched ahead of them would let stale state win.
+    if (main_connection) {
+        std::lock_guard<std::mutex> lock(_resync_mutex);
+        if (_resync_active) {
+            _resync_backlog.push_back(std::move(message));
+            return;
+        }
+    }
+
+    message_forward(message);
+}
+
+std::shared_ptr<SimpleDBus::Connection> Bluez::adapter_connection(const std::string& path) {
+    auto conn = _pool->acquire(path);
+
+    std::lock_guard<std::mutex> lock(_pool_mutex);
+    if (_pool_subscribed.insert(path).second) {
+        // Objects subscribe to their own property changes on the connection they were created with.
+        conn->match_rules().add(fmt::format("{},arg0path='{}/'", OBJECT_MANAGER_MATCH, path));
+    }
+    return conn;
+}
+
 std::vector<std::shared_ptr<Adapter>> Bluez::get_adapters() {
     return std::dynamic_pointer_cast<ProxyOrg>(path_get("/org"))->get_adapters();
 }
 
 std::shared_ptr<Agent> Bluez::get_agent() { return std::dynamic_pointer_cast<Agent>(path_get("/agent")); }
 
-void Bluez::register_agent() { std::dynamic_pointer_cast<ProxyOrg>(path_get("/org"))->register_agent(_agent); }
+void Bluez::register_agent() {
+    std::dynamic_pointer_cast<ProxyOrg>(path_get("/org"))->register_agent(_agent);
+    _agent_registered = true;
+}
+
+void Bluez::resync() {
+    auto start = std::chrono::steady_clock::now();
+
+    auto managed_objects = object_manager()->GetManagedObjects().get_dict_object_path();
+
+    // Only the BlueZ objects are reconciled, objects exported by this process such as the agent are left alone.
+    auto org = path_resolve("/org");
+    if (org) {
+        org->path_sync(managed_objects, [this](const std::string& path) { return should_defer(path); });
+    } else {
+        for (auto& [path, managed_interfaces] : managed_objects) {
+            path_add(path, managed_interfaces);
+        }
+    }
+
+    // Agent registrations do not survive a restart of bluetoothd.
+    if (_agent_registered) {
+        try {
+            register_agent();
+        } catch (const std::exception& e) {
+            LOG_WARN("Failed to register the agent again: {}", e.what());
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    LOG_INFO("Resynchronized {} BlueZ objects in {} us", managed_objects.size(), elapsed.count());
+}
+
+void Bluez::name_owner_changed(SimpleDBus::Message& message) {
+    std::string name = message.extract().get_string();
+    message.extract_next();
+    std::string old_owner = message.extract().get_string();
+    message.extract_next();
+    std::string new_owner = message.extract().get_string();
+
+    if (name != "org.bluez") {
+        return;
+    }
+
+    if (new_owner.empty()) {
+        // Objects are kept until BlueZ is back, at which point whatever is gone will be removed.
+        LOG_WARN("org.bluez left the bus (was {})", old_owner);
+        return;
+    }
+
+    LOG_INFO("org.bluez is now owned by {}, resynchronizing", new_owner);
+
+    // Signals still waiting for the previous resync are covered by the next one. Method calls still need a reply.
+    std::lock_guard<std::mutex> lock(_resync_mutex);
+    auto is_signal = [](SimpleDBus::Message& message) { return message.get_type() == SimpleDBus::Message::SIGNAL; };
+    _resync_backlog.erase(std::remove_if(_resync_backlog.begin(), _resync_backlog.end(), is_signal),
+                          _resync_backlog.end());
+    _resync_pending = true;
+    _resync_active = true;
+    if (!_resync_thread.joinable()) {
+        _resync_thread = std::thread(&Bluez::resync_run, this);
+    }
+    _resync_cv.notify_one();
+}
+
+void Bluez::resync_run() {
+    std::unique_lock<std::mutex> lock(_resync_mutex);
+    while (true) {
+        _resync_cv.wait(lock, [this]() { return _resync_pending || _resync_stopping; });
+        if (_resync_stopping) {
+            return;
+        }
+        _resync_pending = false;
+
+        lock.unlock();
+        try {
+            resync();
+        } catch (const std::exception& e) {
+            LOG_WARN("Failed to resynchronize with org.bluez: {}", e.what());
+        }
+        lock.lock();
+
+        // Catch up with what was received meanwhile, unless another owner change asks for a new resync.
+        while (!_resync_pending && !_resync_backlog.empty() && !_resync_stopping) {
+            std::deque<SimpleDBus::Message> backlog;
+            backlog.swap(_resync_backlog);
+
+            lock.unlock();
+            for (auto& message : backlog) {
+                try {
+                    message_forward(message);
+                } catch (const std::exception& e) {
+                    LOG_WARN("Failed to handle message after resynchronizing: {}", e.what());
+                }
+            }
+            lock.lock();
+        }
+
+        if (!_resync_pending) {
+            _resync_active = false;
+        }
+    }
+}
+
+bool Bluez::should_defer(const std::string& path) const {
+    return _lazy && SimpleDBus::Path::count_elements(path) > ADAPTER_PATH_ELEMENTS;
+}
 
 std::shared_ptr<SimpleDBus::Proxy> Bluez::path_create(const std::string& path) {
-    auto child = std::make_shared<ProxyOrg>(_conn, _bus_name, path);
+    ProxyOrg::ConnectionProvider adapter_connection;
+    if (_pool) {
+        adapter_connection = [this](const std::string& path) { return this->adapter_connection(path); };
+    }
+
+    auto child = std::make_shared<ProxyOrg>(_conn, _bus_name, path, adapter_connection);
     return std::static_pointer_cast<SimpleDBus::Proxy>(child);
 }
 
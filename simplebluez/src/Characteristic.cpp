@@ -2,13 +2,21 @@
 #include <simplebluez/Descriptor.h>
 #include <simplebluez/Exceptions.h>
 
+#include "Logging.h"
+
 using namespace SimpleBluez;
 
 Characteristic::Characteristic(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name,
                                const std::string& path)
-    : Proxy(conn, bus_name, path) {}
+    : Proxy(conn, bus_name, path), _notify_rule(SimpleDBus::MatchRules::properties_changed(bus_name, path, false)) {}
 
-Characteristic::~Characteristic() {}
+Characteristic::~Characteristic() {
+    try {
+        notify_unsubscribe();
+    } catch (const std::exception& e) {
+        LOG_WARN("Failed to unsubscribe from {}: {}", _path, e.what());
+    }
+}
 
 std::shared_ptr<SimpleDBus::Proxy> Characteristic::path_create(const std::string& path) {
     auto child = std::make_shared<Descriptor>(_conn, _bus_name, path);
@@ -30,12 +38,14 @@ std::shared_ptr<GattCharacteristic1> Characteristic::gattcharacteristic1() {
     return std::dynamic_pointer_cast<GattCharacteristic1>(interface_get("org.bluez.GattCharacteristic1"));
 }
 
-bool Characteristic::notifying() { return gattcharacteristic1()->Notifying(); }
+bool Characteristic::notifying(bool refresh) { return gattcharacteristic1()->Notifying(refresh); }
 
 std::string Characteristic::uuid() { return gattcharacteristic1()->UUID(); }
 
 ByteArray Characteristic::value() { return gattcharacteristic1()->Value(); }
 
+uint64_t Characteristic::value_timestamp() { return gattcharacteristic1()->ValueTimestamp(); }
+
 std::vector<std::string> Characteristic::flags() { return gattcharacteristic1()->Flags(); }
 
 uint16_t Characteristic::mtu() { return gattcharacteristic1()->MTU(); }
@@ -50,9 +60,80 @@ void Characteristic::write_command(ByteArray value) {
     gattcharacteristic1()->WriteValue(value, GattCharacteristic1::WriteType::COMMAND);
 }
 
-void Characteristic::start_notify() { gattcharacteristic1()->StartNotify(); }
+SimpleDBus::PendingCall Characteristic::read_start() { return gattcharacteristic1()->ReadValueStart(); }
+
+ByteArray Characteristic::read_finish(SimpleDBus::PendingCall& call) {
+    return gattcharacteristic1()->ReadValueFinish(call);
+}
+
+SimpleDBus::PendingCall Characteristic::write_request_start(ByteArray value) {
+    return gattcharacteristic1()->WriteValueStart(value, GattCharacteristic1::WriteType::REQUEST);
+}
+
+SimpleDBus::PendingCall Characteristic::write_command_start(ByteArray value) {
+    return gattcharacteristic1()->WriteValueStart(value, GattCharacteristic1::WriteType::COMMAND);
+}
+
+// The interface is captured by the callbacks, keeping it alive until the reply arrives.
+
+void Characteristic::read(std::function<void(ByteArray value, std::exception_ptr error)> callback) {
+    auto characteristic = gattcharacteristic1();
+    characteristic->ReadValue(
+        [characteristic, callback](ByteArray value, std::exception_ptr error) { callback(value, error); });
+}
+
+void Characteristic::write_request(ByteArray value, std::function<void(std::exception_ptr error)> callback) {
+    auto characteristic = gattcharacteristic1();
+    characteristic->WriteValue(value, GattCharacteristic1::WriteType::REQUEST,
+                               [characteristic, callback](std::exception_ptr error) { callback(error); });
+}
+
+void Characteristic::write_command(ByteArray value, std::function<void(std::exception_ptr error)> callback) {
+    auto characteristic = gattcharacteristic1();
+    characteristic->WriteValue(value, GattCharacteristic1::WriteType::COMMAND,
+                               [characteristic, callback](std::exception_ptr error) { callback(error); });
+}
+
+void Characteristic::start_notify(std::function<void(std::exception_ptr error)> callback) {
+    notify_subscribe();
+    auto characteristic = gattcharacteristic1();
+    characteristic->StartNotify([characteristic, callback](std::exception_ptr error) { callback(error); });
+}
 
-void Characteristic::stop_notify() { gattcharacteristic1()->StopNotify(); }
+void Characteristic::stop_notify(std::function<void(std::exception_ptr error)> callback) {
+    auto characteristic = gattcharacteristic1();
+    characteristic->StopNotify([characteristic, callback](std::exception_ptr error) { callback(error); });
+    notify_unsubscribe();
+}
+
+void Characteristic::start_notify() {
+    notify_subscribe();
+    gattcharacteristic1()->StartNotify();
+}
+
+void Characteristic::stop_notify() {
+    gattcharacteristic1()->StopNotify();
+    notify_unsubscribe();
+}
+
+void Characteristic::stop_notify_async() {
+    gattcharacteristic1()->StopNotifyNoReply();
+    notify_unsubscribe();
+}
+
+// Notifications arrive as changes of the Value property. The device subscribes to them as well once tracked, but
+// notifications can also be enabled on a device that was connected by another process.
+void Characteristic::notify_subscribe() {
+    if (!_notify_subscribed.exchange(true)) {
+        _conn->match_rules().add(_notify_rule);
+    }
+}
+
+void Characteristic::notify_unsubscribe() {
+    if (_notify_subscribed.exchange(false)) {
+        _conn->match_rules().remove(_notify_rule);
+    }
+}
 
 std::shared_ptr<Descriptor> Characteristic::get_descriptor(const std::string& uuid) {
     auto descriptors_all = descriptors();
@@ -70,4 +151,11 @@ void Characteristic::set_on_value_changed(std::function<void(ByteArray new_value
     gattcharacteristic1()->OnValueChanged.load([this, callback]() { callback(gattcharacteristic1()->Value()); });
 }
 
+void Characteristic::set_on_value_changed(std::function<void(ByteArray new_value, uint64_t timestamp)> callback) {
+    gattcharacteristic1()->OnValueChanged.load([this, callback]() {
+        auto characteristic = gattcharacteristic1();
+        callback(characteristic->Value(), characteristic->last_update_timestamp());
+    });
+}
+
 void Characteristic::clear_on_value_changed() { gattcharacteristic1()->OnValueChanged.unload(); }
@@ -2,12 +2,32 @@
 #include <simplebluez/Exceptions.h>
 #include <simplebluez/Service.h>
 
+#include "Logging.h"
+
 using namespace SimpleBluez;
 
 Device::Device(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path)
-    : Proxy(conn, bus_name, path) {}
+    : Proxy(conn, bus_name, path), _tracking_rule(SimpleDBus::MatchRules::properties_changed(bus_name, path, true)) {}
 
-Device::~Device() {}
+Device::~Device() {
+    try {
+        untrack();
+    } catch (const std::exception& e) {
+        LOG_WARN("Failed to unsubscribe from {}: {}", _path, e.what());
+    }
+}
+
+void Device::track() {
+    if (!_tracked.exchange(true)) {
+        _conn->match_rules().add(_tracking_rule);
+    }
+}
+
+void Device::untrack() {
+    if (_tracked.exchange(false)) {
+        _conn->match_rules().remove(_tracking_rule);
+    }
+}
 
 std::shared_ptr<SimpleDBus::Proxy> Device::path_create(const std::string& path) {
     auto child = std::make_shared<Service>(_conn, _bus_name, path);
@@ -53,14 +73,31 @@ std::shared_ptr<Characteristic> Device::get_characteristic(const std::string& se
     return service->get_characteristic(characteristic_uuid);
 }
 
-void Device::pair() { device1()->Pair(); }
+void Device::pair() {
+    track();
+    device1()->Pair();
+}
 
 void Device::cancel_pairing() { device1()->CancelPairing(); }
 
-void Device::connect() { device1()->Connect(); }
+void Device::connect() {
+    track();
+    device1()->Connect();
+}
+
+void Device::connect(std::function<void(std::exception_ptr error)> callback) {
+    track();
+    auto device1 = this->device1();
+    device1->Connect([device1, callback](std::exception_ptr error) { callback(error); });
+}
 
 void Device::disconnect() { device1()->Disconnect(); }
 
+void Device::disconnect(std::function<void(std::exception_ptr error)> callback) {
+    auto device1 = this->device1();
+    device1->Disconnect([device1, callback](std::exception_ptr error) { callback(error); });
+}
+
 std::string Device::address() { return device1()->Address(); }
 
 std::string Device::address_type() { return device1()->AddressType(); }
@@ -75,15 +112,19 @@ int16_t Device::tx_power() { return device1()->TxPower(); }
 
 std::vector<std::string> Device::uuids() { return device1()->UUIDs(); }
 
-std::map<uint16_t, std::vector<uint8_t>> Device::manufacturer_data() { return device1()->ManufacturerData(); }
+std::map<uint16_t, std::vector<uint8_t>> Device::manufacturer_data(bool refresh) {
+    return device1()->ManufacturerData(refresh);
+}
 
 std::map<std::string, std::vector<uint8_t>> Device::service_data() { return device1()->ServiceData(); }
 
-bool Device::paired() { return device1()->Paired(); }
+uint64_t Device::payload_fingerprint() { return device1()->PayloadFingerprint(); }
+
+bool Device::paired(bool refresh) { return device1()->Paired(refresh); }
 
-bool Device::connected() { return device1()->Connected(); }
+bool Device::connected(bool refresh) { return device1()->Connected(refresh); }
 
-bool Device::services_resolved() { return device1()->ServicesResolved(); }
+bool Device::services_resolved(bool refresh) { return device1()->ServicesResolved(refresh); }
 
 void Device::set_on_disconnected(std::function<void()> callback) { device1()->OnDisconnected.load(callback); }
 
@@ -3,8 +3,9 @@
 
 using namespace SimpleBluez;
 
-ProxyOrg::ProxyOrg(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path)
-    : Proxy(conn, bus_name, path) {}
+ProxyOrg::ProxyOrg(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name, const std::string& path,
+                   ConnectionProvider adapter_connection)
+    : Proxy(conn, bus_name, path), _adapter_connection(std::move(adapter_connection)) {}
 
 std::vector<std::shared_ptr<Adapter>> ProxyOrg::get_adapters() {
     return std::dynamic_pointer_cast<ProxyOrgBluez>(path_get("/org/bluez"))->get_adapters();
@@ -15,7 +16,7 @@ void ProxyOrg::register_agent(std::shared_ptr<Agent> agent) {
 }
 
 std::shared_ptr<SimpleDBus::Proxy> ProxyOrg::path_create(const std::string& path) {
-    auto child = std::make_shared<ProxyOrgBluez>(_conn, _bus_name, path);
+    auto child = std::make_shared<ProxyOrgBluez>(_conn, _bus_name, path, _adapter_connection);
     return std::static_pointer_cast<SimpleDBus::Proxy>(child);
 }
 
@@ -4,11 +4,13 @@
 using namespace SimpleBluez;
 
 ProxyOrgBluez::ProxyOrgBluez(std::shared_ptr<SimpleDBus::Connection> conn, const std::string& bus_name,
-                             const std::string& path)
-    : Proxy(conn, bus_name, path) {}
+                             const std::string& path, ProxyOrg::ConnectionProvider adapter_connection)
+    : Proxy(conn, bus_name, path), _adapter_connection(std::move(adapter_connection)) {}
 
 std::shared_ptr<SimpleDBus::Proxy> ProxyOrgBluez::path_create(const std::string& path) {
-    auto child = std::make_shared<Adapter>(_conn, _bus_name, path);
+    // Devices, services and the rest are created by the adapter with its own connection.
+    auto conn = _adapter_connection ? _adapter_connection(path) : _conn;
+    auto child = std::make_shared<Adapter>(conn, _bus_name, path);
     return std::static_pointer_cast<SimpleDBus::Proxy>(child);
 }
 
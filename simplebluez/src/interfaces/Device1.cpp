@@ -2,6 +2,26 @@
 
 using namespace SimpleBluez;
 
+// 64-bit FNV-1a, chained through `hash` so that several fields can be folded together.
+static uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t fnv1a(const std::string& value, uint64_t hash = 14695981039346656037ULL) {
+    // The length is folded in as well, so that concatenated fields cannot alias each other.
+    size_t size = value.size();
+    return fnv1a(value.data(), size, fnv1a(&size, sizeof(size), hash));
+}
+
+static uint64_t fnv1a(const std::vector<uint8_t>& value, uint64_t hash = 14695981039346656037ULL) {
+    size_t size = value.size();
+    return fnv1a(value.data(), size, fnv1a(&size, sizeof(size), hash));
+}
+
 Device1::Device1(std::shared_ptr<SimpleDBus::Connection> conn, std::string path)
     : SimpleDBus::Interface(conn, "org.bluez", path, "org.bluez.Device1") {}
 
@@ -15,11 +35,21 @@ void Device1::Connect() {
     _conn->send_with_reply_and_block(msg);
 }
 
+void Device1::Connect(std::function<void(std::exception_ptr error)> callback) {
+    auto msg = create_method_call("Connect");
+    _conn->send_with_reply(msg, [callback](SimpleDBus::Message&, std::exception_ptr error) { callback(error); });
+}
+
 void Device1::Disconnect() {
     auto msg = create_method_call("Disconnect");
     _conn->send_with_reply_and_block(msg);
 }
 
+void Device1::Disconnect(std::function<void(std::exception_ptr error)> callback) {
+    auto msg = create_method_call("Disconnect");
+    _conn->send_with_reply(msg, [callback](SimpleDBus::Message&, std::exception_ptr error) { callback(error); });
+}
+
 void Device1::Pair() {
     auto msg = create_method_call("Pair");
     _conn->send_with_reply_and_block(msg);
@@ -120,6 +150,16 @@ bool Device1::ServicesResolved(bool refresh) {
     return _properties["ServicesResolved"].get_boolean();
 }
 
+uint64_t Device1::PayloadFingerprint() const { return _payload_fingerprint; }
+
+void Device1::update_payload_fingerprint() {
+    uint64_t fingerprint = fnv1a(&_name_hash, sizeof(_name_hash));
+    fingerprint = fnv1a(&_uuids_hash, sizeof(_uuids_hash), fingerprint);
+    fingerprint = fnv1a(&_manufacturer_data_hash, sizeof(_manufacturer_data_hash), fingerprint);
+    fingerprint = fnv1a(&_service_data_hash, sizeof(_service_data_hash), fingerprint);
+    _payload_fingerprint = fingerprint;
+}
+
 void Device1::property_changed(std::string option_name) {
     if (option_name == "Connected") {
         if (!Connected(false)) {
@@ -142,6 +182,12 @@ void Device1::property_changed(std::string option_name) {
             }
             _manufacturer_data[key] = raw_manuf_data;
         }
+
+        _manufacturer_data_hash = fnv1a(nullptr, 0);
+        for (auto& [key, value] : _manufacturer_data) {
+            _manufacturer_data_hash = fnv1a(value, fnv1a(&key, sizeof(key), _manufacturer_data_hash));
+        }
+        update_payload_fingerprint();
     } else if (option_name == "ServiceData") {
         std::scoped_lock lock(_property_update_mutex);
 
@@ -155,6 +201,25 @@ void Device1::property_changed(std::string option_name) {
             }
             _service_data[key] = raw_service_data;
         }
+
+        _service_data_hash = fnv1a(nullptr, 0);
+        for (auto& [key, value] : _service_data) {
+            _service_data_hash = fnv1a(value, fnv1a(key, _service_data_hash));
+        }
+        update_payload_fingerprint();
+    } else if (option_name == "Name") {
+        std::scoped_lock lock(_property_update_mutex);
+
+        _name_hash = fnv1a(_properties["Name"].get_string());
+        update_payload_fingerprint();
+    } else if (option_name == "UUIDs") {
+        std::scoped_lock lock(_property_update_mutex);
+
+        _uuids_hash = fnv1a(nullptr, 0);
+        for (SimpleDBus::Holder& uuid : _properties["UUIDs"].get_array()) {
+            _uuids_hash = fnv1a(uuid.get_string(), _uuids_hash);
+        }
+        update_payload_fingerprint();
     } else if (option_name == "TxPower") {
         _tx_power = _properties["TxPower"].get_int16();
     }
@@ -1,5 +1,7 @@
 #include "simplebluez/interfaces/GattCharacteristic1.h"
 
+#include <chrono>
+
 using namespace SimpleBluez;
 
 GattCharacteristic1::GattCharacteristic1(std::shared_ptr<SimpleDBus::Connection> conn, std::string path)
@@ -17,7 +19,74 @@ void GattCharacteristic1::StopNotify() {
     _conn->send_with_reply_and_block(msg);
 }
 
+void GattCharacteristic1::StopNotifyNoReply() {
+    auto msg = create_method_call("StopNotify");
+    msg.set_no_reply(true);
+    _conn->send(msg);
+}
+
 void GattCharacteristic1::WriteValue(const ByteArray& value, WriteType type) {
+    auto msg = create_write_value_call(value, type);
+    _conn->send_with_reply_and_block(msg);
+}
+
+ByteArray GattCharacteristic1::ReadValue() {
+    auto msg = create_read_value_call();
+    SimpleDBus::Message reply_msg = _conn->send_with_reply_and_block(msg);
+    return read_value_reply(reply_msg);
+}
+
+SimpleDBus::PendingCall GattCharacteristic1::WriteValueStart(const ByteArray& value, WriteType type) {
+    auto msg = create_write_value_call(value, type);
+    return _conn->send_with_reply(msg);
+}
+
+SimpleDBus::PendingCall GattCharacteristic1::ReadValueStart() {
+    auto msg = create_read_value_call();
+    return _conn->send_with_reply(msg);
+}
+
+ByteArray GattCharacteristic1::ReadValueFinish(SimpleDBus::PendingCall& call) {
+    SimpleDBus::Message reply_msg = call.wait();
+    return read_value_reply(reply_msg);
+}
+
+void GattCharacteristic1::StartNotify(std::function<void(std::exception_ptr error)> callback) {
+    auto msg = create_method_call("StartNotify");
+    _conn->send_with_reply(msg, [callback](SimpleDBus::Message&, std::exception_ptr error) { callback(error); });
+}
+
+void GattCharacteristic1::StopNotify(std::function<void(std::exception_ptr error)> callback) {
+    auto msg = create_method_call("StopNotify");
+    _conn->send_with_reply(msg, [callback](SimpleDBus::Message&, std::exception_ptr error) { callback(error); });
+}
+
+void GattCharacteristic1::WriteValue(const ByteArray& value, WriteType type,
+                                     std::function<void(std::exception_ptr error)> callback) {
+    auto msg = create_write_value_call(value, type);
+    _conn->send_with_reply(msg, [callback](SimpleDBus::Message&, std::exception_ptr error) { callback(error); });
+}
+
+void GattCharacteristic1::ReadValue(std::function<void(ByteArray value, std::exception_ptr error)> callback) {
+    auto msg = create_read_value_call();
+    _conn->send_with_reply(msg, [this, callback](SimpleDBus::Message& reply, std::exception_ptr error) {
+        if (error) {
+            callback(ByteArray(), error);
+            return;
+        }
+
+        ByteArray value;
+        try {
+            value = read_value_reply(reply);
+        } catch (...) {
+            callback(ByteArray(), std::current_exception());
+            return;
+        }
+        callback(value, nullptr);
+    });
+}
+
+SimpleDBus::Message GattCharacteristic1::create_write_value_call(const ByteArray& value, WriteType type) {
     SimpleDBus::Holder value_data = SimpleDBus::Holder::create_array();
     for (size_t i = 0; i < value.size(); i++) {
         value_data.array_append(SimpleDBus::Holder::create_byte(value[i]));
@@ -33,19 +102,26 @@ void GattCharacteristic1::WriteValue(const ByteArray& value, WriteType type) {
     auto msg = create_method_call("WriteValue");
     msg.append_argument(value_data, "ay");
     msg.append_argument(options, "a{sv}");
-    _conn->send_with_reply_and_block(msg);
+    return msg;
 }
 
-ByteArray GattCharacteristic1::ReadValue() {
+SimpleDBus::Message GattCharacteristic1::create_read_value_call() {
     auto msg = create_method_call("ReadValue");
 
     // NOTE: ReadValue requires an additional argument, which currently is not supported
     SimpleDBus::Holder options = SimpleDBus::Holder::create_dict();
     msg.append_argument(options, "a{sv}");
+    return msg;
+}
 
-    SimpleDBus::Message reply_msg = _conn->send_with_reply_and_block(msg);
+ByteArray GattCharacteristic1::read_value_reply(SimpleDBus::Message& reply_msg) {
     SimpleDBus::Holder value = reply_msg.extract();
-    update_value(value);
+
+    // Replies are not stamped on reception, so the value is considered fresh as of now.
+    uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+    update_value(value, timestamp);
 
     return Value();
 }
@@ -61,6 +137,11 @@ ByteArray GattCharacteristic1::Value() {
     return _value;
 }
 
+uint64_t GattCharacteristic1::ValueTimestamp() {
+    std::scoped_lock lock(_property_update_mutex);
+    return _value_timestamp;
+}
+
 std::vector<std::string> GattCharacteristic1::Flags() {
     std::scoped_lock lock(_property_update_mutex);
 
@@ -91,13 +172,14 @@ void GattCharacteristic1::property_changed(std::string option_name) {
         std::scoped_lock lock(_property_update_mutex);
         _uuid = _properties["UUID"].get_string();
     } else if (option_name == "Value") {
-        update_value(_properties["Value"]);
+        update_value(_properties["Value"], last_update_timestamp());
         OnValueChanged();
     }
 }
 
-void GattCharacteristic1::update_value(SimpleDBus::Holder& new_value) {
+void GattCharacteristic1::update_value(SimpleDBus::Holder& new_value, uint64_t timestamp) {
     std::scoped_lock lock(_property_update_mutex);
+    _value_timestamp = timestamp;
     auto value_array = new_value.get_array();
 
     char* value_data = new char[value_array.size()];
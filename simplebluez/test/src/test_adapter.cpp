@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include <simpledbus/base/Connection.h>
+#include <simplebluez/Adapter.h>
+
+using namespace SimpleBluez;
+using SimpleDBus::Holder;
+
+static Holder device_interfaces(std::string address, bool connected, bool paired) {
+    Holder properties = Holder::create_dict();
+    properties.dict_append(Holder::STRING, std::string("Address"), Holder::create_string(address));
+    properties.dict_append(Holder::STRING, std::string("Connected"), Holder::create_boolean(connected));
+    properties.dict_append(Holder::STRING, std::string("Paired"), Holder::create_boolean(paired));
+
+    Holder interfaces = Holder::create_dict();
+    interfaces.dict_append(Holder::STRING, std::string("org.bluez.Device1"), properties);
+    return interfaces;
+}
+
+TEST(Adapter, DeviceInfoListKeepsDevicesDeferred) {
+    auto conn = std::make_shared<SimpleDBus::Connection>(DBUS_BUS_SESSION);
+    Adapter adapter(conn, "org.bluez", "/org/bluez/hci0");
+
+    adapter.path_defer("/org/bluez/hci0/dev_11_22_33_44_55_66", device_interfaces("11:22:33:44:55:66", false, true));
+    adapter.path_defer("/org/bluez/hci0/dev_AA_BB_CC_DD_EE_FF", device_interfaces("AA:BB:CC:DD:EE:FF", true, false));
+
+    auto devices = adapter.device_info_list();
+    ASSERT_EQ(devices.size(), 2u);
+    EXPECT_EQ(devices[0].path, "/org/bluez/hci0/dev_11_22_33_44_55_66");
+    EXPECT_EQ(devices[0].address, "11:22:33:44:55:66");
+    EXPECT_TRUE(devices[0].paired);
+    EXPECT_FALSE(devices[0].connected);
+    EXPECT_EQ(devices[1].address, "AA:BB:CC:DD:EE:FF");
+    EXPECT_TRUE(devices[1].connected);
+    EXPECT_EQ(devices[1].last_update_timestamp, 0u);
+
+    EXPECT_EQ(adapter.path_deferred_count(), 2u);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <simplebluez/interfaces/Device1.h>
+
+using namespace SimpleBluez;
+using SimpleDBus::Holder;
+
+static Holder manufacturer_data(uint16_t company_id, std::vector<uint8_t> payload) {
+    Holder bytes = Holder::create_array();
+    for (uint8_t byte : payload) {
+        bytes.array_append(Holder::create_byte(byte));
+    }
+    Holder data = Holder::create_dict();
+    data.dict_append(Holder::UINT16, company_id, bytes);
+    return data;
+}
+
+static Holder properties(std::string key, Holder value) {
+    Holder dict = Holder::create_dict();
+    dict.dict_append(Holder::STRING, key, value);
+    return dict;
+}
+
+TEST(Device1, PayloadFingerprint) {
+    Device1 device1(nullptr, "/org/bluez/hci0/dev_11_22_33_44_55_66");
+
+    Holder initial = Holder::create_dict();
+    initial.dict_append(Holder::STRING, std::string("Name"), Holder::create_string("Sensor"));
+    initial.dict_append(Holder::STRING, std::string("RSSI"), Holder::create_int16(-60));
+    initial.dict_append(Holder::STRING, std::string("ManufacturerData"), manufacturer_data(0x004C, {1, 2, 3}));
+    device1.load(initial);
+    uint64_t fingerprint = device1.PayloadFingerprint();
+
+    // RSSI is not part of the payload.
+    device1.signal_property_changed(properties("RSSI", Holder::create_int16(-40)), Holder::create_array());
+    EXPECT_EQ(fingerprint, device1.PayloadFingerprint());
+
+    // Neither is re-advertising the same bytes.
+    device1.signal_property_changed(properties("ManufacturerData", manufacturer_data(0x004C, {1, 2, 3})),
+                                    Holder::create_array());
+    EXPECT_EQ(fingerprint, device1.PayloadFingerprint());
+
+    device1.signal_property_changed(properties("ManufacturerData", manufacturer_data(0x004C, {1, 2, 4})),
+                                    Holder::create_array());
+    EXPECT_NE(fingerprint, device1.PayloadFingerprint());
+    fingerprint = device1.PayloadFingerprint();
+
+    device1.signal_property_changed(properties("Name", Holder::create_string("Sensor 2")), Holder::create_array());
+    EXPECT_NE(fingerprint, device1.PayloadFingerprint());
+}
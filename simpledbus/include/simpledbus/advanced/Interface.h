@@ -18,7 +18,12 @@ class Interface {
     virtual ~Interface() = default;
 
     // ----- LIFE CYCLE -----
-    void load(Holder options);
+    void load(Holder options, uint64_t timestamp = 0);
+
+    /**
+     * @brief Replaces all properties with `options`, only notifying those whose value actually changed.
+     */
+    void sync(Holder options);
     void unload();
     bool is_loaded() const;
 
@@ -34,13 +39,22 @@ class Interface {
     void property_refresh(const std::string& property_name);
 
     // ----- SIGNALS -----
-    void signal_property_changed(Holder changed_properties, Holder invalidated_properties);
+    void signal_property_changed(Holder changed_properties, Holder invalidated_properties, uint64_t timestamp = 0);
+
+    /**
+     * @brief Receive timestamp of the message that last updated the properties of this interface.
+     *
+     * @note Same time base as Message::get_receive_timestamp(). Zero if unknown. Updates made without a
+     *       timestamp leave it unchanged.
+     */
+    uint64_t last_update_timestamp() const;
 
     // ----- MESSAGES -----
     virtual void message_handle(Message& msg);
 
   protected:
     std::atomic_bool _loaded{true};
+    std::atomic_uint64_t _last_update_timestamp{0};
 
     std::string _path;
     std::string _bus_name;
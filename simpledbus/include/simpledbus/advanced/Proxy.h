@@ -3,9 +3,13 @@
 #include <simpledbus/advanced/Interface.h>
 #include <simpledbus/external/kvn_safe_callback.hpp>
 
+#include <atomic>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace SimpleDBus {
 
@@ -35,28 +39,76 @@ class Proxy {
     // ----- INTERFACE HANDLING -----
     size_t interfaces_count();
     bool interfaces_loaded();
-    void interfaces_load(Holder managed_interfaces);
+    void interfaces_load(Holder managed_interfaces, uint64_t timestamp = 0);
     void interfaces_reload(Holder managed_interfaces);
     void interfaces_unload(Holder removed_interfaces);
 
+    /**
+     * @brief Loads `managed_interfaces`, only notifying properties whose value changed. Interfaces missing from
+     *        `managed_interfaces` are left untouched.
+     */
+    void interfaces_sync(Holder managed_interfaces);
+
     // ----- CHILD HANDLING -----
-    void path_add(const std::string& path, Holder managed_interfaces);
+    void path_add(const std::string& path, Holder managed_interfaces, uint64_t timestamp = 0);
     bool path_remove(const std::string& path, Holder removed_interfaces);
     bool path_prune();
     void path_append_child(const std::string& path, std::shared_ptr<Proxy> child);
 
+    /**
+     * @brief Records a descendant without creating any proxy for it. The direct child leading to it is only
+     *        built, along with every deferred object below it, once it is accessed or addressed by a message.
+     *
+     * @note Materializing a deferred child does not invoke `on_child_created`, as for objects loaded up front.
+     */
+    void path_defer(const std::string& path, Holder managed_interfaces);
+    size_t path_deferred_count();
+
+    /**
+     * @brief Returns the proxy at `path` if it has been created, without materializing deferred objects.
+     */
+    std::shared_ptr<Proxy> path_resolve(const std::string& path);
+
+    /**
+     * @brief Collects the loaded interfaces of every descendant, including deferred ones.
+     */
+    void path_collect_interfaces(std::map<std::string, std::vector<std::string>>& loaded_interfaces);
+
+    /**
+     * @brief Reconciles the descendants of this proxy with a complete set of managed objects, such as a fresh
+     *        GetManagedObjects reply, touching only what changed.
+     *
+     * @details Objects or interfaces that are gone are removed as if InterfacesRemoved had been received, new
+     *          objects are added, and existing ones keep their proxies, callbacks and references while only
+     *          changed properties are notified.
+     *
+     * @param defer New objects for which this returns true are deferred rather than created.
+     */
+    void path_sync(const std::map<std::string, Holder>& managed_objects,
+                   std::function<bool(const std::string& path)> defer = nullptr);
+
     // ----- MESSAGE HANDLING -----
     void message_forward(Message& msg);
 
+    /**
+     * @brief Receive timestamp of the last message that loaded or was addressed to this proxy.
+     *
+     * @note Same time base as Message::get_receive_timestamp(). Zero if unknown.
+     */
+    uint64_t last_update_timestamp() const;
+
     // ----- CALLBACKS -----
     kvn::safe_callback<void(std::string)> on_child_created;
     kvn::safe_callback<void(std::string)> on_child_signal_received;
+    // Invoked when a direct child has lost all of its interfaces, right before it is released.
+    kvn::safe_callback<void(std::string)> on_child_removed;
 
     // ----- TEMPLATE METHODS -----
     template <typename T>
     std::vector<std::shared_ptr<T>> children_casted() {
         std::vector<std::shared_ptr<T>> result;
         std::scoped_lock lock(_child_access_mutex);
+        path_materialize_all();
         for (auto& [path, child] : _children) {
             result.push_back(std::dynamic_pointer_cast<T>(child));
         }
@@ -64,7 +116,13 @@ class Proxy {
     }
 
   protected:
+    // Must be called with the child access mutex held.
+    void path_materialize(const std::string& child_path);
+    void path_materialize_all();
+    void path_materialize_if(std::function<bool(const Holder& managed_interfaces)> predicate);
+
     bool _valid;
+    std::atomic_uint64_t _last_update_timestamp{0};
     std::string _path;
     std::string _bus_name;
 
@@ -72,6 +130,8 @@ class Proxy {
 
     std::map<std::string, std::shared_ptr<Interface>> _interfaces;
     std::map<std::string, std::shared_ptr<Proxy>> _children;
+    // Direct children yet to be created, along with the managed interfaces of every object at or below them.
+    std::map<std::string, std::map<std::string, Holder>> _deferred;
 
     std::recursive_mutex _interface_access_mutex;
     std::recursive_mutex _child_access_mutex;
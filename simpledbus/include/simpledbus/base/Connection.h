@@ -1,41 +1,167 @@
 #pragma once
 
 #include <dbus/dbus.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
+#include "MatchRules.h"
 #include "Message.h"
 
 namespace SimpleDBus {
 
 class Message;
+class PendingCall;
+struct PendingReply;
 
 class Connection {
   public:
-    Connection(::DBusBusType dbus_bus_type);
+    /**
+     * @param private_connection If set, a connection of its own is opened instead of the one libdbus shares
+     *                           within the process, so that its traffic is isolated from every other user.
+     */
+    Connection(::DBusBusType dbus_bus_type, bool private_connection = false);
     ~Connection();
 
     void init();
     void uninit();
     bool is_initialized();
+    bool is_private() const;
 
     void add_match(std::string rule);
     void remove_match(std::string rule);
 
+    /**
+     * @brief Reference-counted match rules, for users that subscribe and unsubscribe independently. Rules still
+     *        in place are removed by uninit().
+     */
+    MatchRules& match_rules();
+
     void read_write();
     Message pop_message();
 
+    /**
+     * @brief Reads any pending data and hands up to `max` queued messages to `callback`, returning how many
+     *        were dispatched.
+     *
+     * @details The messages are collected under a single acquisition of the connection lock into a buffer that
+     *          is reused across calls, and dispatched once the lock is released. A return value below `max`
+     *          means that nothing was left. If the callback throws, the messages not yet dispatched are kept for
+     *          the next call and the exception is propagated.
+     *
+     * @note Must not be called from within the callback.
+     */
+    size_t drain(size_t max, std::function<void(Message& message)> const& callback);
+
+    /**
+     * @brief Returns a descriptor that becomes readable whenever the connection has something to process, so
+     *        that it can be driven from an external event loop.
+     *
+     * @details Besides incoming data, it wakes up for messages that another call already read into memory and
+     *          for reply timeouts. Once it is readable, read_write() and pop_message() are to be called until no
+     *          message is left. The descriptor is owned by the connection and remains valid until uninit().
+     */
+    int poll_fd();
+
     void send(Message& msg);
     Message send_with_reply_and_block(Message& msg);
 
+    /**
+     * @brief Sends a method call and returns right away, the reply being collected from the returned call.
+     */
+    PendingCall send_with_reply(Message& msg);
+
+    /**
+     * @brief Sends a method call and returns right away, `callback` receiving the reply once it arrives.
+     *
+     * @details The callback runs on the thread that reads the reply, usually the one calling pop_message(), and
+     *          must not block. If the call fails, it receives an invalid message along with the error.
+     */
+    void send_with_reply(Message& msg, std::function<void(Message& reply, std::exception_ptr error)> callback);
+
     // ----- PROPERTIES -----
     std::string unique_name();
 
   private:
-    bool _initialized = false;
+    std::atomic_bool _initialized = false;
 
     ::DBusBusType _dbus_bus_type;
+    bool _private;
     ::DBusConnection* _conn;
 
-    std::recursive_mutex _mutex;
+    MatchRules _match_rules{*this};
+
+    // libdbus serializes access to the connection itself, so sending takes no lock of ours. The locks below only
+    // guard the state layered on top of it and are never held across a blocking call. When both are needed,
+    // _receive_mutex is taken first.
+
+    // Guards taking messages off the incoming queue, along with the state of the receiving side.
+    std::recursive_mutex _receive_mutex;
+    uint64_t _received_sequence = 0;
+
+    // Serializes drain(), which owns the buffer while dispatching.
+    std::mutex _drain_mutex;
+    std::vector<Message> _drain_buffer;
+
+    // Set up by poll_fd(). The epoll descriptor watches the socket, an eventfd used to report messages already
+    // read into memory, and a timerfd armed at the earliest reply deadline. The eventfd is read by the dispatch
+    // status callback, which libdbus may run on any thread.
+    int _poll_fd = -1;
+    std::atomic_int _wake_fd{-1};
+    int _timer_fd = -1;
+
+    // Replies are matched to their calls as messages are popped, by whichever thread pops them. Guarded by
+    // _reply_mutex, which is held while a call is sent so that its reply cannot be popped before it is known.
+    std::mutex _reply_mutex;
+    std::map<uint32_t, std::shared_ptr<PendingReply>> _pending_replies;
+    uint64_t _next_reply_deadline = UINT64_MAX;
+    std::condition_variable _reply_cv;
+    // Set while a thread waiting for its reply blocks on the socket. Any other waiting thread waits on _reply_cv
+    // until its reply comes in or the socket is free.
+    bool _reply_reader = false;
+    // Wakes up the thread blocked on the socket when a reply completes or messages are read into memory by
+    // another thread. Valid from init() to uninit().
+    int _reply_wake_fd = -1;
+
+    // Messages read while waiting for a reply, handed out by pop_message() before any newer one. Guarded by
+    // _receive_mutex.
+    std::deque<Message> _deferred;
+
+    friend class PendingCall;
+    bool reply_completed(PendingReply const& reply);
+    void wait_for_reply(PendingReply& reply);
+
+    std::shared_ptr<PendingReply> _send_with_reply(
+        Message& msg, std::function<void(Message& reply, std::exception_ptr error)> callback = nullptr);
+    void _call_bus(std::string const& method, std::string const& rule);
+
+    // The following must be called with both mutexes held. Completed calls with a callback are appended to
+    // `completed`, to be run once the mutexes are released.
+    Message _pop_unclaimed(std::vector<std::shared_ptr<PendingReply>>& completed);
+    bool _claim_reply(Message& message, std::vector<std::shared_ptr<PendingReply>>& completed);
+    void _expire_replies(std::vector<std::shared_ptr<PendingReply>>& completed);
+
+    // Must be called with _reply_mutex held.
+    void _complete_reply(std::shared_ptr<PendingReply> const& reply,
+                         std::vector<std::shared_ptr<PendingReply>>& completed);
+    void _arm_reply_timer();
+
+    static void _run_callbacks(std::vector<std::shared_ptr<PendingReply>>& completed);
+
+    // Must be called with _receive_mutex held.
+    void _clear_poller();
+    void _close_poller();
+
+    void _wake_poller();
+    void _wake_reply_reader();
+    static void _dispatch_status_changed(::DBusConnection* conn, ::DBusDispatchStatus status, void* data);
 };
 
 }  // namespace SimpleDBus
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <dbus/dbus.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Connection.h"
+
+namespace SimpleDBus {
+
+/**
+ * @brief Fixed set of private connections to the same bus, over which independent users are spread.
+ *
+ * @details Each key, such as the path of an object, sticks to the connection it was first assigned, so that
+ *          its traffic always flows through the same connection and can be dispatched from a thread of its own.
+ *          New keys go to the connection with the fewest keys assigned.
+ */
+class ConnectionPool {
+  public:
+    ConnectionPool(::DBusBusType dbus_bus_type, size_t size);
+    ~ConnectionPool();
+
+    /**
+     * @brief Opens every connection of the pool.
+     */
+    void init();
+    void uninit();
+    bool is_initialized();
+
+    size_t size() const;
+    std::shared_ptr<Connection> connection(size_t index) const;
+    const std::vector<std::shared_ptr<Connection>>& connections() const;
+
+    /**
+     * @brief Returns the connection assigned to `key`, assigning one if needed.
+     */
+    std::shared_ptr<Connection> acquire(const std::string& key);
+
+    /**
+     * @brief Forgets the assignment of `key`, so that it no longer weighs on its connection.
+     */
+    void release(const std::string& key);
+
+  private:
+    std::vector<std::shared_ptr<Connection>> _connections;
+
+    std::mutex _mutex;
+    std::map<std::string, size_t> _assignments;
+    std::vector<size_t> _load;
+};
+
+}  // namespace SimpleDBus
@@ -15,6 +15,11 @@ class Holder {
     Holder();
     ~Holder();
 
+    Holder(const Holder& other) = default;
+    Holder(Holder&& other) noexcept = default;
+    Holder& operator=(const Holder& other) = default;
+    Holder& operator=(Holder&& other) noexcept = default;
+
     bool operator!=(const Holder& rhs) const;
     bool operator==(const Holder& rhs) const;
 
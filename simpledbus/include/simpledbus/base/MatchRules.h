@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace SimpleDBus {
+
+class Connection;
+
+/**
+ * @brief Reference-counted match rules of a connection, so that independent users can subscribe to overlapping
+ *        sets of signals.
+ *
+ * @details A rule is only added to the bus when first requested and removed once every user has dropped it. No
+ *          lock is held during the round trips to the bus, so users of other rules are never held up.
+ */
+class MatchRules {
+  public:
+    explicit MatchRules(Connection& conn);
+    ~MatchRules() = default;
+
+    MatchRules(const MatchRules& other) = delete;
+    MatchRules& operator=(const MatchRules& other) = delete;
+
+    void add(const std::string& rule);
+    void remove(const std::string& rule);
+
+    /**
+     * @brief Number of users of `rule`.
+     */
+    size_t count(const std::string& rule);
+
+    /**
+     * @brief Number of distinct rules currently added to the bus.
+     */
+    size_t size();
+
+    /**
+     * @brief Removes every rule from the bus, regardless of how many users it has.
+     */
+    void clear();
+
+    /**
+     * @brief Rule for the PropertiesChanged signals of the object at `path`, or of every object in the subtree
+     *        rooted at it if `subtree` is set. A non-empty `interface` narrows it down to changes of that interface.
+     */
+    static std::string properties_changed(const std::string& sender, const std::string& path, bool subtree,
+                                          const std::string& interface = "");
+
+  private:
+    Connection& _conn;
+
+    struct Rule {
+        size_t users = 0;
+        // Set while the first user is adding the rule to the bus. Other users wait for it on _cv.
+        bool pending = false;
+        // Tells the entry apart from one created for the same rule after a clear().
+        uint64_t id = 0;
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::map<std::string, Rule> _rules;
+    uint64_t _next_id = 0;
+};
+
+}  // namespace SimpleDBus
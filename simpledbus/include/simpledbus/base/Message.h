@@ -43,6 +43,17 @@ class Message {
     std::string to_string(bool append_arguments = false) const;
 
     int32_t get_unique_id();
+
+    /**
+     * @brief Monotonic time, in nanoseconds on std::chrono::steady_clock, at which the
+     *        message was popped from the connection. Zero for locally created messages.
+     */
+    uint64_t get_receive_timestamp() const;
+
+    /**
+     * @brief Per-connection sequence number assigned on reception. Zero for locally created messages.
+     */
+    uint64_t get_sequence() const;
     uint32_t get_serial();
     std::string get_signature();
     std::string get_interface();
@@ -52,6 +63,12 @@ class Message {
 
     bool is_signal(std::string interface, std::string signal_name);
 
+    /**
+     * @brief Tells the receiver of a method call that no reply is expected, so that none is sent.
+     */
+    void set_no_reply(bool no_reply);
+    bool get_no_reply() const;
+
     static Message create_method_call(std::string bus_name, std::string path, std::string interface,
                                       std::string method);
 
@@ -66,6 +83,8 @@ class Message {
     int indent;
 
     int _unique_id;
+    uint64_t _receive_timestamp = 0;
+    uint64_t _sequence = 0;
     DBusMessageIter _iter;
     bool _iter_initialized;
     bool _is_extracted;
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "Message.h"
+
+namespace SimpleDBus {
+
+class Connection;
+
+/**
+ * @brief State of a method call awaiting its reply. Only accessed with the reply lock of the connection held.
+ */
+struct PendingReply {
+    using Callback = std::function<void(Message& reply, std::exception_ptr error)>;
+
+    std::string description;
+    // Time after which the call fails, in nanoseconds on std::chrono::steady_clock.
+    uint64_t deadline = 0;
+    bool completed = false;
+    Message reply;
+    std::exception_ptr error;
+    Callback callback;
+};
+
+/**
+ * @brief Reply to a method call that was sent without waiting for it.
+ *
+ * @details Several calls can be in flight at once, their replies being collected in any order afterwards.
+ */
+class PendingCall {
+  public:
+    PendingCall();
+    PendingCall(Connection* conn, std::shared_ptr<PendingReply> reply);
+    ~PendingCall() = default;
+
+    PendingCall(PendingCall&& other) = default;
+    PendingCall& operator=(PendingCall&& other) = default;
+    PendingCall(const PendingCall& other) = delete;
+    PendingCall& operator=(const PendingCall& other) = delete;
+
+    bool is_valid() const;
+    bool is_completed() const;
+
+    /**
+     * @brief Waits for the reply, throwing Exception::SendFailed if it is an error.
+     *
+     * @note The connection lock is not held while waiting, so other threads can keep using it.
+     */
+    Message wait();
+
+  private:
+    Connection* _conn = nullptr;
+    std::shared_ptr<PendingReply> _reply;
+};
+
+}  // namespace SimpleDBus
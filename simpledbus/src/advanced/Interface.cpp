@@ -1,6 +1,8 @@
 #include <simpledbus/advanced/Interface.h>
 #include <simpledbus/base/Exceptions.h>
 
+#include <vector>
+
 using namespace SimpleDBus;
 
 Interface::Interface(std::shared_ptr<Connection> conn, const std::string& bus_name, const std::string& path,
@@ -9,7 +11,12 @@ Interface::Interface(std::shared_ptr<Connection> conn, const std::string& bus_na
 
 // ----- LIFE CYCLE -----
 
-void Interface::load(Holder options) {
+void Interface::load(Holder options, uint64_t timestamp) {
+    // Updates that do not come from a received message keep the time of the last one that did.
+    if (timestamp != 0) {
+        _last_update_timestamp = timestamp;
+    }
+
     _property_update_mutex.lock();
     auto changed_options = options.get_dict_string();
     for (auto& [name, value] : changed_options) {
@@ -26,6 +33,36 @@ void Interface::load(Holder options) {
     _loaded = true;
 }
 
+void Interface::sync(Holder options) {
+    std::vector<std::string> changed;
+
+    _property_update_mutex.lock();
+    auto new_options = options.get_dict_string();
+    for (auto& [name, value] : new_options) {
+        auto current = _properties.find(name);
+        if (current == _properties.end() || !_property_valid_map[name] || current->second != value) {
+            _properties[name] = value;
+            _property_valid_map[name] = true;
+            changed.push_back(name);
+        }
+    }
+
+    // Properties no longer reported are invalidated, as with a PropertiesChanged signal.
+    for (auto& [name, valid] : _property_valid_map) {
+        if (valid && new_options.find(name) == new_options.end()) {
+            valid = false;
+            changed.push_back(name);
+        }
+    }
+    _property_update_mutex.unlock();
+
+    for (auto& name : changed) {
+        property_changed(name);
+    }
+
+    _loaded = true;
+}
+
 void Interface::unload() { _loaded = false; }
 
 bool Interface::is_loaded() const { return _loaded; }
@@ -109,7 +146,12 @@ void Interface::property_changed(std::string option_name) {}
 
 // ----- SIGNALS -----
 
-void Interface::signal_property_changed(Holder changed_properties, Holder invalidated_properties) {
+void Interface::signal_property_changed(Holder changed_properties, Holder invalidated_properties,
+                                        uint64_t timestamp) {
+    if (timestamp != 0) {
+        _last_update_timestamp = timestamp;
+    }
+
     _property_update_mutex.lock();
     auto changed_options = changed_properties.get_dict_string();
     for (auto& [name, value] : changed_options) {
@@ -129,6 +171,8 @@ void Interface::signal_property_changed(Holder changed_properties, Holder invali
     }
 }
 
+uint64_t Interface::last_update_timestamp() const { return _last_update_timestamp; }
+
 // ----- MESSAGES -----
 
 void Interface::message_handle(Message& msg) {}
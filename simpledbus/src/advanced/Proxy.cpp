@@ -12,6 +12,7 @@ Proxy::Proxy(std::shared_ptr<Connection> conn, const std::string& bus_name, cons
 Proxy::~Proxy() {
     on_child_created.unload();
     on_child_signal_received.unload();
+    on_child_removed.unload();
 }
 
 std::shared_ptr<Interface> Proxy::interfaces_create(const std::string& name) {
@@ -26,7 +27,11 @@ bool Proxy::valid() const { return _valid; }
 
 std::string Proxy::path() const { return _path; }
 
-const std::map<std::string, std::shared_ptr<Proxy>>& Proxy::children() { return _children; }
+const std::map<std::string, std::shared_ptr<Proxy>>& Proxy::children() {
+    std::scoped_lock lock(_child_access_mutex);
+    path_materialize_all();
+    return _children;
+}
 
 const std::map<std::string, std::shared_ptr<Interface>>& Proxy::interfaces() { return _interfaces; }
 
@@ -63,9 +68,16 @@ size_t Proxy::interfaces_count() {
     return count;
 }
 
-void Proxy::interfaces_load(Holder managed_interfaces) {
+void Proxy::interfaces_load(Holder managed_interfaces, uint64_t timestamp) {
+    _last_update_timestamp = timestamp;
     auto managed_interface = managed_interfaces.get_dict_string();
 
+    // An object that was removed becomes valid again when its interfaces come back, such as after a
+    // service restart, so that references held elsewhere keep working.
+    if (!managed_interface.empty()) {
+        _valid = true;
+    }
+
     std::scoped_lock lock(_interface_access_mutex);
     for (auto& [iface_name, options] : managed_interface) {
         // If the interface has not been loaded, load it
@@ -73,7 +85,7 @@ void Proxy::interfaces_load(Holder managed_interfaces) {
             _interfaces.emplace(std::make_pair(iface_name, interfaces_create(iface_name)));
         }
 
-        _interfaces[iface_name]->load(options);
+        _interfaces[iface_name]->load(options, timestamp);
     }
 }
 
@@ -96,6 +108,23 @@ void Proxy::interfaces_unload(SimpleDBus::Holder removed_interfaces) {
     }
 }
 
+void Proxy::interfaces_sync(Holder managed_interfaces) {
+    auto managed_interface = managed_interfaces.get_dict_string();
+    if (!managed_interface.empty()) {
+        _valid = true;
+    }
+
+    std::scoped_lock lock(_interface_access_mutex);
+    for (auto& [iface_name, options] : managed_interface) {
+        if (!interface_exists(iface_name)) {
+            _interfaces.emplace(std::make_pair(iface_name, interfaces_create(iface_name)));
+            _interfaces[iface_name]->load(options);
+        } else {
+            _interfaces[iface_name]->sync(options);
+        }
+    }
+}
+
 bool Proxy::interfaces_loaded() {
     std::scoped_lock lock(_interface_access_mutex);
     for (auto& [iface_name, interface] : _interfaces) {
@@ -110,6 +139,7 @@ bool Proxy::interfaces_loaded() {
 
 bool Proxy::path_exists(const std::string& path) {
     std::scoped_lock lock(_child_access_mutex);
+    path_materialize(path);
     return _children.find(path) != _children.end();
 }
 
@@ -121,16 +151,24 @@ std::shared_ptr<Proxy> Proxy::path_get(const std::string& path) {
     return _children[path];
 }
 
-void Proxy::path_add(const std::string& path, SimpleDBus::Holder managed_interfaces) {
+void Proxy::path_add(const std::string& path, SimpleDBus::Holder managed_interfaces, uint64_t timestamp) {
     // If the path is not a child of the current path, then we can't add it.
     if (!Path::is_descendant(_path, path)) {
         // TODO: Should an exception be thrown here?
         return;
     }
 
+    // A deferred child must exist before anything below it can be updated.
+    {
+        std::scoped_lock lock(_child_access_mutex);
+        if (!_deferred.empty()) {
+            path_materialize(Path::next_child(_path, path));
+        }
+    }
+
     // If the path is already in the map, perform a reload of all interfaces.
     if (path_exists(path)) {
-        path_get(path)->interfaces_load(managed_interfaces);
+        path_get(path)->interfaces_load(managed_interfaces, timestamp);
         return;
     }
 
@@ -140,27 +178,23 @@ void Proxy::path_add(const std::string& path, SimpleDBus::Holder managed_interfa
     if (Path::is_child(_path, path)) {
         // If the path is a direct child of the proxy path, create a new proxy for it.
         std::shared_ptr<Proxy> child = path_create(path);
-        child->interfaces_load(managed_interfaces);
+        child->interfaces_load(managed_interfaces, timestamp);
         _children.emplace(std::make_pair(path, child));
         on_child_created(path);
     } else {
         // If the new path is for a descendant of the current proxy, check if there is a child proxy for it.
-        auto child_result = std::find_if(
-            _children.begin(), _children.end(),
-            [path](const std::pair<std::string, std::shared_ptr<Proxy>>& child_data) -> bool {
-                return Path::is_descendant(child_data.first, path);
-            });
+        std::string child_path = Path::next_child(_path, path);
+        auto child_result = _children.find(child_path);
 
         if (child_result != _children.end()) {
             // If there is a child proxy for the new path, forward it to that child proxy.
-            child_result->second->path_add(path, managed_interfaces);
+            child_result->second->path_add(path, managed_interfaces, timestamp);
         } else {
             // If there is no child proxy for the new path, create the child and forward the path to it.
             // This path will be taken if an empty proxy object needs to be created for an intermediate path.
-            std::string child_path = Path::next_child(_path, path);
             std::shared_ptr<Proxy> child = path_create(child_path);
             _children.emplace(std::make_pair(child_path, child));
-            child->path_add(path, managed_interfaces);
+            child->path_add(path, managed_interfaces, timestamp);
             on_child_created(child_path);
         }
     }
@@ -184,10 +218,15 @@ bool Proxy::path_remove(const std::string& path, SimpleDBus::Holder options) {
     std::scoped_lock lock(_child_access_mutex);
 
     // If the path is a direct child of the proxy path, forward the request to the child proxy.
+    // A deferred child is materialized first, so that removal callbacks fire as usual.
     std::string child_path = Path::next_child(_path, path);
     if (path_exists(child_path)) {
         bool must_erase = _children.at(child_path)->path_remove(path, options);
 
+        if (must_erase) {
+            on_child_removed(child_path);
+        }
+
         // if the child proxy is no longer needed and there is only one active instance of the child proxy,
         // then remove it.
         if (must_erase && _children.at(child_path).use_count() == 1) {
@@ -214,9 +253,9 @@ bool Proxy::path_prune() {
     }
 
     // For self to be pruned, the following conditions must be met:
-    // 1. The proxy has no children
+    // 1. The proxy has no children, whether created or deferred.
     // 2. The proxy has no interfaces or all interfaces are disabled.
-    if (_children.empty() && !interfaces_loaded()) {
+    if (_children.empty() && _deferred.empty() && !interfaces_loaded()) {
         return true;
     }
 
@@ -235,10 +274,163 @@ void Proxy::path_append_child(const std::string& path, std::shared_ptr<Proxy> ch
     _children.emplace(std::make_pair(path, child));
 }
 
+void Proxy::path_defer(const std::string& path, Holder managed_interfaces) {
+    if (!Path::is_descendant(_path, path)) {
+        return;
+    }
+
+    std::scoped_lock lock(_child_access_mutex);
+
+    std::string child_path = Path::next_child(_path, path);
+    auto child = _children.find(child_path);
+    if (child == _children.end()) {
+        _deferred[child_path][path] = std::move(managed_interfaces);
+    } else if (child_path == path) {
+        child->second->interfaces_load(std::move(managed_interfaces));
+    } else {
+        // Existing children keep track of their own deferred descendants.
+        child->second->path_defer(path, std::move(managed_interfaces));
+    }
+}
+
+size_t Proxy::path_deferred_count() {
+    std::scoped_lock lock(_child_access_mutex);
+    return _deferred.size();
+}
+
+void Proxy::path_materialize(const std::string& child_path) {
+    auto deferred = _deferred.find(child_path);
+    if (deferred == _deferred.end()) {
+        return;
+    }
+
+    std::map<std::string, Holder> objects = std::move(deferred->second);
+    _deferred.erase(deferred);
+
+    std::shared_ptr<Proxy> child = path_create(child_path);
+    _children.emplace(std::make_pair(child_path, child));
+
+    // Objects are sorted by path, so every object is added after its ancestors.
+    for (auto& [path, managed_interfaces] : objects) {
+        if (path == child_path) {
+            child->interfaces_load(managed_interfaces);
+        } else {
+            child->path_add(path, managed_interfaces);
+        }
+    }
+}
+
+void Proxy::path_materialize_all() {
+    while (!_deferred.empty()) {
+        path_materialize(_deferred.begin()->first);
+    }
+}
+
+void Proxy::path_materialize_if(std::function<bool(const Holder& managed_interfaces)> predicate) {
+    std::vector<std::string> selected;
+    for (auto& [child_path, objects] : _deferred) {
+        auto own = objects.find(child_path);
+        if (own != objects.end() && predicate(own->second)) {
+            selected.push_back(child_path);
+        }
+    }
+    for (auto& child_path : selected) {
+        path_materialize(child_path);
+    }
+}
+
+std::shared_ptr<Proxy> Proxy::path_resolve(const std::string& path) {
+    if (!Path::is_descendant(_path, path)) {
+        return nullptr;
+    }
+
+    std::scoped_lock lock(_child_access_mutex);
+    auto child = _children.find(Path::next_child(_path, path));
+    if (child == _children.end()) {
+        return nullptr;
+    }
+    if (child->first == path) {
+        return child->second;
+    }
+    return child->second->path_resolve(path);
+}
+
+void Proxy::path_collect_interfaces(std::map<std::string, std::vector<std::string>>& loaded_interfaces) {
+    std::scoped_lock lock(_child_access_mutex);
+
+    for (auto& [child_path, child] : _children) {
+        {
+            std::scoped_lock interface_lock(child->_interface_access_mutex);
+            for (auto& [iface_name, interface] : child->_interfaces) {
+                if (interface->is_loaded()) {
+                    loaded_interfaces[child_path].push_back(iface_name);
+                }
+            }
+        }
+        child->path_collect_interfaces(loaded_interfaces);
+    }
+
+    for (auto& [child_path, objects] : _deferred) {
+        for (auto& [path, managed_interfaces] : objects) {
+            for (auto& [iface_name, options] : managed_interfaces.get_dict_string()) {
+                loaded_interfaces[path].push_back(iface_name);
+            }
+        }
+    }
+}
+
+void Proxy::path_sync(const std::map<std::string, Holder>& managed_objects,
+                      std::function<bool(const std::string& path)> defer) {
+    // Remove whatever is no longer there, as InterfacesRemoved would have.
+    std::map<std::string, std::vector<std::string>> loaded_interfaces;
+    path_collect_interfaces(loaded_interfaces);
+
+    for (auto& [path, iface_names] : loaded_interfaces) {
+        auto managed_object = managed_objects.find(path);
+        std::map<std::string, Holder> managed_interface;
+        if (managed_object != managed_objects.end()) {
+            managed_interface = managed_object->second.get_dict_string();
+        }
+
+        Holder removed_interfaces = Holder::create_array();
+        bool removed = false;
+        for (auto& iface_name : iface_names) {
+            if (managed_interface.find(iface_name) == managed_interface.end()) {
+                removed_interfaces.array_append(Holder::create_string(iface_name));
+                removed = true;
+            }
+        }
+
+        if (removed) {
+            path_remove(path, removed_interfaces);
+        }
+    }
+
+    // Paths are sorted, so parents are always handled before their descendants.
+    for (auto& [path, managed_interfaces] : managed_objects) {
+        if (!Path::is_descendant(_path, path)) {
+            continue;
+        }
+
+        std::shared_ptr<Proxy> proxy = path_resolve(path);
+        if (proxy) {
+            proxy->interfaces_sync(managed_interfaces);
+        } else if (defer && defer(path)) {
+            path_defer(path, managed_interfaces);
+        } else {
+            path_add(path, managed_interfaces);
+        }
+    }
+}
+
 // ----- MESSAGE HANDLING -----
+uint64_t Proxy::last_update_timestamp() const { return _last_update_timestamp; }
+
 void Proxy::message_forward(Message& msg) {
     // If the message is for the current proxy, then forward it to the message handler.
     if (msg.get_path() == _path) {
+        _last_update_timestamp = msg.get_receive_timestamp();
+
         // If the message is involves a property change, forward it to the correct interface.
         if (msg.is_signal("org.freedesktop.DBus.Properties", "PropertiesChanged")) {
             Holder interface_h = msg.extract();
@@ -253,7 +445,8 @@ void Proxy::message_forward(Message& msg) {
                 return;
             }
 
-            interface_get(iface_name)->signal_property_changed(changed_properties, invalidated_properties);
+            interface_get(iface_name)->signal_property_changed(changed_properties, invalidated_properties,
+                                                               msg.get_receive_timestamp());
 
         } else if (interface_exists(msg.get_interface())) {
             interface_get(msg.get_interface())->message_handle(msg);
@@ -262,19 +455,30 @@ void Proxy::message_forward(Message& msg) {
         return;
     }
 
-    // If the message is for a child proxy or a descendant, forward it to that child proxy.
-    for (auto& [child_path, child] : _children) {
-        if (child_path == msg.get_path()) {
-            child->message_forward(msg);
+    // Messages can be forwarded from several threads when the tree is served by more than one connection, so
+    // the child is looked up under the lock but the message is handed to it once the lock is released.
+    std::shared_ptr<Proxy> target;
+    {
+        std::scoped_lock lock(_child_access_mutex);
 
-            if (msg.get_type() == Message::Type::SIGNAL) {
-                on_child_signal_received(child_path);
-            }
+        // A message addressed to a deferred child or one of its descendants requires it to be created.
+        if (!_deferred.empty()) {
+            path_materialize(Path::next_child(_path, msg.get_path()));
+        }
 
-            return;
-        } else if (Path::is_descendant(child_path, msg.get_path())) {
-            child->message_forward(msg);
-            return;
+        // If the message is for a child proxy or a descendant, forward it to that child proxy.
+        for (auto& [child_path, child] : _children) {
+            if (child_path == msg.get_path() || Path::is_descendant(child_path, msg.get_path())) {
+                target = child;
+                break;
+            }
         }
     }
+
+    if (!target) return;
+
+    target->message_forward(msg);
+    if (target->path() == msg.get_path() && msg.get_type() == Message::Type::SIGNAL) {
+        on_child_signal_received(target->path());
+    }
 }
@@ -1,13 +1,30 @@
 #include <simpledbus/base/Connection.h>
 #include <simpledbus/base/Exceptions.h>
+#include <simpledbus/base/PendingCall.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
 #include "Logging.h"
 
 using namespace SimpleDBus;
 
-Connection::Connection(DBusBusType dbus_bus_type) : _dbus_bus_type(dbus_bus_type) {}
+// Same as the default timeout of libdbus.
+static constexpr uint64_t REPLY_TIMEOUT_NS = 25000000000ULL;
+
+static uint64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+Connection::Connection(DBusBusType dbus_bus_type, bool private_connection)
+    : _dbus_bus_type(dbus_bus_type), _private(private_connection) {}
 
 Connection::~Connection() {
     if (_initialized) {
@@ -20,19 +37,34 @@ void Connection::init() {
         return;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    std::lock_guard<std::recursive_mutex> lock(_receive_mutex);
+
+    _reply_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_reply_wake_fd < 0) {
+        throw Exception::DBusException("org.freedesktop.DBus.Error.Failed", "Unable to set up reply notifications");
+    }
 
     ::DBusError err;
     dbus_error_init(&err);
 
     dbus_threads_init_default();
-    _conn = dbus_bus_get(_dbus_bus_type, &err);
+    _conn = _private ? dbus_bus_get_private(_dbus_bus_type, &err) : dbus_bus_get(_dbus_bus_type, &err);
     if (dbus_error_is_set(&err)) {
         std::string err_name = err.name;
         std::string err_message = err.message;
         dbus_error_free(&err);
+        close(_reply_wake_fd);
+        _reply_wake_fd = -1;
         throw Exception::DBusException(err_name, err_message);
     }
+
+    // libdbus reports whenever messages are queued in memory, which can happen on any call reading the socket.
+    dbus_connection_set_dispatch_status_function(_conn, &Connection::_dispatch_status_changed, this, nullptr);
+
+    // Losing a private connection must not terminate the process, unlike what libdbus does by default.
+    if (_private) {
+        dbus_connection_set_exit_on_disconnect(_conn, false);
+    }
     _initialized = true;
 }
 
@@ -41,87 +73,196 @@ void Connection::uninit() {
         return;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
-
-    // In order to prevent a crash on any third party environment
-    // we need to flush the connection queue.
-    SimpleDBus::Message message;
-    do {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        read_write();
-        message = pop_message();
-    } while (message.is_valid());
+    // The shared connection outlives this object, so rules left behind would keep routing signals to it.
+    _match_rules.clear();
+
+    std::vector<std::shared_ptr<PendingReply>> completed;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_receive_mutex);
+
+        // In order to prevent a crash on any third party environment
+        // we need to flush the connection queue.
+        SimpleDBus::Message message;
+        do {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            read_write();
+            message = pop_message();
+        } while (message.is_valid());
+
+        {
+            std::lock_guard<std::mutex> reply_lock(_reply_mutex);
+
+            // Calls still in flight will never see their reply.
+            for (auto& [serial, reply] : _pending_replies) {
+                reply->error = std::make_exception_ptr(Exception::SendFailed(
+                    "org.freedesktop.DBus.Error.Disconnected", "Connection closed", reply->description));
+                _complete_reply(reply, completed);
+            }
+            _pending_replies.clear();
+
+            _close_poller();
+        }
+        _deferred.clear();
+
+        dbus_connection_set_dispatch_status_function(_conn, nullptr, nullptr, nullptr);
+        close(_reply_wake_fd);
+        _reply_wake_fd = -1;
+
+        // Private connections are not closed by libdbus when the last reference goes away.
+        if (_private) {
+            dbus_connection_close(_conn);
+        }
+        dbus_connection_unref(_conn);
+        _initialized = false;
+    }
 
-    dbus_connection_unref(_conn);
-    _initialized = false;
+    _run_callbacks(completed);
 }
 
 bool Connection::is_initialized() { return _initialized; }
 
-void Connection::add_match(std::string rule) {
+bool Connection::is_private() const { return _private; }
+
+void Connection::add_match(std::string rule) { _call_bus("AddMatch", rule); }
+
+void Connection::remove_match(std::string rule) { _call_bus("RemoveMatch", rule); }
+
+MatchRules& Connection::match_rules() { return _match_rules; }
+
+void Connection::read_write() {
     if (!_initialized) {
         throw Exception::NotInitialized();
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    std::lock_guard<std::recursive_mutex> lock(_receive_mutex);
 
-    ::DBusError err;
-    dbus_error_init(&err);
+    // Non blocking read of the next available message
+    dbus_connection_read_write(_conn, 0);
+}
 
-    dbus_bus_add_match(_conn, rule.c_str(), &err);
-    dbus_connection_flush(_conn);
-    if (dbus_error_is_set(&err)) {
-        std::string err_name = err.name;
-        std::string err_message = err.message;
-        dbus_error_free(&err);
-        throw Exception::DBusException(err_name, err_message);
+Message Connection::pop_message() {
+    if (!_initialized) {
+        throw Exception::NotInitialized();
+    }
+
+    std::vector<std::shared_ptr<PendingReply>> completed;
+    Message message;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_receive_mutex);
+
+        if (!_deferred.empty()) {
+            message = std::move(_deferred.front());
+            _deferred.pop_front();
+        } else {
+            std::lock_guard<std::mutex> reply_lock(_reply_mutex);
+            message = _pop_unclaimed(completed);
+        }
+
+        // Everything in memory has been handed out, so only new data can make the descriptor readable again.
+        if (!message.is_valid()) {
+            _clear_poller();
+        }
     }
+
+    _run_callbacks(completed);
+    return message;
 }
 
-void Connection::remove_match(std::string rule) {
+size_t Connection::drain(size_t max, std::function<void(Message& message)> const& callback) {
     if (!_initialized) {
         throw Exception::NotInitialized();
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    std::lock_guard<std::mutex> drain_lock(_drain_mutex);
 
-    ::DBusError err;
-    dbus_error_init(&err);
+    std::vector<std::shared_ptr<PendingReply>> completed;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_receive_mutex);
 
-    dbus_bus_remove_match(_conn, rule.c_str(), &err);
-    dbus_connection_flush(_conn);
-    if (dbus_error_is_set(&err)) {
-        std::string err_name = err.name;
-        std::string err_message = err.message;
-        dbus_error_free(&err);
-        throw Exception::DBusException(err_name, err_message);
+        dbus_connection_read_write(_conn, 0);
+
+        while (_drain_buffer.size() < max && !_deferred.empty()) {
+            _drain_buffer.push_back(std::move(_deferred.front()));
+            _deferred.pop_front();
+        }
+
+        std::lock_guard<std::mutex> reply_lock(_reply_mutex);
+        while (_drain_buffer.size() < max) {
+            Message message = _pop_unclaimed(completed);
+            if (!message.is_valid()) break;
+            _drain_buffer.push_back(std::move(message));
+        }
+
+        if (_drain_buffer.size() < max) {
+            _clear_poller();
+        }
+    }
+
+    _run_callbacks(completed);
+
+    size_t dispatched = 0;
+    try {
+        for (; dispatched < _drain_buffer.size(); dispatched++) {
+            callback(_drain_buffer[dispatched]);
+        }
+    } catch (...) {
+        // The failing message counts as dispatched, the remaining ones go back to the front of the queue.
+        std::lock_guard<std::recursive_mutex> lock(_receive_mutex);
+        for (size_t i = _drain_buffer.size(); i > dispatched + 1; i--) {
+            _deferred.push_front(std::move(_drain_buffer[i - 1]));
+        }
+        if (!_deferred.empty()) {
+            _wake_poller();
+        }
+        _drain_buffer.clear();
+        throw;
     }
+
+    _drain_buffer.clear();
+    return dispatched;
 }
 
-void Connection::read_write() {
+int Connection::poll_fd() {
     if (!_initialized) {
         throw Exception::NotInitialized();
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    // The reply timer is used by sending threads as well.
+    std::lock_guard<std::recursive_mutex> lock(_receive_mutex);
+    std::lock_guard<std::mutex> reply_lock(_reply_mutex);
 
-    // Non blocking read of the next available message
-    dbus_connection_read_write(_conn, 0);
-}
+    if (_poll_fd >= 0) {
+        return _poll_fd;
+    }
 
-Message Connection::pop_message() {
-    if (!_initialized) {
-        throw Exception::NotInitialized();
+    int socket_fd = -1;
+    if (!dbus_connection_get_unix_fd(_conn, &socket_fd)) {
+        throw Exception::DBusException("org.freedesktop.DBus.Error.Failed", "Connection has no file descriptor");
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _poll_fd = epoll_create1(EPOLL_CLOEXEC);
+    _wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    _timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
 
-    DBusMessage* msg = dbus_connection_pop_message(_conn);
-    if (msg == nullptr) {
-        return Message();
-    } else {
-        return Message(msg);
+    bool success = _poll_fd >= 0 && _wake_fd >= 0 && _timer_fd >= 0;
+    for (int fd : {socket_fd, _wake_fd.load(), _timer_fd}) {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        success = success && epoll_ctl(_poll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
     }
+
+    if (!success) {
+        _close_poller();
+        throw Exception::DBusException("org.freedesktop.DBus.Error.Failed", "Unable to set up polling");
+    }
+
+    _arm_reply_timer();
+
+    // Messages might already be waiting.
+    _wake_poller();
+
+    return _poll_fd;
 }
 
 void Connection::send(Message& msg) {
@@ -129,40 +270,312 @@ void Connection::send(Message& msg) {
         throw Exception::NotInitialized();
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
-
     uint32_t msg_serial = 0;
     dbus_connection_send(_conn, msg._msg, &msg_serial);
     dbus_connection_flush(_conn);
 }
 
 Message Connection::send_with_reply_and_block(Message& msg) {
+    // The reply goes through the same table as the asynchronous calls, so that it can be picked up by whichever
+    // thread pops it. Blocking in libdbus instead would require keeping every other thread from popping messages.
+    std::shared_ptr<PendingReply> reply = _send_with_reply(msg);
+    wait_for_reply(*reply);
+
+    if (reply->error) {
+        std::rethrow_exception(reply->error);
+    }
+    return reply->reply;
+}
+
+PendingCall Connection::send_with_reply(Message& msg) { return PendingCall(this, _send_with_reply(msg)); }
+
+void Connection::send_with_reply(Message& msg,
+                                 std::function<void(Message& reply, std::exception_ptr error)> callback) {
+    _send_with_reply(msg, std::move(callback));
+}
+
+std::string Connection::unique_name() {
     if (!_initialized) {
         throw Exception::NotInitialized();
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    // The name is assigned when connecting and cached by libdbus.
+    return std::string(dbus_bus_get_unique_name(_conn));
+}
+
+bool Connection::reply_completed(PendingReply const& reply) {
+    std::lock_guard<std::mutex> lock(_reply_mutex);
+    return reply.completed;
+}
+
+void Connection::wait_for_reply(PendingReply& reply) {
+    std::vector<std::shared_ptr<PendingReply>> completed;
+    bool reading = false;
+    while (true) {
+        // Only one thread blocks on the socket at a time. It reads the replies of every other waiting thread and
+        // hands over once its own reply is in, or while it runs the callbacks of those it read.
+        if (!reading) {
+            std::unique_lock<std::mutex> reply_lock(_reply_mutex);
+            _reply_cv.wait(reply_lock, [&]() { return reply.completed || !_reply_reader; });
+            if (reply.completed) return;
+            _reply_reader = true;
+            reading = true;
+        }
+
+        bool done = false;
+        int socket_fd = -1;
+        int wake_fd = -1;
+        {
+            std::lock_guard<std::recursive_mutex> receive_lock(_receive_mutex);
+
+            // Calls still pending when the connection is closed are completed by uninit().
+            {
+                std::lock_guard<std::mutex> reply_lock(_reply_mutex);
+                done = reply.completed;
+            }
+
+            if (!done) {
+                // Cleared before reading, so that messages queued by another thread from now on wake us up.
+                uint64_t value;
+                while (read(_reply_wake_fd, &value, sizeof(value)) > 0) {
+                }
+                dbus_connection_read_write(_conn, 0);
+
+                // Messages that are not replies are kept for pop_message(), in the order they arrived.
+                std::lock_guard<std::mutex> reply_lock(_reply_mutex);
+                Message message = _pop_unclaimed(completed);
+                while (message.is_valid()) {
+                    _deferred.push_back(std::move(message));
+                    message = _pop_unclaimed(completed);
+                }
+                done = reply.completed;
+            }
+
+            if (!_deferred.empty()) {
+                _wake_poller();
+            }
+
+            // The callbacks can make blocking calls of their own, so the socket is handed over before they run.
+            if (done || !completed.empty()) {
+                std::lock_guard<std::mutex> reply_lock(_reply_mutex);
+                _reply_reader = false;
+                reading = false;
+                _reply_cv.notify_all();
+            } else {
+                dbus_connection_get_unix_fd(_conn, &socket_fd);
+                wake_fd = _reply_wake_fd;
+            }
+        }
+
+        if (!completed.empty()) {
+            _run_callbacks(completed);
+            completed.clear();
+        }
+        if (done) return;
+        if (!reading) continue;
+
+        // Expired calls are completed by the next pass, once the deadline has gone by.
+        uint64_t now = steady_now_ns();
+        int timeout_ms = reply.deadline > now ? static_cast<int>((reply.deadline - now + 999999) / 1000000) : 0;
+
+        struct pollfd fds[2] = {{socket_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+        poll(fds, 2, timeout_ms);
+    }
+}
+
+std::shared_ptr<PendingReply> Connection::_send_with_reply(Message& msg, PendingReply::Callback callback) {
+    if (!_initialized) {
+        throw Exception::NotInitialized();
+    }
+
+    auto reply = std::make_shared<PendingReply>();
+    reply->description = msg.to_string();
+    reply->callback = std::move(callback);
+
+    {
+        std::lock_guard<std::mutex> lock(_reply_mutex);
+
+        uint32_t serial = 0;
+        if (!dbus_connection_get_is_connected(_conn) || !dbus_connection_send(_conn, msg._msg, &serial)) {
+            throw Exception::SendFailed("org.freedesktop.DBus.Error.Disconnected", "Unable to send message",
+                                        reply->description);
+        }
+
+        reply->deadline = steady_now_ns() + REPLY_TIMEOUT_NS;
+        _pending_replies[serial] = reply;
+        if (reply->deadline < _next_reply_deadline) {
+            _next_reply_deadline = reply->deadline;
+            _arm_reply_timer();
+        }
+    }
+
+    dbus_connection_flush(_conn);
+    return reply;
+}
+
+void Connection::_call_bus(std::string const& method, std::string const& rule) {
+    Message msg = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+                                              method);
+    msg.append_argument(Holder::create_string(rule), DBUS_TYPE_STRING_AS_STRING);
+    send_with_reply_and_block(msg);
+}
+
+Message Connection::_pop_unclaimed(std::vector<std::shared_ptr<PendingReply>>& completed) {
+    _expire_replies(completed);
+
+    while (true) {
+        DBusMessage* msg = dbus_connection_pop_message(_conn);
+        if (msg == nullptr) {
+            return Message();
+        }
+
+        Message message(msg);
+        message._receive_timestamp = steady_now_ns();
+        message._sequence = ++_received_sequence;
+
+        if (!_claim_reply(message, completed)) {
+            return message;
+        }
+    }
+}
+
+bool Connection::_claim_reply(Message& message, std::vector<std::shared_ptr<PendingReply>>& completed) {
+    if (_pending_replies.empty()) return false;
+
+    Message::Type type = message.get_type();
+    if (type != Message::METHOD_RETURN && type != Message::ERROR) return false;
+
+    auto it = _pending_replies.find(dbus_message_get_reply_serial(message._msg));
+    if (it == _pending_replies.end()) return false;
+
+    std::shared_ptr<PendingReply> reply = it->second;
+    _pending_replies.erase(it);
 
     ::DBusError err;
     dbus_error_init(&err);
-    DBusMessage* msg_tmp = dbus_connection_send_with_reply_and_block(_conn, msg._msg, -1, &err);
-
-    if (dbus_error_is_set(&err)) {
-        std::string err_name = err.name;
-        std::string err_message = err.message;
+    if (dbus_set_error_from_message(&err, message._msg)) {
+        reply->error = std::make_exception_ptr(Exception::SendFailed(err.name, err.message, reply->description));
         dbus_error_free(&err);
-        throw Exception::SendFailed(err_name, err_message, msg.to_string());
+    } else {
+        reply->reply = std::move(message);
     }
 
-    return Message(msg_tmp);
+    _complete_reply(reply, completed);
+    return true;
 }
 
-std::string Connection::unique_name() {
-    if (!_initialized) {
-        throw Exception::NotInitialized();
+void Connection::_expire_replies(std::vector<std::shared_ptr<PendingReply>>& completed) {
+    uint64_t now = steady_now_ns();
+    if (now < _next_reply_deadline) return;
+
+    _next_reply_deadline = UINT64_MAX;
+    for (auto it = _pending_replies.begin(); it != _pending_replies.end();) {
+        std::shared_ptr<PendingReply> reply = it->second;
+        if (reply->deadline > now) {
+            _next_reply_deadline = std::min(_next_reply_deadline, reply->deadline);
+            it++;
+            continue;
+        }
+
+        it = _pending_replies.erase(it);
+        reply->error = std::make_exception_ptr(Exception::SendFailed("org.freedesktop.DBus.Error.NoReply",
+                                                                     "No reply received", reply->description));
+        _complete_reply(reply, completed);
     }
 
-    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _arm_reply_timer();
+}
 
-    return std::string(dbus_bus_get_unique_name(_conn));
+void Connection::_complete_reply(std::shared_ptr<PendingReply> const& reply,
+                                 std::vector<std::shared_ptr<PendingReply>>& completed) {
+    reply->completed = true;
+    if (reply->callback) {
+        completed.push_back(reply);
+    }
+    _reply_cv.notify_all();
+
+    // The reply might have been read by a thread other than the one blocked on the socket.
+    if (_reply_reader) {
+        _wake_reply_reader();
+    }
+}
+
+void Connection::_run_callbacks(std::vector<std::shared_ptr<PendingReply>>& completed) {
+    for (auto& reply : completed) {
+        try {
+            reply->callback(reply->reply, reply->error);
+        } catch (std::exception const& e) {
+            LOG_ERROR("Exception in reply callback: {}", e.what());
+        }
+        reply->callback = nullptr;
+    }
+}
+
+void Connection::_wake_poller() {
+    int wake_fd = _wake_fd;
+    if (wake_fd < 0) return;
+
+    uint64_t value = 1;
+    if (write(wake_fd, &value, sizeof(value)) < 0) {
+        // The counter can only fail to increase if it is already pending, which wakes up the poller anyway.
+    }
+}
+
+void Connection::_wake_reply_reader() {
+    if (_reply_wake_fd < 0) return;
+
+    uint64_t value = 1;
+    if (write(_reply_wake_fd, &value, sizeof(value)) < 0) {
+        // The counter can only fail to increase if it is already pending.
+    }
+}
+
+void Connection::_clear_poller() {
+    if (_wake_fd < 0) return;
+
+    uint64_t value;
+    while (read(_wake_fd, &value, sizeof(value)) > 0) {
+    }
+    while (read(_timer_fd, &value, sizeof(value)) > 0) {
+    }
+
+    // Sending threads also read from the socket, so a message might have been queued in the meantime.
+    if (dbus_connection_get_dispatch_status(_conn) == DBUS_DISPATCH_DATA_REMAINS) {
+        _wake_poller();
+    }
+}
+
+void Connection::_arm_reply_timer() {
+    if (_timer_fd < 0) return;
+
+    // std::chrono::steady_clock is CLOCK_MONOTONIC on Linux. An all-zero value disarms the timer.
+    struct itimerspec spec = {};
+    if (_next_reply_deadline != UINT64_MAX) {
+        spec.it_value.tv_sec = static_cast<time_t>(_next_reply_deadline / 1000000000ULL);
+        spec.it_value.tv_nsec = static_cast<long>(_next_reply_deadline % 1000000000ULL);
+    }
+    timerfd_settime(_timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void Connection::_close_poller() {
+    // The eventfd is released first, as the dispatch status callback may still be running.
+    int wake_fd = _wake_fd.exchange(-1);
+    if (wake_fd >= 0) {
+        close(wake_fd);
+    }
+
+    for (int* fd : {&_poll_fd, &_timer_fd}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void Connection::_dispatch_status_changed(::DBusConnection*, ::DBusDispatchStatus status, void* data) {
+    if (status == DBUS_DISPATCH_DATA_REMAINS) {
+        Connection* connection = static_cast<Connection*>(data);
+        connection->_wake_poller();
+        connection->_wake_reply_reader();
+    }
 }
@@ -0,0 +1,69 @@
+#include <simpledbus/base/ConnectionPool.h>
+#include <simpledbus/base/Exceptions.h>
+
+#include <algorithm>
+
+using namespace SimpleDBus;
+
+ConnectionPool::ConnectionPool(DBusBusType dbus_bus_type, size_t size) : _load(size, 0) {
+    for (size_t i = 0; i < size; i++) {
+        _connections.push_back(std::make_shared<Connection>(dbus_bus_type, true));
+    }
+}
+
+ConnectionPool::~ConnectionPool() { uninit(); }
+
+void ConnectionPool::init() {
+    for (auto& connection : _connections) {
+        connection->init();
+    }
+}
+
+void ConnectionPool::uninit() {
+    for (auto& connection : _connections) {
+        connection->uninit();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _assignments.clear();
+    std::fill(_load.begin(), _load.end(), 0);
+}
+
+bool ConnectionPool::is_initialized() {
+    return std::all_of(_connections.begin(), _connections.end(),
+                       [](auto& connection) { return connection->is_initialized(); });
+}
+
+size_t ConnectionPool::size() const { return _connections.size(); }
+
+std::shared_ptr<Connection> ConnectionPool::connection(size_t index) const { return _connections.at(index); }
+
+const std::vector<std::shared_ptr<Connection>>& ConnectionPool::connections() const { return _connections; }
+
+std::shared_ptr<Connection> ConnectionPool::acquire(const std::string& key) {
+    if (_connections.empty()) {
+        throw Exception::NotInitialized();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _assignments.find(key);
+    if (it != _assignments.end()) {
+        return _connections[it->second];
+    }
+
+    size_t index = std::min_element(_load.begin(), _load.end()) - _load.begin();
+    _assignments.emplace(key, index);
+    _load[index]++;
+    return _connections[index];
+}
+
+void ConnectionPool::release(const std::string& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _assignments.find(key);
+    if (it == _assignments.end()) return;
+
+    _load[it->second]--;
+    _assignments.erase(it);
+}
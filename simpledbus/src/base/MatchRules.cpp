@@ -0,0 +1,125 @@
+#include <simpledbus/base/Connection.h>
+#include <simpledbus/base/MatchRules.h>
+
+#include "Logging.h"
+
+#include <exception>
+
+using namespace SimpleDBus;
+
+MatchRules::MatchRules(Connection& conn) : _conn(conn) {}
+
+void MatchRules::add(const std::string& rule) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Concurrent users of a rule being added wait for it, so that they see it in place once they return. If adding
+    // it fails, the next one in line tries again.
+    while (true) {
+        auto it = _rules.find(rule);
+        if (it == _rules.end()) break;
+
+        if (!it->second.pending) {
+            it->second.users++;
+            return;
+        }
+        _cv.wait(lock);
+    }
+
+    Rule& entry = _rules[rule];
+    entry.users = 1;
+    entry.pending = true;
+    entry.id = ++_next_id;
+    uint64_t id = entry.id;
+    lock.unlock();
+
+    std::exception_ptr error;
+    try {
+        _conn.add_match(rule);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    lock.lock();
+    auto it = _rules.find(rule);
+    bool cleared = it == _rules.end() || it->second.id != id;
+    if (!cleared) {
+        if (error) {
+            _rules.erase(it);
+        } else {
+            it->second.pending = false;
+        }
+    }
+    _cv.notify_all();
+    lock.unlock();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    // clear() leaves pending rules to the user adding them.
+    if (cleared) {
+        try {
+            _conn.remove_match(rule);
+        } catch (const std::exception& e) {
+            LOG_WARN("Failed to remove match rule {}: {}", rule, e.what());
+        }
+    }
+}
+
+void MatchRules::remove(const std::string& rule) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _rules.find(rule);
+        if (it == _rules.end() || it->second.pending) return;
+
+        if (--it->second.users > 0) return;
+        _rules.erase(it);
+    }
+
+    // The bus keeps a count of its own for each rule, so this cannot undo an add() of the same rule that started
+    // after the entry was erased.
+    _conn.remove_match(rule);
+}
+
+size_t MatchRules::count(const std::string& rule) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _rules.find(rule);
+    return it == _rules.end() ? 0 : it->second.users;
+}
+
+size_t MatchRules::size() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _rules.size();
+}
+
+void MatchRules::clear() {
+    std::map<std::string, Rule> rules;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        rules.swap(_rules);
+    }
+    _cv.notify_all();
+
+    for (auto& [rule, entry] : rules) {
+        if (entry.pending) continue;
+
+        try {
+            _conn.remove_match(rule);
+        } catch (const std::exception& e) {
+            LOG_WARN("Failed to remove match rule {}: {}", rule, e.what());
+        }
+    }
+}
+
+std::string MatchRules::properties_changed(const std::string& sender, const std::string& path, bool subtree,
+                                           const std::string& interface) {
+    std::string rule = "type='signal',sender='" + sender +
+                       "',interface='org.freedesktop.DBus.Properties',member='PropertiesChanged',";
+    rule += (subtree ? "path_namespace='" : "path='") + path + "'";
+    if (!interface.empty()) {
+        rule += ",arg0='" + interface + "'";
+    }
+    return rule;
+}
@@ -47,6 +47,8 @@ Message::Message(Message&& other) : Message() {
     indent = other.indent;
 
     this->_unique_id = other._unique_id;
+    this->_receive_timestamp = other._receive_timestamp;
+    this->_sequence = other._sequence;
     this->_iter_initialized = other._iter_initialized;
     this->_is_extracted = other._is_extracted;
     this->_extracted = other._extracted;
@@ -66,6 +68,8 @@ Message::Message(const Message& other) : Message() {
         indent = other.indent;
 
         this->_unique_id = creation_counter++;
+        this->_receive_timestamp = other._receive_timestamp;
+        this->_sequence = other._sequence;
         this->_is_extracted = other._is_extracted;
         this->_extracted = other._extracted;
         this->_arguments = other._arguments;
@@ -81,6 +85,8 @@ Message& Message::operator=(Message&& other) {
         indent = other.indent;
 
         this->_unique_id = other._unique_id;
+        this->_receive_timestamp = other._receive_timestamp;
+        this->_sequence = other._sequence;
         this->_iter_initialized = other._iter_initialized;
         this->_is_extracted = other._is_extracted;
         this->_extracted = other._extracted;
@@ -105,6 +111,8 @@ Message& Message::operator=(const Message& other) {
             indent = other.indent;
 
             this->_unique_id = creation_counter++;
+            this->_receive_timestamp = other._receive_timestamp;
+            this->_sequence = other._sequence;
             this->_is_extracted = other._is_extracted;
             this->_extracted = other._extracted;
             this->_arguments = other._arguments;
@@ -117,6 +125,8 @@ Message& Message::operator=(const Message& other) {
 
 void Message::_invalidate() {
     this->_unique_id = -1;
+    this->_receive_timestamp = 0;
+    this->_sequence = 0;
     this->_msg = nullptr;
     this->_iter_initialized = false;
     this->_is_extracted = false;
@@ -294,6 +304,10 @@ void Message::append_argument(Holder argument, std::string signature) {
 
 int32_t Message::get_unique_id() { return _unique_id; }
 
+uint64_t Message::get_receive_timestamp() const { return _receive_timestamp; }
+
+uint64_t Message::get_sequence() const { return _sequence; }
+
 uint32_t Message::get_serial() {
     if (is_valid()) {
         return dbus_message_get_serial(_msg);
@@ -302,6 +316,20 @@ uint32_t Message::get_serial() {
     }
 }
 
+void Message::set_no_reply(bool no_reply) {
+    if (is_valid()) {
+        dbus_message_set_no_reply(_msg, no_reply);
+    }
+}
+
+bool Message::get_no_reply() const {
+    if (is_valid()) {
+        return dbus_message_get_no_reply(_msg);
+    } else {
+        return false;
+    }
+}
+
 std::string Message::get_signature() {
     if (is_valid() && _iter_initialized) {
         return dbus_message_iter_get_signature(&_iter);
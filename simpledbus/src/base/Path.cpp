@@ -118,7 +118,18 @@ bool Path::is_parent(const std::string& base, const std::string& path) {
 }
 
 std::string Path::next_child(const std::string& base, const std::string& path) {
-    return fetch_elements(path, count_elements(base) + 1);
+    size_t count = count_elements(base) + 1;
+    if (count > count_elements(path)) {
+        return path;
+    }
+
+    // Same as fetch_elements(path, count), without splitting the whole path. This is called for every
+    // level of the tree an object is added to or a message is forwarded through.
+    size_t end = 0;
+    for (size_t i = 0; i < count; i++) {
+        end = path.find('/', end + 1);
+    }
+    return path.substr(0, end);
 }
 
 }  // namespace SimpleDBus
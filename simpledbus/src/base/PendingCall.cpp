@@ -0,0 +1,28 @@
+#include <simpledbus/base/Connection.h>
+#include <simpledbus/base/Exceptions.h>
+#include <simpledbus/base/PendingCall.h>
+
+using namespace SimpleDBus;
+
+PendingCall::PendingCall() {}
+
+PendingCall::PendingCall(Connection* conn, std::shared_ptr<PendingReply> reply)
+    : _conn(conn), _reply(std::move(reply)) {}
+
+bool PendingCall::is_valid() const { return _reply != nullptr; }
+
+bool PendingCall::is_completed() const { return _reply != nullptr && _conn->reply_completed(*_reply); }
+
+Message PendingCall::wait() {
+    if (_reply == nullptr) {
+        throw Exception::SendFailed("org.freedesktop.DBus.Error.Disconnected", "No call in flight", "");
+    }
+
+    std::shared_ptr<PendingReply> reply = std::move(_reply);
+    _conn->wait_for_reply(*reply);
+
+    if (reply->error) {
+        std::rethrow_exception(reply->error);
+    }
+    return reply->reply;
+}
@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+
+#include <simpledbus/base/Connection.h>
+#include <simpledbus/base/Message.h>
+
+#include <poll.h>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace SimpleDBus;
+
+class ConnectionTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        conn = new Connection(DBUS_BUS_SESSION);
+        conn->init();
+    }
+
+    void TearDown() override {
+        conn->uninit();
+        delete conn;
+        conn = nullptr;
+    }
+
+    bool readable(int fd, int timeout_ms) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        return poll(&pfd, 1, timeout_ms) == 1 && (pfd.revents & POLLIN);
+    }
+
+    // Processes everything the connection has received, as an event loop would.
+    size_t drain() {
+        size_t count = 0;
+        conn->read_write();
+        for (Message message = conn->pop_message(); message.is_valid(); message = conn->pop_message()) {
+            count++;
+        }
+        return count;
+    }
+
+    // Queues `count` messages addressed to this connection and waits until all of them have been received.
+    void queue_self_calls(size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            Message call = self_call();
+            call.append_argument(Holder::create_uint32(static_cast<uint32_t>(i)), DBUS_TYPE_UINT32_AS_STRING);
+            conn->send(call);
+        }
+
+        // A blocking round trip through the bus guarantees that everything sent before has been delivered.
+        Message get_id = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                     "org.freedesktop.DBus", "GetId");
+        conn->send_with_reply_and_block(get_id);
+    }
+
+    // Method call addressed to this same connection, which shows up as an incoming message.
+    Message self_call() {
+        return Message::create_method_call(conn->unique_name(), "/", "simpledbus.tester.connection", "Ping");
+    }
+
+    Connection* conn;
+};
+
+TEST_F(ConnectionTest, PollFdWakesUpForReplies) {
+    int fd = conn->poll_fd();
+    ASSERT_GE(fd, 0);
+    drain();
+    EXPECT_FALSE(readable(fd, 0));
+
+    bool replied = false;
+    Message call = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                               "org.freedesktop.DBus", "GetId");
+    conn->send_with_reply(call, [&](Message& reply, std::exception_ptr error) { replied = !error && reply.is_valid(); });
+
+    ASSERT_TRUE(readable(fd, 5000));
+    while (!replied && readable(fd, 1000)) {
+        drain();
+    }
+    EXPECT_TRUE(replied);
+    EXPECT_FALSE(readable(fd, 0));
+}
+
+TEST_F(ConnectionTest, PollFdWakesUpForMessagesAlreadyRead) {
+    int fd = conn->poll_fd();
+    drain();
+
+    // The blocking call reads the incoming message off the socket while waiting for its own reply.
+    Message call = self_call();
+    conn->send(call);
+    Message get_id = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                 "org.freedesktop.DBus", "GetId");
+    conn->send_with_reply_and_block(get_id);
+
+    ASSERT_TRUE(readable(fd, 0));
+    EXPECT_EQ(drain(), 1u);
+    EXPECT_FALSE(readable(fd, 0));
+}
+
+TEST_F(ConnectionTest, DrainDispatchesInBatches) {
+    conn->poll_fd();
+    drain();
+    queue_self_calls(10);
+
+    size_t dispatched = 0;
+    EXPECT_EQ(conn->drain(4, [&](Message& message) { dispatched += message.is_valid(); }), 4u);
+    EXPECT_EQ(conn->drain(4, [&](Message& message) { dispatched += message.is_valid(); }), 4u);
+    EXPECT_EQ(conn->drain(4, [&](Message& message) { dispatched += message.is_valid(); }), 2u);
+    EXPECT_EQ(dispatched, 10u);
+    EXPECT_EQ(conn->drain(4, [&](Message&) { dispatched++; }), 0u);
+    EXPECT_FALSE(readable(conn->poll_fd(), 0));
+}
+
+TEST_F(ConnectionTest, DrainKeepsMessagesAfterCallbackThrows) {
+    drain();
+    queue_self_calls(5);
+
+    // Other messages, such as signals from the bus itself, might be interleaved.
+    std::vector<uint32_t> indices;
+    auto record = [&](Message& message) {
+        if (message.get_member() != "Ping") return;
+        uint32_t index = message.extract().get_uint32();
+        indices.push_back(index);
+        if (index == 2) {
+            throw std::runtime_error("Dispatch failed");
+        }
+    };
+
+    EXPECT_THROW(conn->drain(100, record), std::runtime_error);
+    EXPECT_EQ(indices, (std::vector<uint32_t>{0, 1, 2}));
+
+    // The messages not yet dispatched are handed out first, in their original order.
+    conn->drain(100, record);
+    EXPECT_EQ(indices, (std::vector<uint32_t>{0, 1, 2, 3, 4}));
+}
+
+TEST_F(ConnectionTest, SignalsKeepFlowingWhileCallBlocks) {
+    static constexpr size_t SIGNALS = 20;
+    static const std::string MATCH = "type='signal',interface='simpledbus.tester.connection'";
+
+    conn->add_match(MATCH);
+    drain();
+
+    // The call is addressed to this same connection, so it only completes once the thread below answers it.
+    std::atomic_bool call_returned = false;
+    std::thread caller([&]() {
+        Message call = self_call();
+        conn->send_with_reply_and_block(call);
+        call_returned = true;
+    });
+
+    Message pending_reply;
+    size_t received = 0;
+    bool answered = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!call_returned && std::chrono::steady_clock::now() < deadline) {
+        conn->drain(100, [&](Message& message) {
+            if (message.is_signal("simpledbus.tester.connection", "Tick")) {
+                received++;
+            } else if (message.get_member() == "Ping") {
+                // The call is now blocked, waiting for this reply.
+                pending_reply = Message::create_method_return(message);
+                for (size_t i = 0; i < SIGNALS; i++) {
+                    Message signal(dbus_message_new_signal("/", "simpledbus.tester.connection", "Tick"));
+                    conn->send(signal);
+                }
+            }
+        });
+
+        if (pending_reply.is_valid() && received == SIGNALS) {
+            EXPECT_FALSE(call_returned);
+            conn->send(pending_reply);
+            pending_reply = Message();
+            answered = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    caller.join();
+    conn->remove_match(MATCH);
+
+    EXPECT_EQ(received, SIGNALS);
+    EXPECT_TRUE(answered);
+    EXPECT_TRUE(call_returned);
+}
+
+// Only one of the waiting threads reads the socket, which has to pick up the replies of the others as well.
+TEST_F(ConnectionTest, ConcurrentBlockingCallsComplete) {
+    static constexpr size_t THREADS = 8;
+    static constexpr size_t CALLS = 20;
+
+    std::atomic_size_t replies = 0;
+    std::vector<std::thread> callers;
+    for (size_t i = 0; i < THREADS; i++) {
+        callers.emplace_back([&]() {
+            for (size_t j = 0; j < CALLS; j++) {
+                Message get_id = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                             "org.freedesktop.DBus", "GetId");
+                if (conn->send_with_reply_and_block(get_id).is_valid()) {
+                    replies++;
+                }
+            }
+        });
+    }
+
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(replies, THREADS * CALLS);
+}
+
+// The thread blocked on the socket runs the callbacks of the replies it reads, which can make blocking calls too.
+TEST_F(ConnectionTest, BlockingCallFromReplyCallback) {
+    drain();
+
+    // The call is addressed to this same connection, so the caller keeps reading the socket until it is answered.
+    std::thread caller([&]() {
+        Message call = self_call();
+        conn->send_with_reply_and_block(call);
+    });
+
+    Message pending_reply;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pending_reply.is_valid() && std::chrono::steady_clock::now() < deadline) {
+        conn->drain(100, [&](Message& message) {
+            if (message.get_member() == "Ping") {
+                pending_reply = Message::create_method_return(message);
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(pending_reply.is_valid());
+
+    std::atomic_bool nested_returned = false;
+    Message call = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                               "org.freedesktop.DBus", "GetId");
+    conn->send_with_reply(call, [&](Message&, std::exception_ptr) {
+        Message get_id = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                     "org.freedesktop.DBus", "GetId");
+        nested_returned = conn->send_with_reply_and_block(get_id).is_valid();
+    });
+
+    while (!nested_returned && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(nested_returned);
+
+    conn->send(pending_reply);
+    caller.join();
+}
+
+// Reports the dispatch throughput of drain() against that of a read_write() and pop_message() loop.
+TEST_F(ConnectionTest, DrainThroughput) {
+    static constexpr size_t MESSAGES = 10000;
+    static constexpr size_t BATCH_SIZE = 64;
+
+    drain();
+
+    queue_self_calls(MESSAGES);
+    auto start = std::chrono::steady_clock::now();
+    size_t popped = drain();
+    auto pop_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    queue_self_calls(MESSAGES);
+    size_t drained = 0;
+    start = std::chrono::steady_clock::now();
+    while (conn->drain(BATCH_SIZE, [&](Message&) { drained++; }) == BATCH_SIZE) {
+    }
+    auto drain_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(popped, MESSAGES);
+    EXPECT_EQ(drained, MESSAGES);
+
+    std::cout << "pop_message: " << static_cast<uint64_t>(popped / pop_elapsed) << " messages/s, drain: "
+              << static_cast<uint64_t>(drained / drain_elapsed) << " messages/s" << std::endl;
+    RecordProperty("pop_message_per_second", static_cast<int>(popped / pop_elapsed));
+    RecordProperty("drain_per_second", static_cast<int>(drained / drain_elapsed));
+}
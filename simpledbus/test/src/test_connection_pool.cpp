@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <simpledbus/base/Connection.h>
+#include <simpledbus/base/ConnectionPool.h>
+#include <simpledbus/base/Message.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace SimpleDBus;
+
+// Queues `count` messages addressed to `conn` itself and waits until all of them have been received.
+static void queue_self_calls(Connection& conn, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        Message call = Message::create_method_call(conn.unique_name(), "/", "simpledbus.tester.pool", "Ping");
+        conn.send(call);
+    }
+
+    Message get_id = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                 "org.freedesktop.DBus", "GetId");
+    conn.send_with_reply_and_block(get_id);
+}
+
+static size_t drain_all(Connection& conn) {
+    static constexpr size_t BATCH_SIZE = 64;
+
+    size_t count = 0;
+    while (conn.drain(BATCH_SIZE, [&](Message&) { count++; }) == BATCH_SIZE) {
+    }
+    return count;
+}
+
+TEST(ConnectionPool, ConnectionsArePrivate) {
+    Connection shared(DBUS_BUS_SESSION);
+    shared.init();
+
+    ConnectionPool pool(DBUS_BUS_SESSION, 3);
+    pool.init();
+    EXPECT_TRUE(pool.is_initialized());
+
+    std::set<std::string> names = {shared.unique_name()};
+    for (auto& conn : pool.connections()) {
+        EXPECT_TRUE(conn->is_private());
+        names.insert(conn->unique_name());
+    }
+    EXPECT_EQ(names.size(), 4u);
+
+    pool.uninit();
+    EXPECT_FALSE(pool.is_initialized());
+
+    // The shared connection is unaffected by the private ones going away.
+    EXPECT_FALSE(shared.is_private());
+    Message get_id = Message::create_method_call("org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                                 "org.freedesktop.DBus", "GetId");
+    EXPECT_TRUE(shared.send_with_reply_and_block(get_id).is_valid());
+    shared.uninit();
+}
+
+TEST(ConnectionPool, KeysStickToTheLeastLoadedConnection) {
+    ConnectionPool pool(DBUS_BUS_SESSION, 2);
+
+    auto hci0 = pool.acquire("/org/bluez/hci0");
+    auto hci1 = pool.acquire("/org/bluez/hci1");
+    EXPECT_NE(hci0, hci1);
+    EXPECT_EQ(pool.acquire("/org/bluez/hci0"), hci0);
+
+    // Once released, the key no longer counts towards the load of its connection.
+    pool.release("/org/bluez/hci0");
+    EXPECT_EQ(pool.acquire("/org/bluez/hci2"), hci0);
+}
+
+// Reports the dispatch throughput of several busy users sharing one connection and dispatch thread, against that
+// of the same users each having a connection and a thread of their own.
+TEST(ConnectionPool, DispatchThroughput) {
+    static constexpr size_t USERS = 4;
+    static constexpr size_t MESSAGES = 1500;
+
+    Connection shared(DBUS_BUS_SESSION);
+    shared.init();
+    drain_all(shared);
+
+    queue_self_calls(shared, USERS * MESSAGES);
+    auto start = std::chrono::steady_clock::now();
+    size_t shared_count = drain_all(shared);
+    auto shared_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    shared.uninit();
+
+    ConnectionPool pool(DBUS_BUS_SESSION, USERS);
+    pool.init();
+    for (auto& conn : pool.connections()) {
+        drain_all(*conn);
+        queue_self_calls(*conn, MESSAGES);
+    }
+
+    std::vector<size_t> counts(USERS, 0);
+    std::vector<std::thread> threads;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < USERS; i++) {
+        threads.emplace_back([&, i]() { counts[i] = drain_all(*pool.connection(i)); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto pool_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t pool_count = 0;
+    for (size_t count : counts) {
+        pool_count += count;
+    }
+
+    EXPECT_EQ(shared_count, USERS * MESSAGES);
+    EXPECT_EQ(pool_count, USERS * MESSAGES);
+
+    std::cout << "shared connection: " << static_cast<uint64_t>(shared_count / shared_elapsed) << " messages/s, "
+              << USERS << " private connections: " << static_cast<uint64_t>(pool_count / pool_elapsed)
+              << " messages/s" << std::endl;
+    RecordProperty("shared_per_second", static_cast<int>(shared_count / shared_elapsed));
+    RecordProperty("pool_per_second", static_cast<int>(pool_count / pool_elapsed));
+}
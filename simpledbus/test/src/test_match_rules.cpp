@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <simpledbus/base/Connection.h>
+#include <simpledbus/base/MatchRules.h>
+#include <simpledbus/base/Message.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace SimpleDBus;
+
+static const char* TESTER_INTERFACE = "simpledbus.tester.rules";
+
+static void emit_properties_changed(Connection& emitter, const std::string& path, const std::string& interface) {
+    Message signal(dbus_message_new_signal(path.c_str(), "org.freedesktop.DBus.Properties", "PropertiesChanged"));
+    signal.append_argument(Holder::create_string(interface), DBUS_TYPE_STRING_AS_STRING);
+    emitter.send(signal);
+}
+
+static std::string done_rule(Connection& emitter) {
+    return "type='signal',sender='" + emitter.unique_name() + "',interface='" + TESTER_INTERFACE + "',member='Done'";
+}
+
+static void emit_done(Connection& emitter) {
+    Message done(dbus_message_new_signal("/", TESTER_INTERFACE, "Done"));
+    emitter.send(done);
+}
+
+// Collects the paths of the PropertiesChanged signals received before the Done signal. Signals of a single sender
+// are delivered in order, so nothing emitted before it can arrive later.
+static std::vector<std::string> receive(Connection& subscriber) {
+    std::vector<std::string> paths;
+    bool finished = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!finished && std::chrono::steady_clock::now() < deadline) {
+        subscriber.drain(64, [&](Message& message) {
+            if (message.is_signal(TESTER_INTERFACE, "Done")) {
+                finished = true;
+            } else if (message.is_signal("org.freedesktop.DBus.Properties", "PropertiesChanged")) {
+                paths.push_back(message.get_path());
+            }
+        });
+        if (!finished) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    EXPECT_TRUE(finished);
+    return paths;
+}
+
+static std::vector<std::string> collect(Connection& emitter, Connection& subscriber) {
+    emit_done(emitter);
+    return receive(subscriber);
+}
+
+TEST(MatchRules, RulesAreReferenceCounted) {
+    Connection emitter(DBUS_BUS_SESSION, true);
+    emitter.init();
+    Connection subscriber(DBUS_BUS_SESSION, true);
+    subscriber.init();
+
+    subscriber.match_rules().add(done_rule(emitter));
+
+    std::string rule = MatchRules::properties_changed(emitter.unique_name(), "/dev", false);
+    subscriber.match_rules().add(rule);
+    subscriber.match_rules().add(rule);
+    EXPECT_EQ(subscriber.match_rules().count(rule), 2u);
+    EXPECT_EQ(subscriber.match_rules().size(), 2u);
+
+    // A single user dropping the rule leaves it in place for the other one.
+    subscriber.match_rules().remove(rule);
+    EXPECT_EQ(subscriber.match_rules().count(rule), 1u);
+    emit_properties_changed(emitter, "/dev", "org.bluez.Device1");
+    EXPECT_EQ(collect(emitter, subscriber), std::vector<std::string>{"/dev"});
+
+    subscriber.match_rules().remove(rule);
+    EXPECT_EQ(subscriber.match_rules().count(rule), 0u);
+    emit_properties_changed(emitter, "/dev", "org.bluez.Device1");
+    EXPECT_TRUE(collect(emitter, subscriber).empty());
+
+    subscriber.uninit();
+    EXPECT_EQ(subscriber.match_rules().size(), 0u);
+    emitter.uninit();
+}
+
+TEST(MatchRules, ConcurrentUsersShareTheRule) {
+    static constexpr size_t USERS = 8;
+
+    Connection emitter(DBUS_BUS_SESSION, true);
+    emitter.init();
+    Connection subscriber(DBUS_BUS_SESSION, true);
+    subscriber.init();
+
+    subscriber.match_rules().add(done_rule(emitter));
+    std::string rule = MatchRules::properties_changed(emitter.unique_name(), "/dev", false);
+
+    // Every user returns with the rule in place, whichever of them added it to the bus.
+    std::vector<std::thread> users;
+    for (size_t i = 0; i < USERS; i++) {
+        users.emplace_back([&]() { subscriber.match_rules().add(rule); });
+    }
+    for (auto& user : users) {
+        user.join();
+    }
+    EXPECT_EQ(subscriber.match_rules().count(rule), USERS);
+    EXPECT_EQ(subscriber.match_rules().size(), 2u);
+
+    emit_properties_changed(emitter, "/dev", "org.bluez.Device1");
+    EXPECT_EQ(collect(emitter, subscriber), std::vector<std::string>{"/dev"});
+
+    for (size_t i = 0; i < USERS; i++) {
+        subscriber.match_rules().remove(rule);
+    }
+    EXPECT_EQ(subscriber.match_rules().count(rule), 0u);
+    emit_properties_changed(emitter, "/dev", "org.bluez.Device1");
+    EXPECT_TRUE(collect(emitter, subscriber).empty());
+
+    subscriber.uninit();
+    emitter.uninit();
+}
+
+TEST(MatchRules, PropertiesChangedRules) {
+    Connection emitter(DBUS_BUS_SESSION, true);
+    emitter.init();
+    Connection subscriber(DBUS_BUS_SESSION, true);
+    subscriber.init();
+
+    subscriber.match_rules().add(done_rule(emitter));
+    subscriber.match_rules().add(
+        MatchRules::properties_changed(emitter.unique_name(), "/hci0", true, "org.bluez.Device1"));
+
+    emit_properties_changed(emitter, "/hci0", "org.bluez.Adapter1");
+    emit_properties_changed(emitter, "/hci0/dev_1", "org.bluez.Device1");
+    emit_properties_changed(emitter, "/hci0/dev_1/service1/char1", "org.bluez.GattCharacteristic1");
+    emit_properties_changed(emitter, "/hci1/dev_2", "org.bluez.Device1");
+
+    EXPECT_EQ(collect(emitter, subscriber), std::vector<std::string>{"/hci0/dev_1"});
+
+    subscriber.uninit();
+    emitter.uninit();
+}
+
+// Reports how many signals reach a process subscribed to everything a busy sender emits, against one that only
+// follows a single device.
+TEST(MatchRules, NarrowRulesReceiveFewerMessages) {
+    static constexpr size_t DEVICES = 50;
+    static constexpr size_t ROUNDS = 20;
+
+    Connection emitter(DBUS_BUS_SESSION, true);
+    emitter.init();
+    Connection catch_all(DBUS_BUS_SESSION, true);
+    catch_all.init();
+    Connection narrow(DBUS_BUS_SESSION, true);
+    narrow.init();
+
+    catch_all.match_rules().add("type='signal',sender='" + emitter.unique_name() + "'");
+    narrow.match_rules().add(done_rule(emitter));
+    narrow.match_rules().add(MatchRules::properties_changed(emitter.unique_name(), "/hci0/dev_3", true));
+
+    for (size_t round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < DEVICES; i++) {
+            std::string device = "/hci0/dev_" + std::to_string(i);
+            emit_properties_changed(emitter, device, "org.bluez.Device1");
+            emit_properties_changed(emitter, device + "/service1/char1", "org.bluez.GattCharacteristic1");
+        }
+    }
+
+    // Both subscribers see the same Done signal.
+    emit_done(emitter);
+    size_t catch_all_count = receive(catch_all).size();
+    size_t narrow_count = receive(narrow).size();
+    EXPECT_EQ(catch_all_count, DEVICES * ROUNDS * 2);
+    EXPECT_EQ(narrow_count, ROUNDS * 2);
+
+    std::cout << "Catch-all subscription: " << catch_all_count << " messages, narrow subscription: " << narrow_count
+              << " messages" << std::endl;
+
+    narrow.uninit();
+    catch_all.uninit();
+    emitter.uninit();
+}
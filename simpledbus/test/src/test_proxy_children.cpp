@@ -107,3 +107,108 @@ TEST(ProxyChildren, RemoveChildWithInterfaces) {
     p.path_remove("/a", removed_interfaces);
     ASSERT_EQ(0, p.children().size());
 }
+
+TEST(ProxyChildren, RemoveChildCallback) {
+    Proxy p = Proxy(nullptr, "", "/");
+
+    std::vector<std::string> removed;
+    p.on_child_removed.load([&](std::string path) { removed.push_back(path); });
+
+    Holder managed_interfaces = Holder::create_dict();
+    managed_interfaces.dict_append(Holder::STRING, "i.1", Holder());
+    managed_interfaces.dict_append(Holder::STRING, "i.2", Holder());
+    p.path_add("/a", managed_interfaces);
+
+    Holder removed_interfaces = Holder::create_array();
+    removed_interfaces.array_append(Holder::create_string("i.2"));
+    p.path_remove("/a", removed_interfaces);
+    EXPECT_TRUE(removed.empty());
+
+    removed_interfaces = Holder::create_array();
+    removed_interfaces.array_append(Holder::create_string("i.1"));
+    p.path_remove("/a", removed_interfaces);
+    ASSERT_EQ(1, removed.size());
+    EXPECT_EQ("/a", removed.at(0));
+}
+
+TEST(ProxyChildren, DeferChild) {
+    Proxy p = Proxy(nullptr, "", "/a");
+    std::vector<std::string> created;
+    p.on_child_created.load([&](std::string path) { created.push_back(path); });
+
+    Holder managed_interfaces = Holder::create_dict();
+    managed_interfaces.dict_append(Holder::STRING, "i.1", Holder());
+    p.path_defer("/a/b", managed_interfaces);
+    p.path_defer("/a/b/c", managed_interfaces);
+    p.path_defer("/a/d", managed_interfaces);
+
+    EXPECT_EQ(2, p.path_deferred_count());
+    EXPECT_FALSE(p.path_prune());
+
+    // Accessing a deferred child creates it along with its descendants, and nothing else.
+    std::shared_ptr<Proxy> p_b = p.path_get("/a/b");
+    EXPECT_EQ(1, p.path_deferred_count());
+    EXPECT_TRUE(p_b->interfaces_loaded());
+    ASSERT_EQ(1, p_b->children().count("/a/b/c"));
+    EXPECT_TRUE(p_b->children().at("/a/b/c")->interfaces_loaded());
+
+    // Listing the children creates every remaining deferred child.
+    EXPECT_EQ(2, p.children().size());
+    EXPECT_EQ(0, p.path_deferred_count());
+    EXPECT_TRUE(created.empty());
+}
+
+TEST(ProxyChildren, DeferChildThenAdd) {
+    Proxy p = Proxy(nullptr, "", "/a");
+
+    Holder managed_interfaces = Holder::create_dict();
+    managed_interfaces.dict_append(Holder::STRING, "i.1", Holder());
+    p.path_defer("/a/b", managed_interfaces);
+
+    // Adding an object below a deferred child materializes the child first.
+    p.path_add("/a/b/c", managed_interfaces);
+    EXPECT_EQ(0, p.path_deferred_count());
+    std::shared_ptr<Proxy> p_b = p.path_get("/a/b");
+    EXPECT_TRUE(p_b->interfaces_loaded());
+    EXPECT_EQ(1, p_b->children().count("/a/b/c"));
+}
+
+TEST(ProxyChildren, SyncChildren) {
+    auto make_interfaces = [](std::vector<std::string> names) {
+        Holder managed_interfaces = Holder::create_dict();
+        for (auto& name : names) {
+            managed_interfaces.dict_append(Holder::STRING, name, Holder::create_dict());
+        }
+        return managed_interfaces;
+    };
+
+    Proxy p = Proxy(nullptr, "", "/a");
+    p.path_add("/a/b", make_interfaces({"i.1"}));
+    p.path_add("/a/c", make_interfaces({"i.1", "i.2"}));
+    p.path_add("/a/c/d", make_interfaces({"i.1"}));
+    p.path_defer("/a/f", make_interfaces({"i.1"}));
+    std::shared_ptr<Proxy> p_c = p.path_get("/a/c");
+
+    std::vector<std::string> removed;
+    p.on_child_removed.load([&](std::string path) { removed.push_back(path); });
+
+    std::map<std::string, Holder> managed_objects;
+    managed_objects["/a/c"] = make_interfaces({"i.1"});
+    managed_objects["/a/c/d"] = make_interfaces({"i.1"});
+    managed_objects["/a/e"] = make_interfaces({"i.1"});
+    managed_objects["/a/f"] = make_interfaces({"i.1", "i.3"});
+    p.path_sync(managed_objects, [](const std::string& path) { return true; });
+
+    // Objects that are gone are removed, the ones still there keep their proxy.
+    EXPECT_EQ(std::vector<std::string>{"/a/b"}, removed);
+    EXPECT_EQ(p_c, p.path_resolve("/a/c"));
+    EXPECT_TRUE(p_c->interfaces().at("i.1")->is_loaded());
+    EXPECT_FALSE(p_c->interfaces().at("i.2")->is_loaded());
+    EXPECT_NE(nullptr, p.path_resolve("/a/c/d"));
+
+    // New objects are deferred when requested, and deferred ones are updated in place.
+    EXPECT_EQ(nullptr, p.path_resolve("/a/e"));
+    EXPECT_EQ(2, p.path_deferred_count());
+    EXPECT_EQ(2, p.path_get("/a/f")->interfaces_count());
+    EXPECT_EQ(1, p.path_get("/a/e")->interfaces_count());
+}
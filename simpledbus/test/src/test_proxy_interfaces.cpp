@@ -72,3 +72,33 @@ TEST(ProxyInterfaces, ReloadInterfaces) {
 
     EXPECT_EQ(2, h.interfaces_count());
 }
+
+class CountingInterface : public Interface {
+  public:
+    CountingInterface() : Interface(nullptr, "", "/", "i.1") {}
+    void property_changed(std::string option_name) override { changed.push_back(option_name); }
+    std::vector<std::string> changed;
+};
+
+TEST(ProxyInterfaces, SyncInterface) {
+    Holder options = Holder::create_dict();
+    options.dict_append(Holder::STRING, "A", Holder::create_int32(1));
+    options.dict_append(Holder::STRING, "B", Holder::create_int32(2));
+    options.dict_append(Holder::STRING, "C", Holder::create_int32(3));
+
+    CountingInterface interface;
+    interface.load(options);
+    interface.changed.clear();
+
+    Holder synced_options = Holder::create_dict();
+    synced_options.dict_append(Holder::STRING, "A", Holder::create_int32(1));
+    synced_options.dict_append(Holder::STRING, "B", Holder::create_int32(20));
+
+    // Only the changed and the dropped properties are notified.
+    interface.sync(synced_options);
+    EXPECT_EQ((std::vector<std::string>{"B", "C"}), interface.changed);
+
+    interface.changed.clear();
+    interface.sync(synced_options);
+    EXPECT_TRUE(interface.changed.empty());
+}